@@ -0,0 +1,237 @@
+/**
+ ******************************************************************************
+ * @file    hal_host.c
+ * @author  Wiktor Chocianowicz
+ * @brief   Host (Linux) stand-in for the STM32 HAL - Source file
+ *
+ * @note    Drives simulated SPI devices and a virtual microsecond clock.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "main.h"
+
+static uint64_t host_time_us;
+
+/**
+ * @brief Map a single-bit GPIO pin mask to its index.
+ * @param pin GPIO_PIN_x mask.
+ * @return Pin index (0-15), or -1 if pin is not a single pin.
+ */
+static int HAL_Host_PinIndex(uint16_t pin) {
+    for (int i = 0; i < 16; ++i)
+        if (pin == (uint16_t)(1U << i))
+            return i;
+    return -1;
+}
+
+/**
+ * @brief Clock bytes through every selected device on the bus.
+ * @param hspi SPI handle.
+ * @param tx Bytes to send, NULL to send 0x00.
+ * @param rx Buffer for received bytes, may be NULL.
+ * @param size Number of bytes.
+ * @return HAL_OK on success.
+ */
+static HAL_StatusTypeDef HAL_Host_SPI_Exchange(SPI_HandleTypeDef *hspi, const uint8_t *tx,
+                                               uint8_t *rx, uint16_t size) {
+    if (hspi == NULL)
+        return HAL_ERROR;
+
+    hspi->transfers++;
+    hspi->bytes += size;
+
+    for (int d = 0; d < HOST_SPI_MAX_DEVICES; ++d)
+        if (hspi->devices[d] != NULL && hspi->devices[d]->selected)
+            hspi->devices[d]->transfers++;
+
+    for (uint16_t i = 0; i < size; ++i) {
+        uint8_t mosi = tx != NULL ? tx[i] : 0x00;
+        uint8_t miso = 0xFF;
+
+        for (int d = 0; d < HOST_SPI_MAX_DEVICES; ++d) {
+            HOST_SPI_DeviceTypeDef *dev = hspi->devices[d];
+            if (dev != NULL && dev->selected) {
+                dev->bytes++;
+                miso &= dev->exchange(dev->ctx, mosi);
+            }
+        }
+
+        if (rx != NULL)
+            rx[i] = miso;
+    }
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Set or clear a GPIO pin, forwarding CS edges to attached devices.
+ */
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState) {
+    if (GPIOx == NULL)
+        return;
+
+    if (PinState == GPIO_PIN_SET)
+        GPIOx->ODR |= GPIO_Pin;
+    else
+        GPIOx->ODR &= (uint16_t)~GPIO_Pin;
+
+    for (int i = 0; i < 16; ++i) {
+        HOST_SPI_DeviceTypeDef *dev = GPIOx->cs[i];
+        bool selected;
+
+        if (!(GPIO_Pin & (1U << i)) || dev == NULL)
+            continue;
+
+        selected = (PinState == GPIO_PIN_RESET);
+        if (selected != dev->selected) {
+            dev->selected = selected;
+            if (selected)
+                dev->cs_assertions++;
+            if (dev->select != NULL)
+                dev->select(dev->ctx, selected);
+        }
+    }
+}
+
+/**
+ * @brief Transmit bytes, discarding MISO.
+ */
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    return HAL_Host_SPI_Exchange(hspi, pData, NULL, Size);
+}
+
+/**
+ * @brief Full-duplex transfer.
+ */
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout) {
+    (void)Timeout;
+    return HAL_Host_SPI_Exchange(hspi, pTxData, pRxData, Size);
+}
+
+/**
+ * @brief Full-duplex "DMA" transfer.
+ * @details The transfer is performed immediately and HAL_SPI_TxRxCpltCallback
+ *          (or HAL_SPI_ErrorCallback) is invoked before returning.
+ */
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                              uint8_t *pRxData, uint16_t Size) {
+    HAL_StatusTypeDef status = HAL_Host_SPI_Exchange(hspi, pTxData, pRxData, Size);
+
+    if (status == HAL_OK)
+        HAL_SPI_TxRxCpltCallback(hspi);
+    else
+        HAL_SPI_ErrorCallback(hspi);
+
+    return HAL_OK;
+}
+
+__attribute__((weak)) void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
+    (void)hspi;
+}
+
+__attribute__((weak)) void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+    (void)hspi;
+}
+
+/**
+ * @brief PRIMASK emulation: records the mask so nesting mistakes show up.
+ */
+static uint32_t host_primask;
+
+uint32_t __get_PRIMASK(void) {
+    return host_primask;
+}
+
+void __set_PRIMASK(uint32_t priMask) {
+    host_primask = priMask & 1U;
+}
+
+void __disable_irq(void) {
+    host_primask = 1U;
+}
+
+void __enable_irq(void) {
+    host_primask = 0U;
+}
+
+/**
+ * @brief Milliseconds of virtual time.
+ */
+uint32_t HAL_GetTick(void) {
+    return (uint32_t)(host_time_us / 1000U);
+}
+
+/**
+ * @brief Advance virtual time.
+ */
+void HAL_Delay(uint32_t Delay) {
+    host_time_us += (uint64_t)Delay * 1000U;
+}
+
+/**
+ * @brief Attach a simulated device to a bus and wire its CS to a GPIO pin.
+ * @param hspi SPI handle the device sits on.
+ * @param cs_port GPIO port of the CS line.
+ * @param cs_pin Single GPIO_PIN_x mask of the CS line.
+ * @param device Device to attach.
+ * @return HAL_OK on success, HAL_ERROR if the bus is full or arguments are invalid.
+ */
+HAL_StatusTypeDef HAL_Host_AttachSPIDevice(SPI_HandleTypeDef *hspi,
+                                           GPIO_TypeDef *cs_port, uint16_t cs_pin,
+                                           HOST_SPI_DeviceTypeDef *device) {
+    int pin = HAL_Host_PinIndex(cs_pin);
+
+    if (hspi == NULL || cs_port == NULL || device == NULL || pin < 0)
+        return HAL_ERROR;
+
+    for (int d = 0; d < HOST_SPI_MAX_DEVICES; ++d) {
+        if (hspi->devices[d] == NULL) {
+            hspi->devices[d] = device;
+            cs_port->cs[pin] = device;
+            cs_port->ODR |= cs_pin; /* CS idles high (pulled up) */
+            device->selected = false;
+            return HAL_OK;
+        }
+    }
+
+    return HAL_ERROR;
+}
+
+/**
+ * @brief Microseconds of virtual time.
+ */
+uint64_t HAL_Host_GetMicros(void) {
+    return host_time_us;
+}
+
+/**
+ * @brief Advance virtual time by us microseconds.
+ */
+void HAL_Host_AdvanceMicros(uint64_t us) {
+    host_time_us += us;
+}
@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * @file    main.h
+ * @author  Wiktor Chocianowicz
+ * @brief   Host (Linux) stand-in for the STM32 main.h / HAL layer
+ *
+ * @note    Provides the HAL types and SPI/GPIO calls used by the driver and
+ *          routes them to simulated bus devices (see max30003_sim.h).
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef HOST_MAIN_H_
+#define HOST_MAIN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HAL_SPI_MODULE_ENABLED
+
+#define HOST_SPI_MAX_DEVICES    8   /**< Devices that can share one simulated SPI bus */
+
+/**
+ * @brief HAL status structures definition
+ */
+typedef enum {
+    HAL_OK       = 0x00U,
+    HAL_ERROR    = 0x01U,
+    HAL_BUSY     = 0x02U,
+    HAL_TIMEOUT  = 0x03U
+} HAL_StatusTypeDef;
+
+/**
+ * @brief GPIO Bit SET and Bit RESET enumeration
+ */
+typedef enum {
+    GPIO_PIN_RESET = 0U,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0      ((uint16_t)0x0001)
+#define GPIO_PIN_1      ((uint16_t)0x0002)
+#define GPIO_PIN_2      ((uint16_t)0x0004)
+#define GPIO_PIN_3      ((uint16_t)0x0008)
+#define GPIO_PIN_4      ((uint16_t)0x0010)
+#define GPIO_PIN_5      ((uint16_t)0x0020)
+#define GPIO_PIN_6      ((uint16_t)0x0040)
+#define GPIO_PIN_7      ((uint16_t)0x0080)
+#define GPIO_PIN_8      ((uint16_t)0x0100)
+#define GPIO_PIN_9      ((uint16_t)0x0200)
+#define GPIO_PIN_10     ((uint16_t)0x0400)
+#define GPIO_PIN_11     ((uint16_t)0x0800)
+#define GPIO_PIN_12     ((uint16_t)0x1000)
+#define GPIO_PIN_13     ((uint16_t)0x2000)
+#define GPIO_PIN_14     ((uint16_t)0x4000)
+#define GPIO_PIN_15     ((uint16_t)0x8000)
+
+/**
+ * @brief Simulated SPI slave attached to a host SPI bus
+ */
+typedef struct {
+    void (*select)(void *ctx, bool selected);   /**< CS edge, selected = CS low */
+    uint8_t (*exchange)(void *ctx, uint8_t mosi); /**< Clock one byte, returns MISO */
+    void *ctx;                                  /**< Device context */
+    bool selected;                              /**< Current CS state */
+    uint32_t cs_assertions;                     /**< CS falling edges seen */
+    uint32_t transfers;                         /**< Bus transfers made while selected */
+    uint32_t bytes;                             /**< Bytes clocked while selected */
+} HOST_SPI_DeviceTypeDef;
+
+/**
+ * @brief Simulated GPIO port
+ */
+typedef struct {
+    uint16_t ODR;                               /**< Output data register */
+    HOST_SPI_DeviceTypeDef *cs[16];             /**< Device whose CS is wired to each pin */
+} GPIO_TypeDef;
+
+/**
+ * @brief Simulated SPI handle
+ */
+typedef struct __SPI_HandleTypeDef {
+    HOST_SPI_DeviceTypeDef *devices[HOST_SPI_MAX_DEVICES]; /**< Devices on the bus */
+    uint32_t transfers;                         /**< HAL SPI calls made */
+    uint32_t bytes;                             /**< Bytes clocked on the bus */
+} SPI_HandleTypeDef;
+
+/* HAL API subset used by the driver */
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef *hspi, uint8_t *pData,
+                                   uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                          uint8_t *pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef *hspi, uint8_t *pTxData,
+                                              uint8_t *pRxData, uint16_t Size);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi);
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+
+/* CMSIS core intrinsics; the host has no interrupts, PRIMASK is only tracked */
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq(void);
+void __enable_irq(void);
+
+/* Host-only helpers */
+HAL_StatusTypeDef HAL_Host_AttachSPIDevice(SPI_HandleTypeDef *hspi,
+                                           GPIO_TypeDef *cs_port, uint16_t cs_pin,
+                                           HOST_SPI_DeviceTypeDef *device);
+uint64_t HAL_Host_GetMicros(void);
+void HAL_Host_AdvanceMicros(uint64_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_MAIN_H_ */
@@ -0,0 +1,1963 @@
+/**
+ ******************************************************************************
+ * @file    max30003_bench.c
+ * @author  Wiktor Chocianowicz
+ * @brief   SPI transaction and bus-time benchmark for the MAX30003 driver
+ *
+ * @note    Counts CS assertions and bytes clocked on the simulated bus and
+ *          models bus time at a configurable SCLK. Build: see README.md.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "max30003.h"
+#include "max30003_decode.h"
+#include "max30003_efit.h"
+#include "max30003_timestamp.h"
+#include "max30003_units.h"
+#include "max30003_pool.h"
+#include "max30003_pack.h"
+#include "max30003_rtor.h"
+#include "max30003_qrs.h"
+#include "max30003_hrv.h"
+#include "max30003_lomb.h"
+#include "max30003_filter.h"
+#include "max30003_resample.h"
+#include "max30003_codec.h"
+#include "max30003_example.h"
+#include "max30003_sim.h"
+#include "max30003_transport_sim.h"
+
+#define BENCH_CS_PIN            GPIO_PIN_4
+#define BENCH_DEFAULT_SCLK_HZ   4000000U    /**< Default SPI clock */
+#define BENCH_DEFAULT_CS_NS     500U        /**< Default per-transaction CS/setup overhead */
+#define BENCH_DEFAULT_SECONDS   10U         /**< Default streaming run length */
+#define BENCH_POLL_US           1000U       /**< INTB polling interval for streaming runs */
+#define BENCH_MAX_ROWS          16U
+#define BENCH_DECODE_CHANNELS   64U         /**< Channels drained per decode batch */
+#define BENCH_DECODE_ROUNDS     20000U      /**< Batches timed per decoder */
+#define BENCH_DRIVER_ROUNDS     20000U      /**< Calls timed per driver operation and transport */
+#define BENCH_DMA_WORDS         16U         /**< Words per asynchronous FIFO read */
+#define BENCH_DMA_BUSY_CALLS    5U          /**< Driver calls tried while the read is in flight */
+#define BENCH_DMA_FILL_US       50000U      /**< FIFO fill time before the read (25 samples at 512 sps) */
+#define BENCH_LATENCY_MIN_US    1000U       /**< Service latency at the bottom of the ramp */
+#define BENCH_LATENCY_MAX_US    40000U      /**< Service latency at the top of the ramp */
+#define BENCH_LATENCY_PERIOD_US 8000000U    /**< Full up-and-down latency ramp */
+#define BENCH_RING_SECONDS      12U         /**< Ring-full run length */
+#define BENCH_RING_PERIOD_US    3000000U    /**< Consumer stalls for the first 2/3 of each period */
+#define BENCH_RING_EOVF_US      4000000U    /**< IRQ ignored from here ... */
+#define BENCH_RING_EOVF_LEN_US  200000U     /**< ... for this long, to overflow the FIFO */
+#define BENCH_POOL_CONSUMERS    3U          /**< Filter, storage and radio */
+#define BENCH_STORAGE_BATCH     4U          /**< Blocks storage collects before a flash write */
+#define BENCH_RADIO_HOLD_US     20000U      /**< Time the radio keeps a block queued */
+#define BENCH_TS_POLL_US        100U        /**< INTB polling step for the timestamp run */
+#define BENCH_TS_SECONDS        120U        /**< Timestamp run length; error taken over the second half */
+#define BENCH_RR_SECONDS        120U        /**< R-to-R run length */
+#define BENCH_QRS_SECONDS       300U        /**< Synthetic ECG length per rate */
+#define BENCH_QRS_SKIP_S        5U          /**< Settling and learning excluded from scoring */
+#define BENCH_QRS_MATCH_MS      75U         /**< Detection tolerance around the true R peak */
+#define BENCH_QRS_MAX_BEATS     1024U
+#define BENCH_QRS_BIAS_MS       5U          /**< Largest mean R position error accepted */
+#define BENCH_QRS_OPS_PER_SAMPLE 75U        /**< Hand count per sample: filters 47, history moves 14, decisions 14 */
+#define BENCH_QRS_CYCLES_PER_OP 2U          /**< Cortex-M4, loads and branches included */
+#define BENCH_HRV_BEATS         20000U      /**< RR intervals fed to the HRV engine */
+#define BENCH_LOMB_BEATS        4000U       /**< RR intervals fed to the streaming spectrum */
+#define BENCH_FILTER_SECONDS    60U         /**< Tone run length; gain taken over the last third */
+#define BENCH_FILTER_ROUNDS     2000U       /**< Blocks timed per filter path */
+#define BENCH_RESAMPLE_SECONDS  20U         /**< Tone run length per rate pair; first second excluded */
+#define BENCH_CODEC_SECONDS     60U         /**< Synthetic ECG length per codec run */
+#define BENCH_CODEC_KEY         16U         /**< Blocks between key blocks */
+#define BENCH_PI                3.14159265358979323846
+#define BENCH_UV_CODE           (131072.0 * 80.0 / 1e6)   /**< Codes per uV at GAIN 80, VREF 1 V */
+#define BENCH_RR_STALL_US       60000000U   /**< Time at which the handler stops being serviced */
+#define BENCH_RR_STALL_LEN_US   1500000U    /**< Length of the stall: misses a beat and overflows the FIFO */
+
+/*
+ * CPU cost model, Cortex-M0+ at 16 MHz with flash wait states. These are
+ * rough per-call figures, not measurements; override with --hal-cycles and
+ * --direct-cycles once the target has been timed with DWT/SysTick.
+ */
+#define BENCH_DEFAULT_CPU_HZ        16000000U
+#define BENCH_HAL_CALL_CYCLES       180U    /**< HAL_SPI_Transmit(Receive) entry: lock, state, checks */
+#define BENCH_HAL_BYTE_CYCLES       48U     /**< HAL polled loop per byte */
+#define BENCH_HAL_GPIO_CYCLES       24U     /**< HAL_GPIO_WritePin() call */
+#define BENCH_DIRECT_CALL_CYCLES    20U     /**< Transport call plus RXNE drain */
+#define BENCH_DIRECT_BYTE_CYCLES    14U     /**< SR poll, DR store, SR poll, DR load */
+#define BENCH_DIRECT_GPIO_CYCLES    4U      /**< One BSRR store */
+
+/**
+ * @brief Bus activity counters
+ */
+typedef struct {
+    uint32_t cs;            /**< CS assertions */
+    uint32_t bytes;         /**< Bytes clocked */
+    uint32_t transfers;     /**< HAL SPI calls */
+} Bench_CountersTypeDef;
+
+/**
+ * @brief Per-call CPU cycle costs of one transport backend
+ */
+typedef struct {
+    uint32_t call;          /**< Fixed cost per SPI transfer */
+    uint32_t byte;          /**< Software cost per byte, before waiting on the shifter */
+    uint32_t gpio;          /**< Cost per CS edge */
+} Bench_CycleModelTypeDef;
+
+/**
+ * @brief One per-operation result
+ */
+typedef struct {
+    char name[32];
+    Bench_CountersTypeDef c;
+} Bench_RowTypeDef;
+
+/**
+ * @brief Benchmark context
+ */
+typedef struct {
+    SPI_HandleTypeDef hspi;
+    GPIO_TypeDef cs_port;
+    MAX30003_SimTypeDef sim;
+    MAX30003_HandleTypeDef hmax;
+    uint32_t sclk_hz;
+    uint32_t cs_ns;
+    uint32_t seconds;
+    uint32_t cpu_hz;
+    Bench_CycleModelTypeDef hal;
+    Bench_CycleModelTypeDef direct;
+    Bench_RowTypeDef rows[BENCH_MAX_ROWS];
+    uint32_t row_count;
+} Bench_TypeDef;
+
+static Bench_CountersTypeDef Bench_Snapshot(const Bench_TypeDef *b) {
+    Bench_CountersTypeDef c = { b->sim.dev.cs_assertions, b->sim.dev.bytes, b->sim.dev.transfers };
+    return c;
+}
+
+static Bench_CountersTypeDef Bench_Delta(Bench_CountersTypeDef end, Bench_CountersTypeDef start) {
+    Bench_CountersTypeDef d = { end.cs - start.cs, end.bytes - start.bytes, end.transfers - start.transfers };
+    return d;
+}
+
+/**
+ * @brief Modelled bus time in nanoseconds.
+ */
+static uint64_t Bench_BusTime_ns(const Bench_TypeDef *b, Bench_CountersTypeDef c) {
+    return (uint64_t)c.bytes * 8U * 1000000000ULL / b->sclk_hz + (uint64_t)c.cs * b->cs_ns;
+}
+
+/**
+ * @brief Modelled CPU cycles spent in the transport.
+ *
+ * Transfers are polled, so each byte costs at least one frame on the wire
+ * even when the software loop is faster.
+ */
+static uint64_t Bench_Cycles(const Bench_TypeDef *b, const Bench_CycleModelTypeDef *m,
+                             Bench_CountersTypeDef c) {
+    uint32_t frame = (uint32_t)(8ULL * b->cpu_hz / b->sclk_hz);
+    uint32_t byte = m->byte > frame ? m->byte : frame;
+
+    return (uint64_t)c.transfers * m->call + (uint64_t)c.bytes * byte + 2ULL * c.cs * m->gpio;
+}
+
+static void Bench_PrintRow(Bench_TypeDef *b, const char *name, Bench_CountersTypeDef c) {
+    uint64_t ns = Bench_BusTime_ns(b, c);
+
+    printf("  %-28s %6u %8u %10u %10.2f\n", name, (unsigned)c.cs, (unsigned)c.transfers,
+           (unsigned)c.bytes, ns / 1000.0);
+
+    if (b->row_count < BENCH_MAX_ROWS) {
+        Bench_RowTypeDef *row = &b->rows[b->row_count++];
+        snprintf(row->name, sizeof(row->name), "%s", name);
+        row->c = c;
+    }
+}
+
+/**
+ * @brief HAL vs direct-register transport, modelled from the recorded rows.
+ */
+static void Bench_PrintCycles(const Bench_TypeDef *b) {
+    printf("Modelled CPU cycles, HAL vs direct-register transport (%u Hz core)\n", (unsigned)b->cpu_hz);
+    printf("  HAL    call %u, byte %u, CS edge %u\n",
+           (unsigned)b->hal.call, (unsigned)b->hal.byte, (unsigned)b->hal.gpio);
+    printf("  direct call %u, byte %u, CS edge %u\n",
+           (unsigned)b->direct.call, (unsigned)b->direct.byte, (unsigned)b->direct.gpio);
+    printf("  %-28s %10s %10s %10s %10s %8s\n", "operation", "HAL cyc", "HAL us", "direct cyc", "direct us", "speedup");
+
+    for (uint32_t i = 0; i < b->row_count; ++i) {
+        uint64_t hal = Bench_Cycles(b, &b->hal, b->rows[i].c);
+        uint64_t direct = Bench_Cycles(b, &b->direct, b->rows[i].c);
+
+        printf("  %-28s %10llu %10.2f %10llu %10.2f %7.2fx\n", b->rows[i].name,
+               (unsigned long long)hal, hal * 1e6 / b->cpu_hz,
+               (unsigned long long)direct, direct * 1e6 / b->cpu_hz,
+               direct ? (double)hal / direct : 0.0);
+    }
+
+    printf("\n");
+}
+
+static int Bench_Setup(Bench_TypeDef *b) {
+    memset(&b->hspi, 0, sizeof(b->hspi));
+    memset(&b->cs_port, 0, sizeof(b->cs_port));
+    MAX30003_Sim_Init(&b->sim);
+    if (MAX30003_Sim_Attach(&b->sim, &b->hspi, &b->cs_port, BENCH_CS_PIN) != HAL_OK)
+        return -1;
+    if (MAX30003_Init(&b->hmax, &b->hspi, &b->cs_port, BENCH_CS_PIN) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SW_RST, MAX30003_SW_RST_D) != HAL_OK)
+        return -1;
+    return 0;
+}
+
+/**
+ * @brief Per-operation cost of each driver entry point.
+ */
+static int Bench_Operations(Bench_TypeDef *b) {
+    static const uint8_t fifo_counts[] = { 1, 8, 32 };
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    MAX30003_ConfigTypeDef cfg;
+    Bench_CountersTypeDef start;
+    uint32_t value;
+    uint8_t drained;
+    char name[32];
+    int untouched;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+
+    b->row_count = 0;
+    printf("Per operation (SCLK %u Hz, CS overhead %u ns)\n", (unsigned)b->sclk_hz, (unsigned)b->cs_ns);
+    printf("  %-28s %6s %8s %10s %10s\n", "operation", "CS", "HAL", "bytes", "bus us");
+
+    start = Bench_Snapshot(b);
+    MAX30003_ReadReg(&b->hmax, MAX30003_REG_INFO, &value);
+    Bench_PrintRow(b, "MAX30003_ReadReg", Bench_Delta(Bench_Snapshot(b), start));
+
+    start = Bench_Snapshot(b);
+    MAX30003_ReadRTOR(&b->hmax, NULL, &value);
+    Bench_PrintRow(b, "MAX30003_ReadRTOR", Bench_Delta(Bench_Snapshot(b), start));
+
+    start = Bench_Snapshot(b);
+    MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_CAL, MAX30003_CNFG_CAL_DEFAULT_CONFIG);
+    Bench_PrintRow(b, "MAX30003_WriteReg", Bench_Delta(Bench_Snapshot(b), start));
+
+    start = Bench_Snapshot(b);
+    MAX30003_WriteField(&b->hmax, MAX30003_REG_CNFG_ECG, MAX30003_CNFG_ECG_GAIN_SHIFT,
+                        MAX30003_CNFG_ECG_GAIN_MASK, 0x3);
+    Bench_PrintRow(b, "MAX30003_WriteField", Bench_Delta(Bench_Snapshot(b), start));
+
+    for (size_t i = 0; i < sizeof(fifo_counts); ++i) {
+        start = Bench_Snapshot(b);
+        MAX30003_ReadFIFO(&b->hmax, fifo, fifo_counts[i]);
+        snprintf(name, sizeof(name), "MAX30003_ReadFIFO(%u)", (unsigned)fifo_counts[i]);
+        Bench_PrintRow(b, name, Bench_Delta(Bench_Snapshot(b), start));
+    }
+
+    /* The 16-word burst reads EMPTY words, none of which may land in fifo[] */
+    memset(fifo, 0xA5, sizeof(fifo));
+    start = Bench_Snapshot(b);
+    MAX30003_DrainFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH, &drained);
+    Bench_PrintRow(b, "MAX30003_DrainFIFO(empty,16)", Bench_Delta(Bench_Snapshot(b), start));
+    untouched = drained == 0;
+    for (size_t i = 0; i < MAX30003_FIFO_LENGTH; ++i)
+        untouched &= fifo[i] == 0xA5A5A5A5U;
+
+    start = Bench_Snapshot(b);
+    MAX30003_PollFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH, &drained);
+    Bench_PrintRow(b, "MAX30003_PollFIFO(empty)", Bench_Delta(Bench_Snapshot(b), start));
+
+    start = Bench_Snapshot(b);
+    MAX30003_GetInterruptStatus(&b->hmax, &value);
+    Bench_PrintRow(b, "MAX30003_GetInterruptStatus", Bench_Delta(Bench_Snapshot(b), start));
+
+    start = Bench_Snapshot(b);
+    MAX30003_ConfigureRegisters(&b->hmax);
+    Bench_PrintRow(b, "MAX30003_ConfigureRegisters", Bench_Delta(Bench_Snapshot(b), start));
+
+    MAX30003_GetExampleConfig(&cfg);
+    cfg.cnfg_ecg = (cfg.cnfg_ecg & ~(MAX30003_CNFG_ECG_RATE_MASK << MAX30003_CNFG_ECG_RATE_SHIFT))
+        | MAX30003_CNFG_ECG_RATE_128;
+    start = Bench_Snapshot(b);
+    MAX30003_CommitConfig(&b->hmax, &cfg, NULL);
+    Bench_PrintRow(b, "MAX30003_CommitConfig(rate)", Bench_Delta(Bench_Snapshot(b), start));
+
+    printf("\n");
+    if (!untouched) {
+        printf("MAX30003_DrainFIFO stored EMPTY words\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sample source whose value identifies the sample index.
+ */
+static int32_t Bench_IndexSignal(void *ctx, uint64_t index, uint32_t rate_mhz) {
+    (void)ctx;
+    (void)rate_mhz;
+    return (int32_t)(index % 100000U) - 50000;
+}
+
+#if MAX30003_ENABLE_DMA
+/**
+ * @brief What HAL_SPI_TxRxCpltCallback() saw during Bench_DMA()
+ */
+typedef struct {
+    Bench_TypeDef *b;                       /**< Context under test, NULL outside Bench_DMA() */
+    uint32_t completions;                   /**< HAL completions forwarded to the driver */
+    uint32_t busy;                          /**< Driver calls that returned HAL_BUSY in flight */
+    uint32_t bytes;                         /**< Bytes clocked by those calls (must be 0) */
+    bool selected;                          /**< CS still low when the transfer completed */
+    uint32_t callbacks;                     /**< Driver completion callbacks */
+    HAL_StatusTypeDef status;               /**< Status passed to the completion callback */
+    uint8_t count;                          /**< Words passed to the completion callback */
+    uint32_t words[MAX30003_FIFO_LENGTH];   /**< Copy of the words passed */
+} Bench_DMAStateTypeDef;
+
+static Bench_DMAStateTypeDef bench_dma;
+
+static void Bench_DMACplt(MAX30003_HandleTypeDef *hmax, HAL_StatusTypeDef status,
+                          const uint32_t *fifo_data, uint8_t count) {
+    (void)hmax;
+    bench_dma.callbacks++;
+    bench_dma.status = status;
+    bench_dma.count = count;
+    if (fifo_data != NULL)
+        memcpy(bench_dma.words, fifo_data, count * sizeof(fifo_data[0]));
+}
+
+/**
+ * @brief HAL SPI DMA completion, forwarded to the driver as the README shows.
+ * @details Until it is forwarded the read is still in flight for the driver,
+ *          so CS must be low and every other driver call must return HAL_BUSY
+ *          without touching the bus.
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef *hspi) {
+    Bench_TypeDef *b = bench_dma.b;
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    uint32_t value, bytes;
+    uint8_t drained;
+
+    if (b == NULL)
+        return;
+
+    bench_dma.completions++;
+    bench_dma.selected = b->sim.dev.selected;
+    bytes = b->sim.dev.bytes;
+    bench_dma.busy += MAX30003_ReadReg(&b->hmax, MAX30003_REG_STATUS, &value) == HAL_BUSY;
+    bench_dma.busy += MAX30003_WriteReg(&b->hmax, MAX30003_REG_FIFO_RST, MAX30003_FIFO_RST_D) == HAL_BUSY;
+    bench_dma.busy += MAX30003_ReadFIFO(&b->hmax, fifo, 1) == HAL_BUSY;
+    bench_dma.busy += MAX30003_DrainFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH, &drained) == HAL_BUSY;
+    bench_dma.busy += MAX30003_ReadFIFO_DMA(&b->hmax, 1, Bench_DMACplt) == HAL_BUSY;
+    bench_dma.bytes += b->sim.dev.bytes - bytes;
+
+    MAX30003_SPI_TxRxCpltCallback(&b->hmax, hspi);
+}
+
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef *hspi) {
+    if (bench_dma.b != NULL)
+        MAX30003_SPI_ErrorCallback(&bench_dma.b->hmax, hspi);
+}
+
+/**
+ * @brief Reset the device and let the FIFO fill with a known signal.
+ */
+static int Bench_DMAPrepare(Bench_TypeDef *b) {
+    if (Bench_Setup(b) != 0)
+        return -1;
+    MAX30003_Sim_SetSignal(&b->sim, Bench_IndexSignal, NULL);
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK ||
+        MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_ECG, MAX30003_CNFG_ECG_RATE_512
+            | MAX30003_CNFG_ECG_GAIN_80) != HAL_OK ||
+        MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+    HAL_Host_AdvanceMicros(BENCH_DMA_FILL_US);
+    return MAX30003_Sim_FIFOCount(&b->sim) >= BENCH_DMA_WORDS ? 0 : -1;
+}
+
+/**
+ * @brief MAX30003_ReadFIFO_DMA() through the HAL completion callback.
+ * @details The same FIFO contents are read once with MAX30003_ReadFIFO() and
+ *          once asynchronously; the completion callback must deliver the same
+ *          words, the driver must refuse other calls while the read is in
+ *          flight, and CS must be released once it completes.
+ */
+static int Bench_DMA(Bench_TypeDef *b) {
+    uint32_t blocking[BENCH_DMA_WORDS];
+    Bench_CountersTypeDef start, d;
+    HAL_StatusTypeDef status;
+    uint32_t value;
+    int match, released, idle;
+
+    if (Bench_DMAPrepare(b) != 0 || MAX30003_ReadFIFO(&b->hmax, blocking, BENCH_DMA_WORDS) != HAL_OK)
+        return -1;
+
+    if (Bench_DMAPrepare(b) != 0)
+        return -1;
+    memset(&bench_dma, 0, sizeof(bench_dma));
+    bench_dma.b = b;
+    start = Bench_Snapshot(b);
+    status = MAX30003_ReadFIFO_DMA(&b->hmax, BENCH_DMA_WORDS, Bench_DMACplt);
+    d = Bench_Delta(Bench_Snapshot(b), start);
+    bench_dma.b = NULL;
+
+    match = bench_dma.callbacks == 1U && bench_dma.status == HAL_OK && bench_dma.count == BENCH_DMA_WORDS &&
+            memcmp(bench_dma.words, blocking, sizeof(blocking)) == 0;
+    released = !b->sim.dev.selected;
+    idle = !b->hmax.dma_busy && MAX30003_ReadReg(&b->hmax, MAX30003_REG_STATUS, &value) == HAL_OK;
+
+    printf("Asynchronous FIFO read, %u words at 512 sps, completion forwarded from HAL_SPI_TxRxCpltCallback\n",
+           (unsigned)BENCH_DMA_WORDS);
+    printf("  words match ReadFIFO      %s\n", match ? "yes" : "NO");
+    printf("  HAL_BUSY while in flight  %u of %u calls, %u bytes clocked\n", (unsigned)bench_dma.busy,
+           (unsigned)BENCH_DMA_BUSY_CALLS, (unsigned)bench_dma.bytes);
+    printf("  CS low at completion      %s, released after %s\n", bench_dma.selected ? "yes" : "NO",
+           released ? "yes" : "NO");
+    printf("  bus                       %u CS, %u bytes, driver %s afterwards\n\n", (unsigned)d.cs,
+           (unsigned)d.bytes, idle ? "idle" : "STILL BUSY");
+
+    return status == HAL_OK && bench_dma.completions == 1U && match && bench_dma.busy == BENCH_DMA_BUSY_CALLS &&
+           bench_dma.bytes == 0U && bench_dma.selected && released && idle && d.cs == 1U ? 0 : -1;
+}
+#endif /* MAX30003_ENABLE_DMA */
+
+/**
+ * @brief IRQ path variant of MAX30003_IRQHandler() that always reads a full
+ *        FIFO, as the example did before MAX30003_DrainFIFO().
+ */
+static void Bench_FixedIRQHandler(MAX30003_HandleTypeDef *hmax) {
+    uint32_t enabled_active = 0;
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+
+    MAX30003_GetInterruptStatus(hmax, &enabled_active);
+    if (enabled_active & MAX30003_INT_EINT) {
+        if (MAX30003_ReadFIFO(hmax, fifo, MAX30003_FIFO_LENGTH) == HAL_OK)
+            MAX30003_Ring_PushFIFO(&MAX30003_SampleRing, fifo, MAX30003_FIFO_LENGTH);
+    }
+    if (enabled_active & MAX30003_INT_EOVF)
+        MAX30003_WriteReg(hmax, MAX30003_REG_FIFO_RST, MAX30003_FIFO_RST_D);
+}
+
+/**
+ * @brief Streaming cost of the example IRQ path at one ECG rate.
+ * @param b Benchmark context.
+ * @param rate_bits MAX30003_CNFG_ECG_RATE_x value.
+ * @param rate_sps Nominal rate, for the report.
+ * @param efit FIFO interrupt threshold in words (1-32).
+ * @param fixed Non-zero to read a full FIFO per interrupt instead of draining.
+ */
+static int Bench_Streaming(Bench_TypeDef *b, uint32_t rate_bits, unsigned rate_sps,
+                           uint8_t efit, int fixed) {
+    MAX30003_SampleTypeDef drain[MAX30003_FIFO_LENGTH];
+    Bench_CountersTypeDef start, d;
+    uint32_t interrupts = 0;
+    uint64_t valid = 0;
+    uint32_t n;
+    uint64_t ns;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    MAX30003_Ring_Init(&MAX30003_SampleRing);
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, efit - 1U) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_ECG, rate_bits
+            | MAX30003_CNFG_ECG_GAIN_80
+            | MAX30003_CNFG_ECG_DHPF_EN
+            | MAX30003_CNFG_ECG_DLPF_40) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+
+    start = Bench_Snapshot(b);
+
+    for (uint64_t t = 0; t < (uint64_t)b->seconds * 1000000U; t += BENCH_POLL_US) {
+        HAL_Host_AdvanceMicros(BENCH_POLL_US);
+        if (MAX30003_Sim_INTB(&b->sim)) {
+            interrupts++;
+            if (fixed)
+                Bench_FixedIRQHandler(&b->hmax);
+            else
+                MAX30003_IRQHandler(&b->hmax);
+        }
+        while ((n = MAX30003_Ring_Pop(&MAX30003_SampleRing, drain, MAX30003_FIFO_LENGTH)) > 0)
+            for (uint32_t i = 0; i < n; ++i)
+                if (drain[i].etag == MAX30003_FIFO_ETAG_VALID || drain[i].etag == MAX30003_FIFO_ETAG_VALID_EOF)
+                    valid++;
+    }
+
+    d = Bench_Delta(Bench_Snapshot(b), start);
+    ns = Bench_BusTime_ns(b, d);
+
+    printf("  %4u sps %5u %6s %8.1f %8.1f %8.1f %10.1f %7.1f%% %10.1f %7.3f%% %7.3f%% %7.3f%% %8llu\n",
+           rate_sps, (unsigned)efit, fixed ? "fixed" : "drain",
+           (double)interrupts / b->seconds,
+           (double)d.cs / b->seconds,
+           (double)d.transfers / b->seconds,
+           (double)d.bytes / b->seconds,
+           d.bytes ? valid * MAX30003_FIFO_WORD_SIZE * 100.0 / d.bytes : 0.0,
+           ns / 1000.0 / b->seconds,
+           ns / 1e7 / b->seconds,
+           Bench_Cycles(b, &b->hal, d) * 100.0 / b->cpu_hz / b->seconds,
+           Bench_Cycles(b, &b->direct, d) * 100.0 / b->cpu_hz / b->seconds,
+           (unsigned long long)b->sim.samples_dropped);
+    return 0;
+}
+
+/**
+ * @brief Ring overruns and FIFO overflows seen by a consumer that counts
+ *        samples.
+ * @details The consumer stalls long enough for the ring to fill, and the
+ *          IRQ is ignored once for long enough to overflow the FIFO while
+ *          the ring is full. The consumer advances its index by one per
+ *          sample and by the count of each gap record. Each sample's value
+ *          gives its true index, so the offset between the two shows any
+ *          drift. Ring overruns must be counted exactly. A FIFO overflow's
+ *          size is estimated from the tick clock, which may be off by one
+ *          sample per overflow.
+ */
+static int Bench_RingFull(Bench_TypeDef *b) {
+    MAX30003_SampleTypeDef drain[MAX30003_FIFO_LENGTH];
+    uint64_t index = 0;
+    uint32_t gaps = 0, n;
+    int64_t max_offset = 0;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    MAX30003_Sim_SetSignal(&b->sim, Bench_IndexSignal, NULL);
+    MAX30003_Ring_Init(&MAX30003_SampleRing);
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK ||
+        MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, 8U - 1U) != HAL_OK ||
+        MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_ECG, MAX30003_CNFG_ECG_RATE_512
+            | MAX30003_CNFG_ECG_GAIN_80) != HAL_OK ||
+        MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+
+    for (uint64_t t = 0; t < BENCH_RING_SECONDS * 1000000ULL; t += BENCH_POLL_US) {
+        HAL_Host_AdvanceMicros(BENCH_POLL_US);
+        if (MAX30003_Sim_INTB(&b->sim) && (t < BENCH_RING_EOVF_US || t >= BENCH_RING_EOVF_US + BENCH_RING_EOVF_LEN_US))
+            MAX30003_IRQHandler(&b->hmax);
+        if (t % BENCH_RING_PERIOD_US < BENCH_RING_PERIOD_US * 2U / 3U)
+            continue;
+        while ((n = MAX30003_Ring_Pop(&MAX30003_SampleRing, drain, MAX30003_FIFO_LENGTH)) > 0) {
+            for (uint32_t i = 0; i < n; ++i) {
+                if (drain[i].etag == MAX30003_FIFO_ETAG_OVERFLOW) {
+                    index += (uint32_t)drain[i].ecg;
+                    gaps++;
+                } else {
+                    int64_t offset = (int64_t)(drain[i].ecg + 50000) - (int64_t)index;
+
+                    if (llabs(offset) > llabs(max_offset))
+                        max_offset = offset;
+                    index++;
+                }
+            }
+        }
+    }
+
+    printf("Ring full at 512 sps, EFIT 8, %u-sample ring (%u s, consumer stalled %u of every %u ms, IRQ off %u ms)\n",
+           (unsigned)MAX30003_RING_SIZE, (unsigned)BENCH_RING_SECONDS,
+           (unsigned)(BENCH_RING_PERIOD_US * 2U / 3U / 1000U), (unsigned)(BENCH_RING_PERIOD_US / 1000U),
+           (unsigned)(BENCH_RING_EOVF_LEN_US / 1000U));
+    printf("  ring overruns       %8u samples\n", (unsigned)MAX30003_Ring_Overruns(&MAX30003_SampleRing));
+    printf("  FIFO overflow loss  %8llu samples\n", (unsigned long long)b->sim.samples_dropped);
+    printf("  gap records         %8u\n", (unsigned)gaps);
+    printf("  consumer index      %8llu (driver %llu, device %llu)\n", (unsigned long long)index,
+           (unsigned long long)b->hmax.sample_index,
+           (unsigned long long)(b->sim.sample_index - MAX30003_Sim_FIFOCount(&b->sim)));
+    printf("  max index offset    %8lld samples (%u FIFO overflows)\n\n", (long long)max_offset,
+           (unsigned)b->hmax.overflows);
+
+    return MAX30003_SampleRing.pending == 0 && MAX30003_Ring_Overruns(&MAX30003_SampleRing) > 0 &&
+           b->sim.samples_dropped > 0 && index == b->hmax.sample_index &&
+           llabs(max_offset) <= (long long)b->hmax.overflows ? 0 : -1;
+}
+
+/**
+ * @brief Main loop service latency at time t: a triangle between
+ *        BENCH_LATENCY_MIN_US and BENCH_LATENCY_MAX_US.
+ */
+static uint32_t Bench_Latency_us(uint64_t t) {
+    uint64_t phase = t % BENCH_LATENCY_PERIOD_US;
+    uint64_t half = BENCH_LATENCY_PERIOD_US / 2U;
+    uint64_t span = BENCH_LATENCY_MAX_US - BENCH_LATENCY_MIN_US;
+
+    if (phase >= half)
+        phase = BENCH_LATENCY_PERIOD_US - phase;
+    return BENCH_LATENCY_MIN_US + (uint32_t)(span * phase / half);
+}
+
+/**
+ * @brief Fixed vs adaptive EFIT under a ramping service latency.
+ * @param b Benchmark context.
+ * @param rate_bits MAX30003_CNFG_ECG_RATE_x value.
+ * @param rate_sps Nominal rate, for the report.
+ * @param efit Initial (and, if not adaptive, fixed) threshold.
+ * @param adaptive Non-zero to run the EFIT controller.
+ */
+static int Bench_Adaptive(Bench_TypeDef *b, uint32_t rate_bits, unsigned rate_sps,
+                          uint8_t efit, int adaptive) {
+    MAX30003_EFIT_ControllerTypeDef ctl;
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    uint32_t interrupts = 0, overflows = 0, efit_min = efit, efit_max = efit;
+    uint64_t pending_since = 0, lost;
+    uint8_t queued;
+    int pending = 0;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, efit - 1U) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_ECG, rate_bits
+            | MAX30003_CNFG_ECG_GAIN_80
+            | MAX30003_CNFG_ECG_DHPF_EN
+            | MAX30003_CNFG_ECG_DLPF_40) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+    if (MAX30003_EFIT_Init(&ctl, &b->hmax, rate_sps * 1000U) != HAL_OK)
+        return -1;
+
+    for (uint64_t t = 0; t < (uint64_t)b->seconds * 1000000U; t += BENCH_POLL_US) {
+        uint32_t enabled_active = 0;
+        uint8_t count = 0;
+
+        HAL_Host_AdvanceMicros(BENCH_POLL_US);
+        if (!pending && MAX30003_Sim_INTB(&b->sim)) {
+            pending = 1;
+            pending_since = t;
+        }
+        if (!pending || t - pending_since < Bench_Latency_us(t))
+            continue;
+
+        pending = 0;
+        interrupts++;
+        MAX30003_GetInterruptStatus(&b->hmax, &enabled_active);
+        if (enabled_active & MAX30003_INT_EINT)
+            MAX30003_DrainFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH, &count);
+        if (enabled_active & MAX30003_INT_EOVF) {
+            overflows++;
+            MAX30003_RecoverOverflow(&b->hmax, NULL);
+        }
+        if (adaptive) {
+            MAX30003_EFIT_Update(&ctl, &b->hmax, count, (uint32_t)(t - pending_since),
+                                 (enabled_active & MAX30003_INT_EOVF) != 0);
+            if (ctl.efit < efit_min)
+                efit_min = ctl.efit;
+            if (ctl.efit > efit_max)
+                efit_max = ctl.efit;
+        }
+    }
+
+    /* Lost = generated - read - still queued; est = driver gap accounting */
+    queued = MAX30003_Sim_FIFOCount(&b->sim);
+    lost = b->sim.sample_index - (b->hmax.sample_index - b->hmax.samples_dropped) - queued;
+
+    printf("  %4u sps %9s %3u %8.1f %8u %5u-%-3u %8u %8llu %8llu\n", rate_sps, adaptive ? "adaptive" : "fixed",
+           (unsigned)efit, (double)interrupts / b->seconds,
+           (unsigned)(ctl.raises + ctl.lowers), (unsigned)efit_min, (unsigned)efit_max,
+           (unsigned)overflows, (unsigned long long)lost, (unsigned long long)b->hmax.samples_dropped);
+    return 0;
+}
+
+/**
+ * @brief Timestamp accuracy against the simulator's true sample times.
+ * @param b Benchmark context.
+ * @param ppm Simulated MAX30003 clock error.
+ */
+static int Bench_Timestamps(Bench_TypeDef *b, int32_t ppm) {
+    const uint32_t efit = 8;
+    MAX30003_TS_TypeDef ts;
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    uint64_t stamps[MAX30003_FIFO_LENGTH];
+    uint64_t first_anchor_index = 0, first_anchor_us = 0;
+    double true_period, nominal_period, sum_sq = 0, nominal_max = 0, max_err = 0;
+    uint64_t n = 0;
+    int anchored = 0;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, efit - 1U) != HAL_OK)
+        return -1;
+    MAX30003_Sim_SetClockError(&b->sim, ppm);
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+    if (MAX30003_TS_Init(&ts, &b->hmax) != HAL_OK)
+        return -1;
+    ts.latency_us = BENCH_TS_POLL_US / 2U;
+
+    nominal_period = 1e9 / ts.rate_mHz;
+    true_period = nominal_period / (1.0 + ppm / 1e6);
+
+    for (uint64_t t = 0; t < BENCH_TS_SECONDS * 1000000ULL; t += BENCH_TS_POLL_US) {
+        uint32_t enabled_active = 0;
+        uint64_t first, irq_us;
+        uint8_t count = 0;
+
+        HAL_Host_AdvanceMicros(BENCH_TS_POLL_US);
+        if (!MAX30003_Sim_INTB(&b->sim))
+            continue;
+
+        irq_us = HAL_Host_GetMicros();
+        MAX30003_GetInterruptStatus(&b->hmax, &enabled_active);
+        if (!(enabled_active & MAX30003_INT_EINT))
+            continue;
+
+        first = b->hmax.sample_index;
+        if (MAX30003_DrainFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH, &count) != HAL_OK || count == 0)
+            return -1;
+
+        MAX30003_TS_Anchor(&ts, first + efit - 1U, irq_us);
+        if (!anchored) {
+            first_anchor_index = first + efit - 1U;
+            first_anchor_us = irq_us - ts.latency_us;
+            anchored = 1;
+        }
+
+        MAX30003_TS_Stamp(&ts, first, stamps, count);
+        if (t < BENCH_TS_SECONDS * 1000000ULL / 2U)
+            continue;
+
+        for (uint8_t i = 0; i < count; ++i) {
+            uint64_t k = first + i - b->hmax.sync_index;
+            double truth = b->sim.sync_us + (k + 1) * true_period;
+            double err = (double)stamps[i] - truth;
+            double nominal = first_anchor_us + ((double)(first + i) - first_anchor_index) * nominal_period - truth;
+
+            sum_sq += err * err;
+            if (err < 0)
+                err = -err;
+            if (err > max_err)
+                max_err = err;
+            if (nominal < 0)
+                nominal = -nominal;
+            if (nominal > nominal_max)
+                nominal_max = nominal;
+            n++;
+        }
+    }
+
+    printf("  %+6d ppm %+10.3f %10.1f %10.1f %12.1f\n", (int)ppm, MAX30003_TS_Drift_ppb(&ts) / 1000.0,
+           n ? sqrt(sum_sq / n) : 0.0, max_err, nominal_max);
+    return 0;
+}
+
+/**
+ * @brief Beat schedule for the R-to-R run: 800 ms with +-100 ms of
+ *        respiratory sinus arrhythmia over a 10-beat cycle.
+ */
+static uint32_t Bench_RRSchedule(void *ctx, uint32_t beat) {
+    static const int16_t rsa[10] = { 0, 59, 95, 95, 59, 0, -59, -95, -95, -59 };
+
+    (void)ctx;
+    return 800U + (uint32_t)(int32_t)rsa[beat % 10U];
+}
+
+/**
+ * @brief RR events from MAX30003_IRQHandler() against the simulated beats.
+ * @param b Benchmark context.
+ * @param ppm Simulated MAX30003 clock error.
+ */
+static int Bench_RR(Bench_TypeDef *b, int32_t ppm) {
+    MAX30003_RREventTypeDef ev;
+    uint32_t events = 0;
+    uint32_t max_rr_err = 0;
+    uint64_t max_index_err = 0;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK ||
+        MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, 8U - 1U) != HAL_OK ||
+        MAX30003_UpdateReg(&b->hmax, MAX30003_REG_EN_INT, 0, MAX30003_EN_INT_RRINT_EN) != HAL_OK ||
+        MAX30003_UpdateReg(&b->hmax, MAX30003_REG_CNFG_RTOR1, 0, MAX30003_CNFG_RTOR_EN_RTOR_EN) != HAL_OK)
+        return -1;
+    MAX30003_Sim_SetRR(&b->sim, Bench_RRSchedule, NULL);
+    MAX30003_Sim_SetClockError(&b->sim, ppm);
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+    MAX30003_Ring_Init(&MAX30003_SampleRing);
+    MAX30003_RR_Init(&MAX30003_RRQueue);
+
+    for (uint64_t t = 0; t < BENCH_RR_SECONDS * 1000000ULL; t += BENCH_POLL_US) {
+        MAX30003_SampleTypeDef drain[MAX30003_FIFO_LENGTH];
+        uint64_t truth;
+
+        HAL_Host_AdvanceMicros(BENCH_POLL_US);
+        if (t >= BENCH_RR_STALL_US && t < BENCH_RR_STALL_US + BENCH_RR_STALL_LEN_US)
+            continue;
+        if (MAX30003_Sim_INTB(&b->sim))
+            MAX30003_IRQHandler(&b->hmax);
+        while (MAX30003_Ring_Pop(&MAX30003_SampleRing, drain, MAX30003_FIFO_LENGTH) > 0)
+            ;
+
+        while (MAX30003_RR_Pop(&MAX30003_RRQueue, &ev, 1) == 1) {
+            uint32_t want = Bench_RRSchedule(NULL, b->sim.beats - 1U);
+            uint32_t rr_err = ev.rr_ms > want ? ev.rr_ms - want : want - ev.rr_ms;
+
+            /*
+             * The simulator resets its index on SYNCH, the driver does not.
+             * After the stall's overflow sync_index is re-based, so the
+             * index error is only taken before it.
+             */
+            truth = b->hmax.sync_index + b->sim.beat_index;
+            if (b->hmax.overflows == 0 && !ev.resync) {
+                uint64_t err = ev.sample_index > truth ? ev.sample_index - truth : truth - ev.sample_index;
+
+                if (err > max_index_err)
+                    max_index_err = err;
+            }
+            if (rr_err > max_rr_err)
+                max_rr_err = rr_err;
+            events++;
+        }
+    }
+
+    printf("  %+6d ppm %8u %8u %8u %10u %12u\n", (int)ppm, (unsigned)b->sim.beats, (unsigned)events,
+           (unsigned)MAX30003_RRQueue.resyncs, (unsigned)max_rr_err, (unsigned)max_index_err);
+    return 0;
+}
+
+/**
+ * @brief Block pool streaming: one drain per interrupt, three consumers
+ *        sharing each block by reference.
+ * @param b Benchmark context.
+ */
+static int Bench_Pool(Bench_TypeDef *b) {
+    static MAX30003_PoolTypeDef pool;
+    static MAX30003_BlockQueueTypeDef queue;
+    MAX30003_BlockTypeDef *storage[BENCH_STORAGE_BATCH];
+    MAX30003_BlockTypeDef *radio[MAX30003_POOL_BLOCKS];
+    uint64_t radio_due[MAX30003_POOL_BLOCKS];
+    uint32_t storage_count = 0, radio_count = 0, blocks = 0, dropped_blocks = 0;
+    uint64_t words = 0;
+
+    if (Bench_Setup(b) != 0)
+        return -1;
+    if (MAX30003_ConfigureRegisters(&b->hmax) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteField(&b->hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                            MAX30003_MNGR_INT_EFIT_MASK, 8U - 1U) != HAL_OK)
+        return -1;
+    if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_SYNCH, MAX30003_SYNCH_D) != HAL_OK)
+        return -1;
+    MAX30003_Pool_Init(&pool);
+    MAX30003_BlockQueue_Init(&queue);
+
+    for (uint64_t t = 0; t < (uint64_t)b->seconds * 1000000U; t += BENCH_POLL_US) {
+        MAX30003_BlockTypeDef *block;
+        uint32_t enabled_active = 0;
+
+        HAL_Host_AdvanceMicros(BENCH_POLL_US);
+
+        /* Interrupt side: drain into a block and hand the reference over */
+        if (MAX30003_Sim_INTB(&b->sim)) {
+            MAX30003_GetInterruptStatus(&b->hmax, &enabled_active);
+            if ((enabled_active & MAX30003_INT_EINT) &&
+                MAX30003_DrainFIFOBlock(&b->hmax, &pool, &block) == HAL_OK && block != NULL &&
+                !MAX30003_BlockQueue_Post(&queue, block)) {
+                dropped_blocks++;
+                MAX30003_Pool_Release(&pool, block);
+            }
+            if (enabled_active & MAX30003_INT_EOVF)
+                MAX30003_RecoverOverflow(&b->hmax, NULL);
+        }
+
+        /* Task side: every consumer takes a reference, nobody copies */
+        while ((block = MAX30003_BlockQueue_Take(&queue)) != NULL) {
+            blocks++;
+            words += block->count;
+
+            MAX30003_Pool_Retain(block);            /* filter: runs now */
+            MAX30003_Pool_Release(&pool, block);
+
+            MAX30003_Pool_Retain(block);            /* storage: batches */
+            storage[storage_count++] = block;
+
+            MAX30003_Pool_Retain(block);            /* radio: sends later */
+            radio_due[radio_count] = t + BENCH_RADIO_HOLD_US;
+            radio[radio_count++] = block;
+
+            MAX30003_Pool_Release(&pool, block);    /* the queue's reference */
+        }
+
+        if (storage_count == BENCH_STORAGE_BATCH) {
+            for (uint32_t i = 0; i < storage_count; ++i)
+                MAX30003_Pool_Release(&pool, storage[i]);
+            storage_count = 0;
+        }
+        while (radio_count > 0 && radio_due[0] <= t) {
+            MAX30003_Pool_Release(&pool, radio[0]);
+            radio_count--;
+            memmove(radio, radio + 1, radio_count * sizeof(radio[0]));
+            memmove(radio_due, radio_due + 1, radio_count * sizeof(radio_due[0]));
+        }
+    }
+
+    printf("Block pool, 512 sps, EFIT 8, %u consumers per block (%u s run)\n",
+           (unsigned)BENCH_POOL_CONSUMERS, (unsigned)b->seconds);
+    printf("  pool RAM            %8u bytes (%u blocks of %u)\n", (unsigned)sizeof(pool),
+           (unsigned)MAX30003_POOL_BLOCKS, (unsigned)sizeof(MAX30003_BlockTypeDef));
+    printf("  blocks drained      %8u (%.1f words each)\n", (unsigned)blocks, blocks ? (double)words / blocks : 0.0);
+    printf("  peak blocks in use  %8u\n", (unsigned)pool.in_use_peak);
+    printf("  alloc failures      %8u\n", (unsigned)pool.alloc_failures);
+    printf("  queue full          %8u\n", (unsigned)dropped_blocks);
+    printf("  copies avoided      %8.0f bytes/s\n", (double)words * sizeof(uint32_t) * BENCH_POOL_CONSUMERS / b->seconds);
+    printf("\n");
+    return pool.alloc_failures == 0 && dropped_blocks == 0 ? 0 : -1;
+}
+
+static double Bench_Now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Batch decoder check and host wall-clock timing.
+ * @details Unlike the rest of the bench this measures real time on the
+ *          build machine, so the figures vary from run to run.
+ */
+static int Bench_Decode(void) {
+    static uint32_t words[BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH];
+    static int32_t ecg[BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH];
+    static int32_t ref_ecg[BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH];
+    static uint8_t etag[BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH];
+    static uint8_t ref_etag[BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH];
+    const uint32_t total = BENCH_DECODE_CHANNELS * MAX30003_FIFO_LENGTH;
+    uint32_t seed = 1;
+    volatile uint32_t sink = 0;
+    double t0, scalar, batched, per_channel;
+
+    for (uint32_t i = 0; i < total; ++i) {
+        seed = seed * 1664525U + 1013904223U;
+        words[i] = seed >> 8;
+    }
+
+    /* Odd lengths exercise the scalar tail of the vector paths */
+    for (uint32_t n = 0; n <= 37; ++n) {
+        MAX30003_DecodeFIFO_Scalar(words, ref_ecg, ref_etag, n);
+        MAX30003_DecodeFIFO(words, ecg, etag, n);
+        for (uint32_t i = 0; i < n; ++i) {
+            if (ecg[i] != ref_ecg[i] || etag[i] != ref_etag[i] ||
+                ref_ecg[i] != MAX30003_DecodeSample(words[i]) ||
+                ref_etag[i] != MAX30003_ExtractETag(words[i])) {
+                fprintf(stderr, "decoder mismatch at %u/%u\n", (unsigned)i, (unsigned)n);
+                return -1;
+            }
+        }
+    }
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < BENCH_DECODE_ROUNDS; ++r) {
+        MAX30003_DecodeFIFO_Scalar(words, ecg, etag, total);
+        sink += (uint32_t)ecg[r % total];
+    }
+    scalar = (Bench_Now_ns() - t0) / BENCH_DECODE_ROUNDS / total;
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < BENCH_DECODE_ROUNDS; ++r) {
+        MAX30003_DecodeFIFO(words, ecg, etag, total);
+        sink += (uint32_t)ecg[r % total];
+    }
+    batched = (Bench_Now_ns() - t0) / BENCH_DECODE_ROUNDS / total;
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < BENCH_DECODE_ROUNDS; ++r) {
+        for (uint32_t c = 0; c < BENCH_DECODE_CHANNELS; ++c)
+            MAX30003_DecodeFIFO(words + c * MAX30003_FIFO_LENGTH, ecg + c * MAX30003_FIFO_LENGTH,
+                                etag + c * MAX30003_FIFO_LENGTH, MAX30003_FIFO_LENGTH);
+        sink += (uint32_t)ecg[r % total];
+    }
+    per_channel = (Bench_Now_ns() - t0) / BENCH_DECODE_ROUNDS / total;
+    (void)sink;
+
+    printf("FIFO decode, host wall clock (%s, %u channels x %u words)\n",
+           MAX30003_DecodeImplName(), (unsigned)BENCH_DECODE_CHANNELS, (unsigned)MAX30003_FIFO_LENGTH);
+    printf("  %-28s %8.3f ns/word\n", "scalar, one call", scalar);
+    printf("  %-28s %8.3f ns/word\n", "dispatched, one call", batched);
+    printf("  %-28s %8.3f ns/word\n", "dispatched, per channel", per_channel);
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Host wall-clock time per driver call, stand-in HAL vs sim transport.
+ * @details The HAL column runs the driver over max30003_transport_hal.c, the
+ *          stand-in HAL_SPI_* calls and the GPIO/bus model; the sim column binds
+ *          MAX30003_Sim_Transport, which calls the simulated device directly.
+ *          Both include the register model itself, so the difference is the
+ *          cost of the HAL layer and the bus model, and the sim column is an
+ *          upper bound for the driver's own work. Real time on the build
+ *          machine, so the figures vary from run to run.
+ */
+static int Bench_DriverTime(Bench_TypeDef *b) {
+    static const char *const names[] = { "MAX30003_ReadReg", "MAX30003_WriteReg", "MAX30003_ReadFIFO(32)" };
+    double ns[2][3];
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    uint32_t value;
+    volatile uint32_t sink = 0;
+
+    for (int sim = 0; sim < 2; ++sim) {
+        double t0;
+
+        if (Bench_Setup(b) != 0)
+            return -1;
+        if (sim && MAX30003_InitSim(&b->hmax, &b->sim) != HAL_OK)
+            return -1;
+
+        t0 = Bench_Now_ns();
+        for (uint32_t r = 0; r < BENCH_DRIVER_ROUNDS; ++r) {
+            if (MAX30003_ReadReg(&b->hmax, MAX30003_REG_INFO, &value) != HAL_OK)
+                return -1;
+            sink += value;
+        }
+        ns[sim][0] = (Bench_Now_ns() - t0) / BENCH_DRIVER_ROUNDS;
+
+        t0 = Bench_Now_ns();
+        for (uint32_t r = 0; r < BENCH_DRIVER_ROUNDS; ++r)
+            if (MAX30003_WriteReg(&b->hmax, MAX30003_REG_CNFG_CAL, MAX30003_CNFG_CAL_DEFAULT_CONFIG) != HAL_OK)
+                return -1;
+        ns[sim][1] = (Bench_Now_ns() - t0) / BENCH_DRIVER_ROUNDS;
+
+        t0 = Bench_Now_ns();
+        for (uint32_t r = 0; r < BENCH_DRIVER_ROUNDS; ++r) {
+            if (MAX30003_ReadFIFO(&b->hmax, fifo, MAX30003_FIFO_LENGTH) != HAL_OK)
+                return -1;
+            sink += fifo[r % MAX30003_FIFO_LENGTH];
+        }
+        ns[sim][2] = (Bench_Now_ns() - t0) / BENCH_DRIVER_ROUNDS;
+    }
+    (void)sink;
+
+    printf("Driver call time, host wall clock (%u calls each)\n", (unsigned)BENCH_DRIVER_ROUNDS);
+    printf("  %-28s %10s %10s %10s\n", "operation", "HAL ns", "sim ns", "HAL share");
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        printf("  %-28s %10.1f %10.1f %9.0f%%\n", names[i], ns[0][i], ns[1][i],
+               ns[1][i] > 0.0 ? (ns[0][i] - ns[1][i]) * 100.0 / ns[0][i] : 0.0);
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Check the fixed-point uV conversion against double precision over
+ *        the full code range at every gain.
+ */
+static int Bench_Units(void) {
+    static const unsigned gains[] = { 20, 40, 80, 160 };
+    static int32_t codes[1 << 18];
+    static int32_t uv_q8[1 << 18];
+
+    for (int32_t c = 0; c < (1 << 18); ++c)
+        codes[c] = c - (1 << 17);
+
+    printf("Code to uV, Q8 fixed point vs double (VREF %u mV)\n", (unsigned)MAX30003_VREF_mV);
+    printf("  %8s %14s %14s\n", "gain", "full scale uV", "max err LSB");
+    for (uint8_t g = 0; g < 4; ++g) {
+        double max_err = 0;
+
+        MAX30003_CodeToUV_Q8_Block(codes, uv_q8, 1 << 18, g);
+        for (int32_t c = 0; c < (1 << 18); ++c) {
+            double ref = codes[c] * (MAX30003_VREF_mV * 1000.0) / (131072.0 * gains[g]) * 256.0;
+            double err = fabs(uv_q8[c] - ref);
+
+            if (err > max_err)
+                max_err = err;
+            if (uv_q8[c] != MAX30003_CodeToUV_Q8(codes[c], g)) {
+                fprintf(stderr, "uV block/scalar mismatch at code %d\n", (int)codes[c]);
+                return -1;
+            }
+        }
+        printf("  %4u V/V %14.3f %14.3f\n", gains[g], uv_q8[(1 << 18) - 1] / 256.0, max_err);
+        if (max_err > 0.5)
+            return -1;
+    }
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Round-trip the packed formats over the whole code range and time
+ *        the pack/unpack kernels.
+ */
+static int Bench_Pack(void) {
+    static uint32_t words[1 << 18];
+    static uint32_t words_out[1 << 18];
+    static int32_t codes[1 << 18];
+    static int32_t codes_out[1 << 18];
+    static uint8_t etag[1 << 18];
+    static uint8_t packed[MAX30003_PACK24_BYTES(1 << 18)];
+    const uint32_t total = 1 << 18;
+    volatile uint32_t sink = 0;
+    double t0, p24, u24, p18, u18;
+
+    for (uint32_t c = 0; c < total; ++c) {
+        codes[c] = (int32_t)c - (1 << 17);
+        words[c] = (((uint32_t)codes[c] & 0x3FFFFU) << 6) | ((c % 8U) << MAX30003_ETAG_SHIFT);
+    }
+
+    MAX30003_Pack24(words, packed, total);
+    MAX30003_Unpack24(packed, words_out, total);
+    MAX30003_Unpack24_Decode(packed, codes_out, etag, total);
+    for (uint32_t c = 0; c < total; ++c) {
+        if (words_out[c] != words[c] || codes_out[c] != codes[c] || etag[c] != MAX30003_ExtractETag(words[c])) {
+            fprintf(stderr, "PACK24 mismatch at %u\n", (unsigned)c);
+            return -1;
+        }
+    }
+
+    /* Every length up to a few groups exercises the bit-serial tail */
+    for (uint32_t n = 0; n <= 13; ++n) {
+        MAX30003_Pack18(codes + 1000, packed, n);
+        MAX30003_Unpack18(packed, codes_out, n);
+        for (uint32_t i = 0; i < n; ++i) {
+            if (codes_out[i] != codes[1000 + i]) {
+                fprintf(stderr, "PACK18 mismatch at %u/%u\n", (unsigned)i, (unsigned)n);
+                return -1;
+            }
+        }
+    }
+    MAX30003_Pack18(codes, packed, total);
+    MAX30003_Unpack18(packed, codes_out, total);
+    if (memcmp(codes, codes_out, sizeof(codes)) != 0) {
+        fprintf(stderr, "PACK18 full-range mismatch\n");
+        return -1;
+    }
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < 64; ++r) {
+        MAX30003_Pack24(words, packed, total);
+        sink += packed[r];
+    }
+    p24 = (Bench_Now_ns() - t0) / 64 / total;
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < 64; ++r) {
+        MAX30003_Unpack24_Decode(packed, codes_out, etag, total);
+        sink += (uint32_t)codes_out[r];
+    }
+    u24 = (Bench_Now_ns() - t0) / 64 / total;
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < 64; ++r) {
+        MAX30003_Pack18(codes, packed, total);
+        sink += packed[r];
+    }
+    p18 = (Bench_Now_ns() - t0) / 64 / total;
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < 64; ++r) {
+        MAX30003_Unpack18(packed, codes_out, total);
+        sink += (uint32_t)codes_out[r];
+    }
+    u18 = (Bench_Now_ns() - t0) / 64 / total;
+    (void)sink;
+
+    printf("Packed sample formats (round trip exact over all 2^18 codes)\n");
+    printf("  %-24s %10s %12s %12s %12s\n", "format", "bytes/smp", "1 min @512", "pack ns", "unpack ns");
+    printf("  %-24s %10.2f %12u %12s %12s\n", "ring slot (struct)", (double)sizeof(MAX30003_SampleTypeDef),
+           (unsigned)(sizeof(MAX30003_SampleTypeDef) * 512U * 60U), "-", "-");
+    printf("  %-24s %10.2f %12u %12s %12s\n", "FIFO word (uint32_t)", 4.0, 4U * 512U * 60U, "-", "-");
+    printf("  %-24s %10.2f %12u %12.3f %12.3f\n", "PACK24 (data + ETAG)", 3.0,
+           (unsigned)MAX30003_PACK24_BYTES(512U * 60U), p24, u24);
+    printf("  %-24s %10.2f %12u %12.3f %12.3f\n", "PACK18 (data only)", 18.0 / 8.0,
+           (unsigned)MAX30003_PACK18_BYTES(512U * 60U), p18, u18);
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Synthetic ECG: P-QRS-T complexes on an 800+-100 ms RR schedule
+ *        with baseline wander, mains and white noise, at GAIN 80.
+ * @param ecg Output codes.
+ * @param count Samples to generate.
+ * @param fs Sample rate, Hz.
+ * @param noise_uv Peak white noise, uV.
+ * @param r_index Output, sample index of each R peak.
+ * @return Number of beats placed.
+ */
+static uint32_t Bench_SynthECG(int32_t *ecg, uint32_t count, double fs, double noise_uv, uint64_t *r_index) {
+    static const struct { double offset_ms, sigma_ms, uv; } wave[] = {
+        { -160, 20, 150 }, { -25, 8, -150 }, { 0, 10, 1200 }, { 25, 10, -250 }, { 250, 40, 350 },
+    };
+    uint32_t beats = 0, seed = 12345;
+    double t_beat = 0.6;
+
+    for (uint32_t i = 0; i < count; ++i)
+        ecg[i] = 0;
+
+    while (beats < BENCH_QRS_MAX_BEATS && t_beat * fs < count) {
+        r_index[beats] = (uint64_t)(t_beat * fs + 0.5);
+        for (size_t w = 0; w < sizeof(wave) / sizeof(wave[0]); ++w) {
+            double centre = t_beat + wave[w].offset_ms / 1000.0;
+            double sigma = wave[w].sigma_ms / 1000.0;
+            int64_t lo = (int64_t)((centre - 4 * sigma) * fs), hi = (int64_t)((centre + 4 * sigma) * fs);
+
+            for (int64_t k = lo < 0 ? 0 : lo; k <= hi && k < (int64_t)count; ++k) {
+                double d = (k / fs - centre) / sigma;
+                ecg[k] += (int32_t)(wave[w].uv * BENCH_UV_CODE * exp(-0.5 * d * d));
+            }
+        }
+        seed = seed * 1664525U + 1013904223U;
+        t_beat += Bench_RRSchedule(NULL, beats) / 1000.0 + ((int32_t)(seed >> 24) - 128) / 128.0 * 0.05;
+        beats++;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        double t = i / fs;
+
+        seed = seed * 1664525U + 1013904223U;
+        ecg[i] += (int32_t)((200 * sin(2 * BENCH_PI * 0.3 * t) + 50 * sin(2 * BENCH_PI * 50 * t)
+                             + ((int32_t)(seed >> 16) - 32768) / 32768.0 * noise_uv) * BENCH_UV_CODE);
+    }
+    return beats;
+}
+
+/**
+ * @brief QRS detector accuracy and cost on synthetic ECG.
+ * @param rate_mHz Sample rate.
+ */
+static int Bench_QRS(uint32_t rate_mHz) {
+    static int32_t ecg[BENCH_QRS_SECONDS * MAX30003_QRS_MAX_HZ];
+    static uint64_t truth[BENCH_QRS_MAX_BEATS];
+    static uint64_t found[BENCH_QRS_MAX_BEATS * 2];
+    static MAX30003_QRS_TypeDef det;
+    MAX30003_QRSEventTypeDef ev[MAX30003_QRS_BLOCK];
+    const double fs = rate_mHz / 1000.0;
+    const uint32_t count = (uint32_t)(BENCH_QRS_SECONDS * fs);
+    const uint64_t skip = (uint64_t)(BENCH_QRS_SKIP_S * fs), tol = (uint64_t)(BENCH_QRS_MATCH_MS * fs / 1000.0);
+    uint32_t beats, nfound = 0, tp = 0, fn = 0, fp = 0, searchback = 0;
+    double err_sum = 0, err_sq = 0, err_max = 0, t0, block_ns, single_ns, mean;
+
+    beats = Bench_SynthECG(ecg, count, fs, 30, truth);
+
+    if (MAX30003_QRS_Init(&det, rate_mHz, 0) != HAL_OK)
+        return -1;
+    t0 = Bench_Now_ns();
+    for (uint32_t i = 0; i < count; i += MAX30003_FIFO_LENGTH) {
+        uint32_t n = MAX30003_QRS_Process(&det, ecg + i, count - i < MAX30003_FIFO_LENGTH ? count - i : MAX30003_FIFO_LENGTH,
+                                          ev, MAX30003_QRS_BLOCK);
+
+        for (uint32_t k = 0; k < n && nfound < BENCH_QRS_MAX_BEATS * 2; ++k) {
+            found[nfound++] = ev[k].sample_index;
+            searchback += ev[k].searchback;
+        }
+    }
+    block_ns = (Bench_Now_ns() - t0) / count;
+
+    if (MAX30003_QRS_Init(&det, rate_mHz, 0) != HAL_OK)
+        return -1;
+    t0 = Bench_Now_ns();
+    for (uint32_t i = 0; i < count; ++i)
+        MAX30003_QRS_Process(&det, ecg + i, 1, ev, MAX30003_QRS_BLOCK);
+    single_ns = (Bench_Now_ns() - t0) / count;
+
+    /* Greedy match in time order, both lists are sorted */
+    for (uint32_t b = 0, f = 0; b < beats || f < nfound;) {
+        if (b < beats && truth[b] < skip) { b++; continue; }
+        if (f < nfound && found[f] < skip) { f++; continue; }
+        if (b < beats && f < nfound && (found[f] > truth[b] ? found[f] - truth[b] : truth[b] - found[f]) <= tol) {
+            double err = ((double)found[f] - (double)truth[b]) * 1000.0 / fs;
+
+            err_sum += err;
+            err_sq += err * err;
+            if (fabs(err) > err_max)
+                err_max = fabs(err);
+            tp++, b++, f++;
+        } else if (f >= nfound || (b < beats && truth[b] < found[f])) {
+            fn++, b++;
+        } else {
+            fp++, f++;
+        }
+    }
+
+    mean = tp ? err_sum / tp : 0.0;
+    printf("  %6.0f Hz %6u %6u %6u %6u %4u %8.2f %8.2f %8.1f %6.1f %6.1f %10.1f %10.1f\n", fs, (unsigned)(tp + fn),
+           (unsigned)tp, (unsigned)fn, (unsigned)fp, (unsigned)searchback,
+           tp + fn ? 100.0 * tp / (tp + fn) : 0.0, tp + fp ? 100.0 * tp / (tp + fp) : 0.0,
+           mean, tp ? sqrt(err_sq / tp - mean * mean) : 0.0, err_max, block_ns, single_ns);
+    return tp + fn == 0 || fn * 100U > (tp + fn) || fp * 100U > (tp + fn) || fabs(mean) > BENCH_QRS_BIAS_MS ? -1 : 0;
+}
+
+/**
+ * @brief HRV engine against a from-scratch double-precision recompute of
+ *        the same window after every beat.
+ */
+static int Bench_HRV(void) {
+    static uint16_t rr[BENCH_HRV_BEATS];
+    static uint8_t linked[BENCH_HRV_BEATS];
+    static MAX30003_HRV_TypeDef hrv;
+    MAX30003_HRV_MetricsTypeDef m;
+    double err[5] = { 0 }, engine_ns = 0, scratch_ns = 0;
+    uint32_t seed = 777, accepted = 0, start = 0, rejected = 0;
+    uint8_t link = 0;
+    volatile double sink = 0;
+
+    MAX30003_HRV_Init(&hrv, 0);
+    for (uint32_t i = 0; i < BENCH_HRV_BEATS; ++i) {
+        double t1, ref[5], sum = 0, sum2 = 0, d2 = 0;
+        uint32_t v, n, nd = 0, nn50 = 0;
+
+        /* RSA, a slow trend, jitter and an occasional artefact */
+        seed = seed * 1664525U + 1013904223U;
+        v = (uint32_t)(850 + 60 * sin(2 * BENCH_PI * i / 4.5) + 120 * sin(2 * BENCH_PI * i / 900.0)
+                       + ((int32_t)(seed >> 24) - 128) * 0.3);
+        if ((seed & 0x3FF) == 7)
+            v = 180;
+
+        t1 = Bench_Now_ns();
+        MAX30003_HRV_Push(&hrv, v);
+        MAX30003_HRV_Get(&hrv, &m);
+        engine_ns += Bench_Now_ns() - t1;
+
+        /* Reference: same acceptance and window rules, recomputed in full */
+        t1 = Bench_Now_ns();
+        if (v < MAX30003_HRV_RR_MIN_MS || v > MAX30003_HRV_RR_MAX_MS) {
+            link = 0;
+            rejected++;
+        } else {
+            rr[accepted] = (uint16_t)v;
+            linked[accepted++] = link;
+            link = 1;
+        }
+        if (accepted - start > MAX30003_HRV_CAPACITY)
+            start++;
+        for (;;) {
+            uint32_t total = 0;
+
+            for (uint32_t k = start; k < accepted; ++k)
+                total += rr[k];
+            if (total <= hrv.window_ms || accepted - start <= 1)
+                break;
+            start++;
+        }
+        n = accepted - start;
+        for (uint32_t k = start; k < accepted; ++k) {
+            sum += rr[k];
+            sum2 += (double)rr[k] * rr[k];
+            if (k > start && linked[k]) {
+                double d = (double)rr[k] - rr[k - 1];
+
+                d2 += d * d;
+                nd++;
+                nn50 += fabs(d) > MAX30003_HRV_NN50_MS;
+            }
+        }
+        ref[0] = n ? sum / n : 0;
+        ref[1] = n > 1 ? sqrt((sum2 - sum * sum / n) / (n - 1)) : 0;
+        ref[2] = nd ? sqrt(d2 / nd) : 0;
+        ref[3] = nd ? 100.0 * nn50 / nd : 0;
+        ref[4] = n ? 60000.0 * n / sum : 0;
+        scratch_ns += Bench_Now_ns() - t1;
+        sink += ref[1];
+
+        if (m.beats != n || m.diffs != nd || m.span_ms != (uint32_t)sum) {
+            fprintf(stderr, "HRV window mismatch at beat %u: %u/%u/%u ms vs %u/%u/%.0f ms\n", (unsigned)i,
+                    (unsigned)m.beats, (unsigned)m.diffs, (unsigned)m.span_ms, (unsigned)n, (unsigned)nd, sum);
+            return -1;
+        }
+        err[0] = fmax(err[0], fabs(MAX30003_HRV_TO_DOUBLE(m.mean_rr_ms) - ref[0]));
+        err[1] = fmax(err[1], fabs(MAX30003_HRV_TO_DOUBLE(m.sdnn_ms) - ref[1]));
+        err[2] = fmax(err[2], fabs(MAX30003_HRV_TO_DOUBLE(m.rmssd_ms) - ref[2]));
+        err[3] = fmax(err[3], fabs(MAX30003_HRV_TO_DOUBLE(m.pnn50_pct) - ref[3]));
+        err[4] = fmax(err[4], fabs(MAX30003_HRV_TO_DOUBLE(m.hr_bpm) - ref[4]));
+    }
+    (void)sink;
+
+    printf("HRV engine, %u beats, %u s window (%s build, %u artefacts rejected)\n", (unsigned)BENCH_HRV_BEATS,
+           (unsigned)(hrv.window_ms / 1000U), MAX30003_HRV_FRAC_BITS ? "Q8" : "double", (unsigned)rejected);
+    printf("  %-10s %10s %10s %10s %10s %10s\n", "", "mean RR", "SDNN", "RMSSD", "pNN50 %", "HR bpm");
+    printf("  %-10s %10.2f %10.2f %10.2f %10.2f %10.2f\n", "last", MAX30003_HRV_TO_DOUBLE(m.mean_rr_ms),
+           MAX30003_HRV_TO_DOUBLE(m.sdnn_ms), MAX30003_HRV_TO_DOUBLE(m.rmssd_ms),
+           MAX30003_HRV_TO_DOUBLE(m.pnn50_pct), MAX30003_HRV_TO_DOUBLE(m.hr_bpm));
+    printf("  %-10s %10.4f %10.4f %10.4f %10.4f %10.4f\n", "max err", err[0], err[1], err[2], err[3], err[4]);
+    printf("  per beat: incremental %.1f ns, recompute %.1f ns\n", engine_ns / BENCH_HRV_BEATS,
+           scratch_ns / BENCH_HRV_BEATS);
+
+    /* The fastest accepted rate must still fill the default window */
+    MAX30003_HRV_Init(&hrv, 0);
+    for (uint32_t i = 0; i < 2U * MAX30003_HRV_WINDOW_MS / MAX30003_HRV_RR_MIN_MS; ++i)
+        MAX30003_HRV_Push(&hrv, MAX30003_HRV_RR_MIN_MS);
+    MAX30003_HRV_Get(&hrv, &m);
+    printf("  at %u bpm: %u beats span %.1f s of %u s (capacity %u)\n\n", (unsigned)(60000U / MAX30003_HRV_RR_MIN_MS),
+           (unsigned)m.beats, m.span_ms / 1000.0, (unsigned)(hrv.window_ms / 1000U), (unsigned)MAX30003_HRV_CAPACITY);
+
+    return err[1] > 0.01 || err[2] > 0.01 || err[4] > 0.01 || m.span_ms != hrv.window_ms ? -1 : 0;
+}
+
+/**
+ * @brief Streaming and batch Lomb-Scargle against a direct double-precision
+ *        evaluation, on RR with known LF (0.1 Hz) and HF (0.25 Hz) tones.
+ */
+static int Bench_Lomb(void) {
+    static uint32_t t_ms[BENCH_LOMB_BEATS];
+    static uint16_t rr[BENCH_LOMB_BEATS];
+    static MAX30003_LombTypeDef l;
+    const double a_lf = 30, a_hf = 20;
+    MAX30003_Lomb_BandsTypeDef stream, batch;
+    double ref_lf = 0, ref_hf = 0, t = 0, stream_ns = 0, batch_ns, t0;
+    uint32_t seed = 4242, first, n, skipped = 0;
+
+    MAX30003_Lomb_Init(&l, 0);
+    for (uint32_t i = 0; i < BENCH_LOMB_BEATS; ++i) {
+        seed = seed * 1664525U + 1013904223U;
+        rr[i] = (uint16_t)(850 + a_lf * sin(2 * BENCH_PI * 0.1 * t) + a_hf * sin(2 * BENCH_PI * 0.25 * t)
+                           + ((int32_t)(seed >> 24) - 128) * 0.05);
+        t += rr[i] / 1000.0;
+        t_ms[i] = (uint32_t)(t * 1000.0 + 0.5);
+
+        t0 = Bench_Now_ns();
+        /* Every 200th beat is an artefact: time advances, no sample */
+        if (i % 200U == 100U) {
+            MAX30003_Lomb_Skip(&l, rr[i]);
+            skipped++;
+        } else {
+            MAX30003_Lomb_Push(&l, rr[i]);
+        }
+        stream_ns += Bench_Now_ns() - t0;
+    }
+    MAX30003_Lomb_Get(&l, NULL, &stream);
+
+    /* The same window, without the artefacts, for the batch and reference */
+    {
+        static uint32_t wt[BENCH_LOMB_BEATS];
+        static uint16_t wrr[BENCH_LOMB_BEATS];
+        double mean = 0;
+
+        for (first = BENCH_LOMB_BEATS; first > 0 && l.now_ms - t_ms[first - 1] <= l.window_ms; --first)
+            ;
+        n = 0;
+        for (uint32_t i = first; i < BENCH_LOMB_BEATS; ++i) {
+            if (i % 200U == 100U)
+                continue;
+            wt[n] = t_ms[i];
+            wrr[n++] = rr[i];
+        }
+
+        t0 = Bench_Now_ns();
+        MAX30003_Lomb_Batch(wt, wrr, n, NULL, &batch);
+        batch_ns = Bench_Now_ns() - t0;
+
+        for (uint32_t i = 0; i < n; ++i)
+            mean += wrr[i];
+        mean /= n;
+        for (uint32_t k = 1; k <= MAX30003_LOMB_BINS; ++k) {
+            double w = 2 * BENCH_PI * k * MAX30003_LOMB_DF_uHz / 1e6, s2 = 0, c2 = 0, tau;
+            double yc = 0, ys = 0, cc = 0, ss = 0, p;
+
+            for (uint32_t i = 0; i < n; ++i) {
+                s2 += sin(2 * w * wt[i] / 1000.0);
+                c2 += cos(2 * w * wt[i] / 1000.0);
+            }
+            tau = atan2(s2, c2) / (2 * w);
+            for (uint32_t i = 0; i < n; ++i) {
+                double ph = w * (wt[i] / 1000.0 - tau);
+
+                yc += (wrr[i] - mean) * cos(ph);
+                ys += (wrr[i] - mean) * sin(ph);
+                cc += cos(ph) * cos(ph);
+                ss += sin(ph) * sin(ph);
+            }
+            p = (yc * yc / cc + ys * ys / ss) / 2 * 2 * ((wt[n - 1] - wt[0]) / 1000.0) / n;
+            if (k * MAX30003_LOMB_DF_uHz >= MAX30003_LOMB_LF_LO_uHz && k * MAX30003_LOMB_DF_uHz < MAX30003_LOMB_LF_HI_uHz)
+                ref_lf += p * MAX30003_LOMB_DF_uHz / 1e6;
+            else if (k * MAX30003_LOMB_DF_uHz >= MAX30003_LOMB_LF_HI_uHz && k * MAX30003_LOMB_DF_uHz <= MAX30003_LOMB_HF_HI_uHz)
+                ref_hf += p * MAX30003_LOMB_DF_uHz / 1e6;
+        }
+    }
+
+    printf("Lomb-Scargle LF/HF, %u s window, %u bins (%u beats, %u artefacts skipped)\n",
+           (unsigned)(l.window_ms / 1000U), (unsigned)MAX30003_LOMB_BINS, (unsigned)BENCH_LOMB_BEATS, (unsigned)skipped);
+    printf("  %-22s %8s %10s %10s %8s\n", "", "beats", "LF ms^2", "HF ms^2", "LF/HF");
+    printf("  %-22s %8s %10.1f %10.1f %8.3f\n", "tones (A^2/2)", "-", a_lf * a_lf / 2, a_hf * a_hf / 2,
+           a_lf * a_lf / (a_hf * a_hf));
+    printf("  %-22s %8u %10.1f %10.1f %8.3f\n", "direct, double", (unsigned)n, ref_lf, ref_hf, ref_lf / ref_hf);
+    printf("  %-22s %8u %10.1f %10.1f %8.3f\n", "streaming", (unsigned)stream.beats, (double)stream.lf_ms2,
+           (double)stream.hf_ms2, (double)stream.lf_hf);
+    printf("  %-22s %8u %10.1f %10.1f %8.3f\n", "batch", (unsigned)batch.beats, (double)batch.lf_ms2,
+           (double)batch.hf_ms2, (double)batch.lf_hf);
+    printf("  per beat: streaming %.0f ns, batch over the window %.0f ns\n\n", stream_ns / BENCH_LOMB_BEATS, batch_ns);
+
+    return stream.beats != n || fabs(stream.lf_ms2 - ref_lf) > 0.01 * ref_lf || fabs(stream.hf_ms2 - ref_hf) > 0.01 * ref_hf
+        || fabs(batch.lf_ms2 - ref_lf) > 0.01 * ref_lf || fabs(batch.hf_ms2 - ref_hf) > 0.01 * ref_hf ? -1 : 0;
+}
+
+/**
+ * @brief Gain of the quantised cascade at one frequency, dB.
+ */
+static double Bench_FilterGain_dB(const MAX30003_FilterBankTypeDef *fb, double f, double fs) {
+    const double w = 2 * BENCH_PI * f / fs, one = 1 << MAX30003_FILTER_COEFF_FRAC;
+    double g = 1;
+
+    for (uint32_t s = 0; s < fb->sections; ++s) {
+        const MAX30003_BiquadTypeDef *q = &fb->sec[s];
+        double nr = q->b0 + q->b1 * cos(w) + q->b2 * cos(2 * w), ni = -q->b1 * sin(w) - q->b2 * sin(2 * w);
+        double dr = one - q->na1 * cos(w) - q->na2 * cos(2 * w), di = q->na1 * sin(w) + q->na2 * sin(2 * w);
+
+        g *= sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+    }
+    return 20 * log10(g);
+}
+
+/**
+ * @brief Filter bank response, vector/scalar agreement, start-up from the
+ *        electrode offset and host throughput for 8 channels at 512 sps.
+ */
+static int Bench_Filter(void) {
+    static const double tones[MAX30003_FILTER_CHANNELS] = { 0.05, 0.5, 5, 20, 40, 50, 60, 100 };
+    static MAX30003_FilterBankTypeDef fb, ref, cold;
+    static int32_t in[MAX30003_FILTER_CHANNELS][MAX30003_FIFO_LENGTH];
+    static int32_t out[MAX30003_FILTER_CHANNELS][MAX30003_FIFO_LENGTH];
+    static int32_t ref_out[MAX30003_FILTER_CHANNELS][MAX30003_FIFO_LENGTH];
+    const double fs = 512, amp = 10000;
+    const int32_t offset = 30000;
+    const uint32_t total = BENCH_FILTER_SECONDS * 512U, settle = total * 2U / 3U;
+    const int32_t *in_p[MAX30003_FILTER_CHANNELS];
+    int32_t *out_p[MAX30003_FILTER_CHANNELS], *ref_p[MAX30003_FILTER_CHANNELS];
+    double sum_in[MAX30003_FILTER_CHANNELS] = { 0 }, sum_out[MAX30003_FILTER_CHANNELS] = { 0 };
+    double warm_peak = 0, cold_peak = 0, t0, vec_ns;
+    uint32_t mismatches = 0;
+    volatile uint32_t sink = 0;
+    int fail = 0;
+
+    for (uint32_t c = 0; c < MAX30003_FILTER_CHANNELS; ++c) {
+        in_p[c] = in[c];
+        out_p[c] = out[c];
+        ref_p[c] = ref_out[c];
+    }
+    if (MAX30003_Filter_Init(&fb, MAX30003_FILTER_CHANNELS, 512000U, NULL) != HAL_OK ||
+        MAX30003_Filter_Init(&cold, 1, 512000U, NULL) != HAL_OK)
+        return -1;
+    for (uint32_t c = 0; c < MAX30003_FILTER_CHANNELS; ++c)
+        MAX30003_Filter_Reset(&fb, c, offset);
+    ref = fb;
+
+    for (uint32_t i0 = 0; i0 < total; i0 += MAX30003_FIFO_LENGTH) {
+        for (uint32_t c = 0; c < MAX30003_FILTER_CHANNELS; ++c)
+            for (uint32_t i = 0; i < MAX30003_FIFO_LENGTH; ++i)
+                in[c][i] = offset + (int32_t)lround(amp * sin(2 * BENCH_PI * tones[c] * (i0 + i) / fs));
+
+        MAX30003_Filter_Process(&fb, in_p, out_p, MAX30003_FIFO_LENGTH);
+        MAX30003_Filter_Process_Scalar(&ref, in_p, ref_p, MAX30003_FIFO_LENGTH);
+        MAX30003_Filter_Process_Scalar(&cold, &in_p[2], &ref_p[2], MAX30003_FIFO_LENGTH);
+
+        for (uint32_t c = 0; c < MAX30003_FILTER_CHANNELS; ++c) {
+            for (uint32_t i = 0; i < MAX30003_FIFO_LENGTH; ++i) {
+                double y = out[c][i] / (double)(1 << MAX30003_FILTER_SHIFT);
+
+                mismatches += out[c][i] != ref_out[c][i] && c != 2U;
+                if (i0 + i >= settle) {
+                    sum_in[c] += (in[c][i] - offset) * (double)(in[c][i] - offset);
+                    sum_out[c] += y * y;
+                }
+                if (c == 2U && i0 + i < 2U * 512U) {
+                    double cold_y = fabs(ref_out[2][i] / (double)(1 << MAX30003_FILTER_SHIFT));
+
+                    warm_peak = fabs(y) > warm_peak ? fabs(y) : warm_peak;
+                    cold_peak = cold_y > cold_peak ? cold_y : cold_peak;
+                }
+            }
+        }
+    }
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < BENCH_FILTER_ROUNDS; ++r) {
+        MAX30003_Filter_Process(&fb, in_p, out_p, MAX30003_FIFO_LENGTH);
+        sink += (uint32_t)out[r % MAX30003_FILTER_CHANNELS][0];
+    }
+    vec_ns = (Bench_Now_ns() - t0) / BENCH_FILTER_ROUNDS / (MAX30003_FILTER_CHANNELS * MAX30003_FIFO_LENGTH);
+#if MAX30003_FILTER_IMPL != MAX30003_FILTER_SCALAR
+    double scalar_ns;
+
+    t0 = Bench_Now_ns();
+    for (uint32_t r = 0; r < BENCH_FILTER_ROUNDS; ++r) {
+        MAX30003_Filter_Process_Scalar(&fb, in_p, out_p, MAX30003_FIFO_LENGTH);
+        sink += (uint32_t)out[r % MAX30003_FILTER_CHANNELS][0];
+    }
+    scalar_ns = (Bench_Now_ns() - t0) / BENCH_FILTER_ROUNDS / (MAX30003_FILTER_CHANNELS * MAX30003_FIFO_LENGTH);
+#endif
+    (void)sink;
+
+    printf("Q31 filter bank, 512 sps, HP %.1f Hz, notch %u Hz, LP %u Hz, %u sections (%s)\n",
+           MAX30003_FILTER_HP_mHz / 1000.0, (unsigned)(MAX30003_FILTER_NOTCH_mHz / 1000U),
+           (unsigned)(MAX30003_FILTER_LP_mHz / 1000U), (unsigned)fb.sections, MAX30003_Filter_ImplName());
+    printf("  %10s %12s %12s\n", "tone Hz", "design dB", "measured dB");
+    for (uint32_t c = 0; c < MAX30003_FILTER_CHANNELS; ++c) {
+        double design = Bench_FilterGain_dB(&fb, tones[c], fs);
+        double measured = 10 * log10(sum_out[c] / sum_in[c]);
+
+        printf("  %10.2f %12.2f %12.2f\n", tones[c], design, measured);
+        if (design > -40 ? fabs(measured - design) > 0.05 : measured > -40)
+            fail = 1;
+    }
+#if MAX30003_FILTER_IMPL == MAX30003_FILTER_SCALAR
+    /* Process is the scalar path itself; build with -msse4.1 or -mavx2 to compare */
+    printf("  vector/scalar comparison      skipped, scalar build (-msse4.1 or -mavx2 to enable)\n");
+#else
+    printf("  vector/scalar mismatches      %8u\n", (unsigned)mismatches);
+#endif
+    printf("  5 Hz start-up peak, codes     %8.0f primed, %.0f from zero (tone %.0f)\n", warm_peak, cold_peak, amp);
+#if MAX30003_FILTER_IMPL == MAX30003_FILTER_SCALAR
+    printf("  ns/channel-sample             %8.2f scalar, vector skipped\n", vec_ns);
+#else
+    printf("  ns/channel-sample             %8.2f %s, %.2f scalar\n", vec_ns, MAX30003_Filter_ImplName(), scalar_ns);
+#endif
+    printf("  8 x 512 sps                   %8.0f us/s\n\n", vec_ns * MAX30003_FILTER_CHANNELS * 512.0 / 1000.0);
+
+    return fail || mismatches != 0 || warm_peak > 1.2 * amp ? -1 : 0;
+}
+
+/**
+ * @brief Resample two tones and an out-of-band tone, check the output
+ *        against the ideal signal at the output instants and time it.
+ * @details Drain sizes vary from 1 to 32 samples so the carried phase is
+ *          exercised. The out-of-band tone sits at 0.7 of the output rate,
+ *          where it would alias into the band without the low-pass; it is
+ *          skipped when the input cannot represent it.
+ */
+static int Bench_Resample(uint32_t in_mHz, uint32_t out_mHz) {
+    static MAX30003_ResampleTypeDef rs, rs_alias;
+    static int32_t in[2][MAX30003_FIFO_LENGTH];
+    static int32_t out[2][MAX30003_FIFO_LENGTH + 1U];
+    const double fin = in_mHz / 1000.0, fout = out_mHz / 1000.0, fa = 0.7 * fout;
+    const double amp[2] = { 20000, 15000 }, tone[2] = { 10, 30 };
+    const int alias = fa < 0.45 * fin;
+    const uint32_t total = (uint32_t)(BENCH_RESAMPLE_SECONDS * fin);
+    const int32_t *in_p[2] = { in[0], in[1] };
+    int32_t *out_p[2] = { out[0], out[1] };
+    double sig = 0, err = 0, alias_in = 0, alias_out = 0, delay, ns = 0, t0;
+    uint32_t produced = 0, expected, seed = 77;
+    char alias_db[16] = "-", taps[16];
+
+    /* One resampler per signal, so the bench runs at the default MAX30003_RESAMPLE_CHANNELS */
+    if (MAX30003_Resample_Init(&rs, 1, in_mHz, out_mHz) != HAL_OK ||
+        MAX30003_Resample_Init(&rs_alias, 1, in_mHz, out_mHz) != HAL_OK) {
+        printf("  %6.0f -> %6.0f  exceeds MAX30003_RESAMPLE_PHASES %u or MAX30003_RESAMPLE_TAPS %u\n", fin, fout,
+               (unsigned)MAX30003_RESAMPLE_PHASES, (unsigned)MAX30003_RESAMPLE_TAPS);
+        return -1;
+    }
+    delay = MAX30003_Resample_Delay_us(&rs) * 1e-6;
+
+    for (uint32_t i0 = 0; i0 < total;) {
+        uint32_t len, n;
+
+        seed = seed * 1664525U + 1013904223U;
+        len = 1U + (seed >> 27);
+        if (len > total - i0)
+            len = total - i0;
+        for (uint32_t i = 0; i < len; ++i) {
+            double t = (i0 + i) / fin;
+
+            in[0][i] = (int32_t)lround(amp[0] * sin(2 * BENCH_PI * tone[0] * t) + amp[1] * sin(2 * BENCH_PI * tone[1] * t));
+            in[1][i] = alias ? (int32_t)lround(amp[0] * sin(2 * BENCH_PI * fa * t)) : 0;
+            if (i0 + i >= fin)
+                alias_in += (double)in[1][i] * in[1][i];
+        }
+
+        t0 = Bench_Now_ns();
+        n = MAX30003_Resample_Process(&rs, &in_p[0], &out_p[0], len);
+        if (MAX30003_Resample_Process(&rs_alias, &in_p[1], &out_p[1], len) != n)
+            return -1;
+        ns += Bench_Now_ns() - t0;
+
+        for (uint32_t m = 0; m < n; ++m) {
+            double t = (produced + m) / fout - delay;
+            double ref = amp[0] * sin(2 * BENCH_PI * tone[0] * t) + amp[1] * sin(2 * BENCH_PI * tone[1] * t);
+
+            if (t >= 1.0) {
+                sig += ref * ref;
+                err += (out[0][m] - ref) * (out[0][m] - ref);
+                alias_out += (double)out[1][m] * out[1][m];
+            }
+        }
+        produced += n;
+        i0 += len;
+    }
+    expected = (uint32_t)MAX30003_RESAMPLE_MAX_OUT((uint64_t)total, rs.L, rs.M);
+
+    if (alias)
+        snprintf(alias_db, sizeof(alias_db), "%.1f", 10 * log10(alias_out / alias_in));
+    /* Half-band taps + branch taps when the rate is halved first */
+    if (rs.decim == 2U)
+        snprintf(taps, sizeof(taps), "%u+%u", (unsigned)MAX30003_RESAMPLE_HB_TAPS, (unsigned)rs.taps);
+    else
+        snprintf(taps, sizeof(taps), "%u", (unsigned)rs.taps);
+    printf("  %6.0f -> %6.0f %4u/%-4u %5s %9.2f %8.1f %10s %9.1f\n", fin, fout, (unsigned)rs.L, (unsigned)rs.M,
+           taps, delay * 1e3, 10 * log10(sig / err), alias_db, ns / produced / 2);
+
+    return produced != expected || 10 * log10(sig / err) < 55 || (alias && 10 * log10(alias_out / alias_in) > -55) ? -1 : 0;
+}
+
+/**
+ * @brief Codec round trip on synthetic ECG in drains of 8 to 31 samples.
+ * @details Size is compared with PACK18 and with 3-byte FIFO words. White
+ *          noise dominates the residual, so it sets the ratio. A final run
+ *          on random codes checks that the PACK18 fallback bounds the block
+ *          size.
+ */
+static int Bench_Codec(uint32_t rate_sps, double noise_uv, int dlpf) {
+    static int32_t ecg[BENCH_CODEC_SECONDS * 512U], dec[BENCH_CODEC_SECONDS * 512U];
+    static uint8_t stream[BENCH_CODEC_SECONDS * 512U * 4U];
+    static uint8_t lens[BENCH_CODEC_SECONDS * 512U];
+    static uint64_t truth[BENCH_QRS_MAX_BEATS];
+    const uint32_t count = BENCH_CODEC_SECONDS * rate_sps;
+    MAX30003_CodecTypeDef enc, dc;
+    uint32_t blocks = 0, bytes = 0, seed = 99, pos = 0;
+    double enc_ns, dec_ns, t0;
+
+    if (noise_uv < 0) {
+        for (uint32_t i = 0; i < count; ++i) {
+            seed = seed * 1664525U + 1013904223U;
+            ecg[i] = (int32_t)seed >> 14;
+        }
+    } else {
+        Bench_SynthECG(ecg, count, rate_sps, noise_uv, truth);
+    }
+    if (dlpf) {
+        /* Stand-in for the on-chip DLPF: the filter bank's low-pass alone */
+        static const MAX30003_FilterConfigTypeDef lp = { 0, 0, 40000 };
+        static MAX30003_FilterBankTypeDef fb;
+        const int32_t *in_p[1] = { ecg };
+        int32_t *out_p[1] = { dec };
+
+        MAX30003_Filter_Init(&fb, 1, rate_sps * 1000U, &lp);
+        MAX30003_Filter_Process(&fb, in_p, out_p, count);
+        for (uint32_t i = 0; i < count; ++i)
+            ecg[i] = MAX30003_FILTER_TO_CODE(dec[i]);
+    }
+
+    MAX30003_Codec_Init(&enc, BENCH_CODEC_KEY);
+    t0 = Bench_Now_ns();
+    for (uint32_t i = 0; i < count; i += lens[blocks++]) {
+        uint32_t n, len;
+
+        seed = seed * 1664525U + 1013904223U;
+        len = 8U + (seed >> 27) * 24U / 32U;
+        lens[blocks] = (uint8_t)(len < count - i ? len : count - i);
+        n = MAX30003_Codec_Encode(&enc, ecg + i, lens[blocks], stream + bytes);
+        if (n > MAX30003_CODEC_MAX_BYTES(lens[blocks])) {
+            fprintf(stderr, "codec block of %u samples took %u bytes\n", (unsigned)lens[blocks], (unsigned)n);
+            return -1;
+        }
+        bytes += n;
+    }
+    enc_ns = (Bench_Now_ns() - t0) / count;
+
+    MAX30003_Codec_Init(&dc, 0);
+    t0 = Bench_Now_ns();
+    for (uint32_t b = 0, i = 0; b < blocks; i += lens[b++]) {
+        uint32_t n = MAX30003_Codec_Decode(&dc, stream + pos, bytes - pos, dec + i, lens[b]);
+
+        if (n == 0) {
+            fprintf(stderr, "codec decode failed at block %u\n", (unsigned)b);
+            return -1;
+        }
+        pos += n;
+    }
+    dec_ns = (Bench_Now_ns() - t0) / count;
+    if (pos != bytes || memcmp(ecg, dec, count * sizeof(int32_t)) != 0) {
+        fprintf(stderr, "codec round trip mismatch\n");
+        return -1;
+    }
+    /* A block cut short must be rejected, not read past its end */
+    MAX30003_Codec_Init(&dc, 0);
+    MAX30003_Codec_Init(&enc, 0);
+    if (MAX30003_Codec_Decode(&dc, stream, MAX30003_Codec_Encode(&enc, ecg, 32, stream) - 1U, dec, 32) != 0) {
+        fprintf(stderr, "codec accepted a truncated block\n");
+        return -1;
+    }
+
+    if (noise_uv < 0)
+        printf("  %-28s", "random 18-bit codes");
+    else
+        printf("  %3u sps, +-%2.0f uV noise, %-4s", (unsigned)rate_sps, noise_uv, dlpf ? "DLPF" : "raw");
+    printf(" %8.2f %9.2f %9.2f %9.1f %9.1f\n", 8.0 * bytes / count, MAX30003_PACK18_BYTES(count) / (double)bytes,
+           3.0 * count / bytes, enc_ns, dec_ns);
+    return 0;
+}
+
+static void Bench_Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [--sclk HZ] [--cs-ns NS] [--seconds S] [--cpu-hz HZ]\n"
+                    "       [--hal-cycles CALL,BYTE,GPIO] [--direct-cycles CALL,BYTE,GPIO]\n", prog);
+}
+
+static int Bench_ParseModel(const char *arg, Bench_CycleModelTypeDef *m) {
+    unsigned call, byte, gpio;
+
+    if (sscanf(arg, "%u,%u,%u", &call, &byte, &gpio) != 3)
+        return -1;
+    m->call = call;
+    m->byte = byte;
+    m->gpio = gpio;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    static const uint8_t efits[] = { 8, 32 };
+    static const int32_t clock_ppm[] = { 0, 100, -250 };
+    static Bench_TypeDef b;
+
+    b.sclk_hz = BENCH_DEFAULT_SCLK_HZ;
+    b.cs_ns = BENCH_DEFAULT_CS_NS;
+    b.seconds = BENCH_DEFAULT_SECONDS;
+    b.cpu_hz = BENCH_DEFAULT_CPU_HZ;
+    b.hal = (Bench_CycleModelTypeDef){ BENCH_HAL_CALL_CYCLES, BENCH_HAL_BYTE_CYCLES, BENCH_HAL_GPIO_CYCLES };
+    b.direct = (Bench_CycleModelTypeDef){ BENCH_DIRECT_CALL_CYCLES, BENCH_DIRECT_BYTE_CYCLES, BENCH_DIRECT_GPIO_CYCLES };
+
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && strcmp(argv[i], "--sclk") == 0)
+            b.sclk_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cs-ns") == 0)
+            b.cs_ns = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--seconds") == 0)
+            b.seconds = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cpu-hz") == 0)
+            b.cpu_hz = (uint32_t)strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--hal-cycles") == 0 && Bench_ParseModel(argv[i + 1], &b.hal) == 0)
+            ++i;
+        else if (i + 1 < argc && strcmp(argv[i], "--direct-cycles") == 0 && Bench_ParseModel(argv[i + 1], &b.direct) == 0)
+            ++i;
+        else {
+            Bench_Usage(argv[0]);
+            return 2;
+        }
+    }
+    if (b.sclk_hz == 0 || b.seconds == 0 || b.cpu_hz == 0) {
+        Bench_Usage(argv[0]);
+        return 2;
+    }
+
+    if (Bench_Operations(&b) != 0)
+        return 1;
+    Bench_PrintCycles(&b);
+#if MAX30003_ENABLE_DMA
+    if (Bench_DMA(&b) != 0)
+        return 1;
+#else
+    printf("Asynchronous FIFO read       skipped (MAX30003_ENABLE_DMA=0)\n\n");
+#endif
+    if (Bench_Decode() != 0)
+        return 1;
+    if (Bench_DriverTime(&b) != 0)
+        return 1;
+    if (Bench_Units() != 0)
+        return 1;
+    if (Bench_Pack() != 0)
+        return 1;
+    if (Bench_Pool(&b) != 0)
+        return 1;
+
+    printf("QRS detector on synthetic ECG (%u s per rate, GAIN 80, +-%u ms match, first %u s excluded)\n",
+           (unsigned)BENCH_QRS_SECONDS, (unsigned)BENCH_QRS_MATCH_MS, (unsigned)BENCH_QRS_SKIP_S);
+    printf("  %9s %6s %6s %6s %6s %4s %8s %8s %8s %6s %6s %10s %10s\n", "rate", "beats", "TP", "FN", "FP", "SB",
+           "Se %", "+P %", "bias ms", "sd ms", "max ms", "ns/smp 32", "ns/smp 1");
+    if (Bench_QRS(128000) != 0 || Bench_QRS(256000) != 0 || Bench_QRS(512000) != 0)
+        return 1;
+    printf("  Cortex-M4 estimate at 512 sps: %u ops/sample (hand count), %.2f%% of a %u Hz core at %u cycles/op\n",
+           (unsigned)BENCH_QRS_OPS_PER_SAMPLE, 100.0 * BENCH_QRS_OPS_PER_SAMPLE * BENCH_QRS_CYCLES_PER_OP * 512 / b.cpu_hz,
+           (unsigned)b.cpu_hz, (unsigned)BENCH_QRS_CYCLES_PER_OP);
+    printf("\n");
+    if (Bench_HRV() != 0)
+        return 1;
+    if (Bench_Lomb() != 0)
+        return 1;
+    if (Bench_Filter() != 0)
+        return 1;
+
+    printf("Polyphase resampler, 10 + 30 Hz tones (%u s per pair, first second excluded)\n",
+           (unsigned)BENCH_RESAMPLE_SECONDS);
+    printf("  %16s %9s %5s %9s %8s %10s %9s\n", "sps", "L/M", "taps", "delay ms", "SNR dB", "alias dB", "ns/out");
+    if (Bench_Resample(512000, 250000) != 0 || Bench_Resample(256000, 250000) != 0 ||
+        Bench_Resample(256000, 125000) != 0 || Bench_Resample(128000, 125000) != 0 ||
+        Bench_Resample(500000, 250000) != 0 || Bench_Resample(512000, 125000) != 0)
+        return 1;
+    printf("\n");
+
+    printf("Lossless codec, %u s per signal, drains of 8-31 samples, key block every %u\n",
+           (unsigned)BENCH_CODEC_SECONDS, (unsigned)BENCH_CODEC_KEY);
+    printf("  %-28s %8s %9s %9s %9s %9s\n", "signal", "bits/smp", "vs PACK18", "vs 24-bit", "enc ns", "dec ns");
+    if (Bench_Codec(512, 30, 0) != 0 || Bench_Codec(512, 30, 1) != 0 || Bench_Codec(256, 30, 1) != 0 ||
+        Bench_Codec(128, 30, 1) != 0 || Bench_Codec(512, 5, 1) != 0 || Bench_Codec(512, -1, 0) != 0)
+        return 1;
+    printf("\n");
+
+    printf("Streaming via MAX30003_IRQHandler, per second (%u s run, INTB polled every %u us)\n",
+           (unsigned)b.seconds, (unsigned)BENCH_POLL_US);
+    printf("  %8s %5s %6s %8s %8s %8s %10s %8s %10s %8s %8s %8s %8s\n", "rate", "EFIT", "read", "IRQ", "CS", "HAL",
+           "bytes", "payload", "bus us", "bus", "HAL cpu", "dir cpu", "dropped");
+    for (size_t i = 0; i < sizeof(efits); ++i) {
+        for (int fixed = 1; fixed >= 0; --fixed) {
+            if (Bench_Streaming(&b, MAX30003_CNFG_ECG_RATE_128, 128, efits[i], fixed) != 0 ||
+                Bench_Streaming(&b, MAX30003_CNFG_ECG_RATE_256, 256, efits[i], fixed) != 0 ||
+                Bench_Streaming(&b, MAX30003_CNFG_ECG_RATE_512, 512, efits[i], fixed) != 0)
+                return 1;
+        }
+    }
+
+    printf("\n");
+    if (Bench_RingFull(&b) != 0)
+        return 1;
+
+    printf("EFIT under service latency ramping %u-%u ms over %u s, per second (%u s run)\n",
+           (unsigned)(BENCH_LATENCY_MIN_US / 1000U), (unsigned)(BENCH_LATENCY_MAX_US / 1000U),
+           (unsigned)(BENCH_LATENCY_PERIOD_US / 1000000U), (unsigned)b.seconds);
+    printf("  %8s %9s %3s %8s %8s %9s %8s %8s %8s\n", "rate", "EFIT", "", "IRQ", "writes", "range", "EOVF", "lost", "est");
+    for (size_t i = 0; i < sizeof(efits); ++i) {
+        if (Bench_Adaptive(&b, MAX30003_CNFG_ECG_RATE_128, 128, efits[i], 0) != 0 ||
+            Bench_Adaptive(&b, MAX30003_CNFG_ECG_RATE_512, 512, efits[i], 0) != 0)
+            return 1;
+    }
+    if (Bench_Adaptive(&b, MAX30003_CNFG_ECG_RATE_128, 128, 8, 1) != 0 ||
+        Bench_Adaptive(&b, MAX30003_CNFG_ECG_RATE_512, 512, 8, 1) != 0)
+        return 1;
+
+    printf("\nTimestamps at 512 sps, EFIT 8, INTB seen within %u us (%u s run, error over the second half)\n",
+           (unsigned)BENCH_TS_POLL_US, (unsigned)BENCH_TS_SECONDS);
+    printf("  %10s %10s %10s %10s %12s\n", "clock", "est ppm", "rms us", "max us", "nominal max");
+    for (size_t i = 0; i < sizeof(clock_ppm) / sizeof(clock_ppm[0]); ++i)
+        if (Bench_Timestamps(&b, clock_ppm[i]) != 0)
+            return 1;
+
+    printf("\nR-to-R events via MAX30003_IRQHandler (%u s, 800+-100 ms RR, handler stalled %u ms at %u s)\n",
+           (unsigned)BENCH_RR_SECONDS, (unsigned)(BENCH_RR_STALL_LEN_US / 1000U), (unsigned)(BENCH_RR_STALL_US / 1000000U));
+    printf("  %10s %8s %8s %8s %10s %12s\n", "clock", "beats", "events", "resyncs", "rr err ms", "idx err smp");
+    for (size_t i = 0; i < sizeof(clock_ppm) / sizeof(clock_ppm[0]); ++i)
+        if (Bench_RR(&b, clock_ppm[i]) != 0)
+            return 1;
+
+    return 0;
+}
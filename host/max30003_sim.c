@@ -0,0 +1,469 @@
+/**
+ ******************************************************************************
+ * @file    max30003_sim.c
+ * @author  Wiktor Chocianowicz
+ * @brief   Register-level MAX30003 simulator for host builds - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "max30003_sim.h"
+
+#define MAX30003_SIM_STATUS_LATCHED  (MAX30003_INT_DCLOFFINT | MAX30003_INT_LONINT | MAX30003_INT_RRINT | MAX30003_INT_SAMP)
+#define MAX30003_SIM_INT_MASK        0xF00F00   /**< STATUS bits routed to INTB/INT2B */
+
+/**
+ * @brief FMSTR frequency in millihertz for the CNFG_GEN FMSTR field.
+ */
+static uint32_t MAX30003_Sim_FMSTR_mHz(const MAX30003_SimTypeDef *sim) {
+    static const uint32_t fmstr_mhz[4] = { 32768000, 32000000, 32000000, 31968780 };
+    return fmstr_mhz[(sim->regs[MAX30003_REG_CNFG_GEN] >> 20) & 0x3];
+}
+
+/**
+ * @brief FMSTR ticks per ECG sample, 0 if the RATE/FMSTR combination is reserved.
+ */
+static uint32_t MAX30003_Sim_SamplePeriodTicks(const MAX30003_SimTypeDef *sim) {
+    uint32_t fmstr = (sim->regs[MAX30003_REG_CNFG_GEN] >> 20) & 0x3;
+    uint32_t rate = (sim->regs[MAX30003_REG_CNFG_ECG] >> 22) & 0x3;
+
+    if (fmstr <= 1) {
+        static const uint32_t ticks[4] = { 64, 128, 256, 0 };
+        return ticks[rate];
+    }
+    return rate == 2 ? 160 : 0;
+}
+
+/**
+ * @brief Default signal: 60 bpm train of 40 ms triangular QRS complexes.
+ */
+static int32_t MAX30003_Sim_DefaultSignal(void *ctx, uint64_t index, uint32_t rate_mhz) {
+    uint32_t period = (rate_mhz + 500) / 1000;
+    uint32_t half = period / 50;
+    uint32_t pos;
+    int32_t dist;
+
+    (void)ctx;
+    if (period == 0 || half == 0)
+        return 0;
+
+    pos = (uint32_t)(index % period);
+    if (pos >= 2 * half)
+        return 0;
+
+    dist = (int32_t)pos - (int32_t)half;
+    if (dist < 0)
+        dist = -dist;
+    return 20000 * ((int32_t)half - dist) / (int32_t)half;
+}
+
+/**
+ * @brief Default beat source: 1000 ms, in step with the default signal.
+ */
+static uint32_t MAX30003_Sim_DefaultRR(void *ctx, uint32_t beat) {
+    (void)ctx;
+    (void)beat;
+    return 1000;
+}
+
+/**
+ * @brief Advance the R-to-R detector by one sample period.
+ * @details R events are placed on sample boundaries; the reported RTOR is
+ *          the scheduled interval, quantized to MAX30003_RTOR_TICKS.
+ */
+static void MAX30003_Sim_StepRTOR(MAX30003_SimTypeDef *sim, uint32_t period) {
+    if (!(sim->regs[MAX30003_REG_CNFG_RTOR1] & MAX30003_CNFG_RTOR_EN_RTOR_EN))
+        return;
+
+    if (sim->rtor_next == 0) {
+        uint64_t ms = sim->rr(sim->rr_ctx, sim->beats);
+
+        sim->rtor_next = (uint32_t)((ms * MAX30003_Sim_FMSTR_mHz(sim) + 128000000ULL) / 256000000ULL);
+        if (sim->rtor_next == 0)
+            sim->rtor_next = 1;
+        if (sim->rtor_next > MAX30003_RTOR_DATA_MASK)
+            sim->rtor_next = MAX30003_RTOR_DATA_MASK;
+    }
+
+    sim->rtor_phase += period;
+    if (sim->rtor_phase < sim->rtor_next * MAX30003_RTOR_TICKS)
+        return;
+
+    sim->rtor_phase -= sim->rtor_next * MAX30003_RTOR_TICKS;
+    sim->regs[MAX30003_FIFO_CMD_RTOR] = sim->rtor_next << MAX30003_RTOR_DATA_SHIFT;
+    sim->regs[MAX30003_REG_STATUS] |= MAX30003_INT_RRINT;
+    sim->beat_index = sim->sample_index;
+    sim->beats++;
+    sim->rtor_next = 0;
+}
+
+/**
+ * @brief Restore power-on register values and empty the FIFO.
+ */
+static void MAX30003_Sim_Reset(MAX30003_SimTypeDef *sim) {
+    memset(sim->regs, 0, sizeof(sim->regs));
+    sim->regs[MAX30003_REG_EN_INT] = MAX30003_EN_INT_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_EN_INT2] = MAX30003_EN_INT_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_MNGR_INT] = MAX30003_MNGR_INT_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_MNGR_DYN] = MAX30003_MNGR_DYN_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_INFO] = MAX30003_SIM_INFO;
+    sim->regs[MAX30003_REG_CNFG_GEN] = MAX30003_CNFG_GEN_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_CNFG_CAL] = MAX30003_CNFG_CAL_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_CNFG_EMUX] = MAX30003_CNFG_EMUX_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_CNFG_ECG] = MAX30003_CNFG_ECG_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_CNFG_RTOR1] = MAX30003_CNFG_RTOR_DEFAULT_CONFIG;
+    sim->regs[MAX30003_REG_CNFG_RTOR2] = MAX30003_CNFG_RTOR2_DEFAULT_CONFIG;
+
+    sim->fifo_head = 0;
+    sim->fifo_count = 0;
+    sim->overflow = false;
+    sim->sample_phase = 0;
+    sim->sample_index = 0;
+    sim->sync_us = sim->last_us;
+    sim->rtor_phase = 0;
+    sim->rtor_next = 0;
+}
+
+/**
+ * @brief Append one generated sample to the FIFO, flagging EOVF when full.
+ */
+static void MAX30003_Sim_PushSample(MAX30003_SimTypeDef *sim) {
+    int32_t code = sim->signal(sim->signal_ctx, sim->sample_index++, MAX30003_Sim_SampleRate_mHz(sim));
+    uint8_t etag = MAX30003_FIFO_ETAG_VALID;
+
+    if (code > 0x1FFFF)
+        code = 0x1FFFF;
+    if (code < -0x20000)
+        code = -0x20000;
+
+    if ((sim->regs[MAX30003_REG_MNGR_DYN] & (0x3 << 22)) == MAX30003_MNGR_DYN_FAST_MANUAL_MODE)
+        etag = MAX30003_FIFO_ETAG_FAST;
+
+    if (sim->overflow || sim->fifo_count == MAX30003_FIFO_LENGTH) {
+        sim->overflow = true;
+        sim->samples_dropped++;
+        return;
+    }
+
+    sim->fifo[(sim->fifo_head + sim->fifo_count) % MAX30003_FIFO_LENGTH] =
+        (((uint32_t)code & MAX30003_ECG_VOLTAGE_DATA_MASK) << MAX30003_ECG_VOLTAGE_DATA_SHIFT) |
+        ((uint32_t)etag << MAX30003_ETAG_SHIFT);
+    sim->fifo_count++;
+}
+
+/**
+ * @brief Pop one FIFO word as seen on the ECG FIFO read-back.
+ */
+static uint32_t MAX30003_Sim_PopSample(MAX30003_SimTypeDef *sim) {
+    uint32_t word;
+    uint8_t etag;
+
+    if (sim->overflow)
+        return (uint32_t)MAX30003_FIFO_ETAG_OVERFLOW << MAX30003_ETAG_SHIFT;
+    if (sim->fifo_count == 0)
+        return (uint32_t)MAX30003_FIFO_ETAG_EMPTY << MAX30003_ETAG_SHIFT;
+
+    word = sim->fifo[sim->fifo_head];
+    sim->fifo_head = (sim->fifo_head + 1) % MAX30003_FIFO_LENGTH;
+    sim->fifo_count--;
+
+    if (sim->fifo_count == 0) {
+        etag = (word >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK;
+        etag = etag == MAX30003_FIFO_ETAG_FAST ? MAX30003_FIFO_ETAG_FAST_EOF : MAX30003_FIFO_ETAG_VALID_EOF;
+        word = (word & ~((uint32_t)MAX30003_ETAG_MASK << MAX30003_ETAG_SHIFT)) |
+               ((uint32_t)etag << MAX30003_ETAG_SHIFT);
+    }
+
+    return word;
+}
+
+/**
+ * @brief Handle a completed register write (32nd SCLK).
+ */
+static void MAX30003_Sim_WriteReg(MAX30003_SimTypeDef *sim, uint8_t reg, uint32_t data) {
+    switch (reg) {
+        case MAX30003_REG_SW_RST:
+            MAX30003_Sim_Reset(sim);
+            break;
+        case MAX30003_REG_SYNCH:
+            sim->fifo_head = 0;
+            sim->fifo_count = 0;
+            sim->overflow = false;
+            sim->sample_phase = 0;
+            sim->sample_index = 0;
+            sim->sync_us = sim->last_us;
+            sim->rtor_phase = 0;
+            sim->rtor_next = 0;
+            break;
+        case MAX30003_REG_FIFO_RST:
+            sim->fifo_head = 0;
+            sim->fifo_count = 0;
+            sim->overflow = false;
+            break;
+        case MAX30003_REG_EN_INT:
+        case MAX30003_REG_EN_INT2:
+        case MAX30003_REG_MNGR_INT:
+        case MAX30003_REG_MNGR_DYN:
+        case MAX30003_REG_CNFG_GEN:
+        case MAX30003_REG_CNFG_CAL:
+        case MAX30003_REG_CNFG_EMUX:
+        case MAX30003_REG_CNFG_ECG:
+        case MAX30003_REG_CNFG_RTOR1:
+        case MAX30003_REG_CNFG_RTOR2:
+            sim->regs[reg] = data & 0xFFFFFF;
+            break;
+        default:
+            /* Read-only or reserved: ignored */
+            break;
+    }
+}
+
+/**
+ * @brief Load the next 24-bit word to shift out for a read command.
+ */
+static uint32_t MAX30003_Sim_ReadWord(MAX30003_SimTypeDef *sim, uint8_t reg) {
+    switch (reg) {
+        case MAX30003_REG_STATUS:
+            return MAX30003_Sim_GetStatus(sim);
+        case MAX30003_FIFO_CMD_ECG_BURST:
+        case MAX30003_FIFO_CMD_ECG:
+            return MAX30003_Sim_PopSample(sim);
+        default:
+            return sim->regs[reg & (MAX30003_SIM_REG_COUNT - 1)];
+    }
+}
+
+static void MAX30003_Sim_Select(void *ctx, bool selected) {
+    MAX30003_SimTypeDef *sim = (MAX30003_SimTypeDef *)ctx;
+
+    MAX30003_Sim_Update(sim);
+    sim->byte_index = 0;
+    (void)selected;
+}
+
+static uint8_t MAX30003_Sim_Exchange(void *ctx, uint8_t mosi) {
+    MAX30003_SimTypeDef *sim = (MAX30003_SimTypeDef *)ctx;
+    uint16_t idx = sim->byte_index++;
+    uint8_t reg = sim->cmd >> 1;
+    bool read = sim->cmd & 0x01;
+    uint8_t miso = 0x00;
+
+    if (idx == 0) {
+        sim->cmd = mosi;
+        sim->shift = 0;
+        return 0x00;
+    }
+
+    if (read) {
+        uint16_t pos = (idx - 1) % MAX30003_FIFO_WORD_SIZE;
+
+        if (pos == 0) {
+            if (idx == 1 || reg == MAX30003_FIFO_CMD_ECG_BURST)
+                sim->shift = MAX30003_Sim_ReadWord(sim, reg);
+            else
+                sim->shift = 0;
+        }
+
+        miso = (sim->shift >> (8 * (2 - pos))) & 0xFF;
+
+        /* STATUS latched bits clear on the 32nd SCLK; RRINT per CLR_RRINT */
+        if (idx == 3 && reg == MAX30003_REG_STATUS) {
+            uint32_t clear = MAX30003_SIM_STATUS_LATCHED;
+
+            if (sim->regs[MAX30003_REG_MNGR_INT] & (MAX30003_MNGR_INT_CLR_RRINT_MASK << MAX30003_MNGR_INT_CLR_RRINT_SHIFT))
+                clear &= ~MAX30003_INT_RRINT;
+            sim->regs[MAX30003_REG_STATUS] &= ~clear;
+        }
+        if (idx == 3 && reg == MAX30003_FIFO_CMD_RTOR &&
+            (sim->regs[MAX30003_REG_MNGR_INT] & (MAX30003_MNGR_INT_CLR_RRINT_MASK << MAX30003_MNGR_INT_CLR_RRINT_SHIFT))
+                == MAX30003_MNGR_INT_CLR_RRINT_ON_RTOR_REGISTER_READ_BACK)
+            sim->regs[MAX30003_REG_STATUS] &= ~MAX30003_INT_RRINT;
+    } else if (idx <= 3) {
+        sim->shift = (sim->shift << 8) | mosi;
+        if (idx == 3)
+            MAX30003_Sim_WriteReg(sim, reg, sim->shift);
+    }
+
+    return miso;
+}
+
+/**
+ * @brief Initialize simulator state to power-on defaults.
+ * @param sim Simulator instance.
+ */
+void MAX30003_Sim_Init(MAX30003_SimTypeDef *sim) {
+    memset(sim, 0, sizeof(*sim));
+    sim->dev.select = MAX30003_Sim_Select;
+    sim->dev.exchange = MAX30003_Sim_Exchange;
+    sim->dev.ctx = sim;
+    sim->signal = MAX30003_Sim_DefaultSignal;
+    sim->rr = MAX30003_Sim_DefaultRR;
+    sim->last_us = HAL_Host_GetMicros();
+    MAX30003_Sim_Reset(sim);
+}
+
+/**
+ * @brief Attach the simulator to a host SPI bus.
+ * @param sim Simulator instance.
+ * @param hspi SPI handle later passed to MAX30003_Init.
+ * @param cs_port CS GPIO port later passed to MAX30003_Init.
+ * @param cs_pin CS GPIO pin later passed to MAX30003_Init.
+ * @return HAL_OK on success.
+ */
+HAL_StatusTypeDef MAX30003_Sim_Attach(MAX30003_SimTypeDef *sim,
+                                      SPI_HandleTypeDef *hspi,
+                                      GPIO_TypeDef *cs_port,
+                                      uint16_t cs_pin) {
+    return HAL_Host_AttachSPIDevice(hspi, cs_port, cs_pin, &sim->dev);
+}
+
+/**
+ * @brief Replace the sample source.
+ * @param sim Simulator instance.
+ * @param signal Sample source, NULL restores the default.
+ * @param ctx Context handed to signal.
+ */
+void MAX30003_Sim_SetSignal(MAX30003_SimTypeDef *sim,
+                            MAX30003_SimSignalTypeDef signal, void *ctx) {
+    sim->signal = signal != NULL ? signal : MAX30003_Sim_DefaultSignal;
+    sim->signal_ctx = ctx;
+}
+
+/**
+ * @brief Replace the beat source of the R-to-R detector.
+ * @details Only the interval after the current one is affected. R events are
+ *          reported while EN_RTOR and EN_ECG are set.
+ * @param sim Simulator instance.
+ * @param rr Beat source, NULL restores the default.
+ * @param ctx Context handed to rr.
+ */
+void MAX30003_Sim_SetRR(MAX30003_SimTypeDef *sim,
+                        MAX30003_SimRRTypeDef rr, void *ctx) {
+    sim->rr = rr != NULL ? rr : MAX30003_Sim_DefaultRR;
+    sim->rr_ctx = ctx;
+}
+
+/**
+ * @brief Make the simulated FMSTR clock run fast or slow.
+ * @details Models crystal tolerance: the device produces samples at the
+ *          nominal rate scaled by (1 + ppm / 10^6) in host time.
+ * @param sim Simulator instance.
+ * @param ppm Clock error in parts per million, positive = fast.
+ */
+void MAX30003_Sim_SetClockError(MAX30003_SimTypeDef *sim, int32_t ppm) {
+    MAX30003_Sim_Update(sim);
+    sim->clock_ppm = ppm;
+}
+
+/**
+ * @brief Bring the simulator up to the current virtual time.
+ * @details Generates every sample due since the last update. Called
+ *          automatically on CS edges and status queries.
+ * @param sim Simulator instance.
+ */
+void MAX30003_Sim_Update(MAX30003_SimTypeDef *sim) {
+    uint64_t now = HAL_Host_GetMicros();
+    uint64_t elapsed = now - sim->last_us;
+    uint32_t period = MAX30003_Sim_SamplePeriodTicks(sim);
+    uint64_t ticks;
+
+    sim->last_us = now;
+    sim->tick_frac += elapsed * (uint64_t)((int64_t)MAX30003_Sim_FMSTR_mHz(sim)
+        + (int64_t)MAX30003_Sim_FMSTR_mHz(sim) * sim->clock_ppm / 1000000);
+    ticks = sim->tick_frac / 1000000000ULL;
+    sim->tick_frac %= 1000000000ULL;
+
+    if (!(sim->regs[MAX30003_REG_CNFG_GEN] & MAX30003_CNFG_GEN_EN_ECG_EN) || period == 0)
+        return;
+
+    while (ticks > 0) {
+        uint64_t step = period - sim->sample_phase;
+
+        if (ticks < step) {
+            sim->sample_phase += (uint32_t)ticks;
+            break;
+        }
+        ticks -= step;
+        sim->sample_phase = 0;
+        MAX30003_Sim_PushSample(sim);
+        MAX30003_Sim_StepRTOR(sim, period);
+    }
+}
+
+/**
+ * @brief Current STATUS register value.
+ * @param sim Simulator instance.
+ * @return 24-bit STATUS value.
+ */
+uint32_t MAX30003_Sim_GetStatus(MAX30003_SimTypeDef *sim) {
+    uint32_t efit = ((sim->regs[MAX30003_REG_MNGR_INT] >> 19) & 0x1F) + 1;
+    uint32_t status = sim->regs[MAX30003_REG_STATUS] & MAX30003_SIM_STATUS_LATCHED;
+
+    if (sim->fifo_count >= efit)
+        status |= MAX30003_INT_EINT;
+    if (sim->overflow)
+        status |= MAX30003_INT_EOVF;
+    if ((sim->regs[MAX30003_REG_MNGR_DYN] & (0x3 << 22)) == MAX30003_MNGR_DYN_FAST_MANUAL_MODE)
+        status |= MAX30003_INT_FSTINT;
+
+    return status;
+}
+
+/**
+ * @brief Level of the INTB pin (true = asserted).
+ * @param sim Simulator instance.
+ */
+bool MAX30003_Sim_INTB(MAX30003_SimTypeDef *sim) {
+    MAX30003_Sim_Update(sim);
+    return (MAX30003_Sim_GetStatus(sim) & sim->regs[MAX30003_REG_EN_INT] & MAX30003_SIM_INT_MASK) != 0;
+}
+
+/**
+ * @brief Level of the INT2B pin (true = asserted).
+ * @param sim Simulator instance.
+ */
+bool MAX30003_Sim_INT2B(MAX30003_SimTypeDef *sim) {
+    MAX30003_Sim_Update(sim);
+    return (MAX30003_Sim_GetStatus(sim) & sim->regs[MAX30003_REG_EN_INT2] & MAX30003_SIM_INT_MASK) != 0;
+}
+
+/**
+ * @brief Number of unread FIFO words.
+ * @param sim Simulator instance.
+ */
+uint8_t MAX30003_Sim_FIFOCount(MAX30003_SimTypeDef *sim) {
+    MAX30003_Sim_Update(sim);
+    return sim->fifo_count;
+}
+
+/**
+ * @brief Configured ECG sample rate.
+ * @param sim Simulator instance.
+ * @return Sample rate in millihertz, 0 if the configuration is reserved.
+ */
+uint32_t MAX30003_Sim_SampleRate_mHz(const MAX30003_SimTypeDef *sim) {
+    uint32_t period = MAX30003_Sim_SamplePeriodTicks(sim);
+    return period != 0 ? MAX30003_Sim_FMSTR_mHz(sim) / period : 0;
+}
@@ -0,0 +1,131 @@
+/**
+ ******************************************************************************
+ * @file    max30003_sim.h
+ * @author  Wiktor Chocianowicz
+ * @brief   Register-level MAX30003 simulator for host builds - Header file
+ *
+ * @note    Emulates the SPI register map, STATUS/EN_INT interrupt logic, the
+ *          32-word ECG FIFO filled at the configured RATE, ETAG codes and EOVF.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef HOST_MAX30003_SIM_H_
+#define HOST_MAX30003_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "max30003.h"
+
+#define MAX30003_SIM_REG_COUNT      0x80        /**< Size of the simulated register space */
+#define MAX30003_SIM_INFO           0x500000    /**< INFO register read-back value */
+
+/**
+ * @brief Signal source for simulated ECG samples
+ * @param ctx User context.
+ * @param index Monotonic sample index since the last SW_RST/SYNCH.
+ * @param rate_mhz Current sample rate in millihertz.
+ * @return Signed ECG code, clipped to 18 bits by the simulator.
+ */
+typedef int32_t (*MAX30003_SimSignalTypeDef)(void *ctx, uint64_t index, uint32_t rate_mhz);
+
+/**
+ * @brief Beat source for the simulated R-to-R detector
+ * @param ctx User context.
+ * @param beat Beat number since MAX30003_Sim_Init.
+ * @return Interval to the next R event in milliseconds.
+ */
+typedef uint32_t (*MAX30003_SimRRTypeDef)(void *ctx, uint32_t beat);
+
+/**
+ * @brief Simulated MAX30003 device
+ */
+typedef struct {
+    HOST_SPI_DeviceTypeDef dev;                 /**< Bus attachment */
+    uint32_t regs[MAX30003_SIM_REG_COUNT];      /**< Register contents */
+
+    uint32_t fifo[MAX30003_FIFO_LENGTH];        /**< FIFO words (ETAG VALID/FAST) */
+    uint8_t fifo_head;                          /**< Oldest entry */
+    uint8_t fifo_count;                         /**< Unread entries */
+    bool overflow;                              /**< EOVF latched until FIFO_RST/SYNCH */
+
+    uint8_t cmd;                                /**< Command byte of current transaction */
+    uint16_t byte_index;                        /**< Bytes clocked since CS assertion */
+    uint32_t shift;                             /**< Current 24-bit word being shifted */
+
+    uint64_t last_us;                           /**< Virtual time of last update */
+    uint64_t tick_frac;                         /**< FMSTR tick remainder (mHz*us) */
+    int32_t clock_ppm;                          /**< FMSTR error against the host clock, ppm */
+    uint64_t sync_us;                           /**< Virtual time of the last SYNCH/SW_RST */
+    uint32_t sample_phase;                      /**< FMSTR ticks since last sample */
+    uint64_t sample_index;                      /**< Samples generated since SW_RST/SYNCH */
+    uint64_t samples_dropped;                   /**< Samples lost to FIFO overflow */
+
+    MAX30003_SimSignalTypeDef signal;           /**< Sample source */
+    void *signal_ctx;                           /**< Sample source context */
+
+    uint32_t rtor_phase;                        /**< FMSTR ticks since the last R event */
+    uint32_t rtor_next;                         /**< RTOR count of the interval in progress, 0 = not scheduled */
+    uint32_t beats;                             /**< R events reported */
+    uint64_t beat_index;                        /**< sample_index of the last R event */
+    MAX30003_SimRRTypeDef rr;                   /**< Beat source */
+    void *rr_ctx;                               /**< Beat source context */
+} MAX30003_SimTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Sim_Init(MAX30003_SimTypeDef *sim);
+
+HAL_StatusTypeDef MAX30003_Sim_Attach(MAX30003_SimTypeDef *sim,
+                                      SPI_HandleTypeDef *hspi,
+                                      GPIO_TypeDef *cs_port,
+                                      uint16_t cs_pin);
+
+void MAX30003_Sim_SetSignal(MAX30003_SimTypeDef *sim,
+                            MAX30003_SimSignalTypeDef signal, void *ctx);
+
+void MAX30003_Sim_SetRR(MAX30003_SimTypeDef *sim,
+                        MAX30003_SimRRTypeDef rr, void *ctx);
+
+void MAX30003_Sim_SetClockError(MAX30003_SimTypeDef *sim, int32_t ppm);
+
+void MAX30003_Sim_Update(MAX30003_SimTypeDef *sim);
+
+uint32_t MAX30003_Sim_GetStatus(MAX30003_SimTypeDef *sim);
+
+bool MAX30003_Sim_INTB(MAX30003_SimTypeDef *sim);
+
+bool MAX30003_Sim_INT2B(MAX30003_SimTypeDef *sim);
+
+uint8_t MAX30003_Sim_FIFOCount(MAX30003_SimTypeDef *sim);
+
+uint32_t MAX30003_Sim_SampleRate_mHz(const MAX30003_SimTypeDef *sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_MAX30003_SIM_H_ */
@@ -0,0 +1,107 @@
+/**
+ ******************************************************************************
+ * @file    max30003_transport_sim.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 driver transport wired straight to the host simulator
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_transport_sim.h"
+
+static HAL_StatusTypeDef MAX30003_SimT_Transfer(MAX30003_HandleTypeDef *hmax,
+                                                const uint8_t *tx, uint8_t *rx, uint16_t size) {
+    MAX30003_SimTypeDef *sim = (MAX30003_SimTypeDef *)hmax->transport_ctx;
+
+    if (!sim->dev.selected)
+        return HAL_ERROR;
+
+    sim->dev.transfers++;
+    for (uint16_t i = 0; i < size; ++i) {
+        uint8_t miso;
+
+        sim->dev.bytes++;
+        miso = sim->dev.exchange(sim->dev.ctx, tx[i]);
+        if (rx != NULL)
+            rx[i] = miso;
+    }
+
+    return HAL_OK;
+}
+
+#if MAX30003_ENABLE_DMA
+static HAL_StatusTypeDef MAX30003_SimT_TransferAsync(MAX30003_HandleTypeDef *hmax,
+                                                     const uint8_t *tx, uint8_t *rx, uint16_t size) {
+    HAL_StatusTypeDef status = MAX30003_SimT_Transfer(hmax, tx, rx, size);
+
+    /* Completes immediately, as the host HAL DMA does */
+    MAX30003_TransferCpltCallback(hmax, status);
+    return HAL_OK;
+}
+#else
+#define MAX30003_SimT_TransferAsync NULL
+#endif
+
+static void MAX30003_SimT_CSAssert(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_SimTypeDef *sim = (MAX30003_SimTypeDef *)hmax->transport_ctx;
+
+    if (sim->dev.selected)
+        return;
+    sim->dev.selected = true;
+    sim->dev.cs_assertions++;
+    sim->dev.select(sim->dev.ctx, true);
+}
+
+static void MAX30003_SimT_CSRelease(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_SimTypeDef *sim = (MAX30003_SimTypeDef *)hmax->transport_ctx;
+
+    if (!sim->dev.selected)
+        return;
+    sim->dev.selected = false;
+    sim->dev.select(sim->dev.ctx, false);
+}
+
+/**
+ * @brief Host simulator transport operations
+ */
+const MAX30003_TransportTypeDef MAX30003_Sim_Transport = {
+    .transfer = MAX30003_SimT_Transfer,
+    .transfer_async = MAX30003_SimT_TransferAsync,
+    .cs_assert = MAX30003_SimT_CSAssert,
+    .cs_release = MAX30003_SimT_CSRelease,
+};
+
+/**
+ * @brief Initialize MAX30003 handle directly on a simulator instance.
+ * @param hmax Pointer to device handle.
+ * @param sim Initialized simulator (need not be attached to a host SPI bus).
+ * @return HAL_OK if successful, HAL_ERROR otherwise.
+ */
+HAL_StatusTypeDef MAX30003_InitSim(MAX30003_HandleTypeDef *hmax,
+                                   MAX30003_SimTypeDef *sim) {
+    if (sim == NULL)
+        return HAL_ERROR;
+
+    return MAX30003_InitTransport(hmax, &MAX30003_Sim_Transport, sim);
+}
@@ -0,0 +1,52 @@
+/**
+ ******************************************************************************
+ * @file    max30003_transport_sim.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 driver transport wired straight to the host simulator
+ *
+ * @note    Bypasses the stand-in HAL so driver logic can be measured on its own.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef HOST_MAX30003_TRANSPORT_SIM_H_
+#define HOST_MAX30003_TRANSPORT_SIM_H_
+
+#include "max30003.h"
+#include "max30003_sim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const MAX30003_TransportTypeDef MAX30003_Sim_Transport;
+
+HAL_StatusTypeDef MAX30003_InitSim(MAX30003_HandleTypeDef *hmax,
+                                   MAX30003_SimTypeDef *sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_MAX30003_TRANSPORT_SIM_H_ */
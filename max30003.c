@@ -30,6 +30,8 @@
  ******************************************************************************
  */
 
+#include <stddef.h>
+#include <string.h>
 #include "max30003.h"
 
 /**
@@ -51,43 +53,164 @@ uint32_t MAX30003_ExtractECGData(uint32_t fifo_data) {
 }
 
 /**
- * @brief Initialize MAX30003 communication handle.
+ * @brief Unpack big-endian FIFO words as clocked out of the device.
+ * @param rx Received bytes, MAX30003_FIFO_WORD_SIZE per word.
+ * @param fifo_data Output buffer for FIFO words.
+ * @param count Number of words to unpack.
+ */
+static void MAX30003_UnpackFIFO(const uint8_t *rx, uint32_t *fifo_data, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i, rx += MAX30003_FIFO_WORD_SIZE) {
+        fifo_data[i] = ((uint32_t)rx[0] << 16) |
+                    ((uint32_t)rx[1] << 8) |
+                    rx[2];
+    }
+}
+
+/**
+ * @brief Register address and power-on value of each shadow slot.
+ */
+static const struct {
+    uint8_t reg;
+    uint32_t reset;
+} MAX30003_ShadowMap[MAX30003_SHADOW_COUNT] = {
+    [MAX30003_SHADOW_EN_INT]     = { MAX30003_REG_EN_INT,     MAX30003_EN_INT_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_EN_INT2]    = { MAX30003_REG_EN_INT2,    MAX30003_EN_INT_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_MNGR_INT]   = { MAX30003_REG_MNGR_INT,   MAX30003_MNGR_INT_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_MNGR_DYN]   = { MAX30003_REG_MNGR_DYN,   MAX30003_MNGR_DYN_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_GEN]   = { MAX30003_REG_CNFG_GEN,   MAX30003_CNFG_GEN_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_CAL]   = { MAX30003_REG_CNFG_CAL,   MAX30003_CNFG_CAL_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_EMUX]  = { MAX30003_REG_CNFG_EMUX,  MAX30003_CNFG_EMUX_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_ECG]   = { MAX30003_REG_CNFG_ECG,   MAX30003_CNFG_ECG_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_RTOR1] = { MAX30003_REG_CNFG_RTOR1, MAX30003_CNFG_RTOR_DEFAULT_CONFIG },
+    [MAX30003_SHADOW_CNFG_RTOR2] = { MAX30003_REG_CNFG_RTOR2, MAX30003_CNFG_RTOR2_DEFAULT_CONFIG },
+};
+
+/**
+ * @brief Offset of each shadow slot's field in MAX30003_ConfigTypeDef.
+ */
+static const uint8_t MAX30003_ConfigOffset[MAX30003_SHADOW_COUNT] = {
+    [MAX30003_SHADOW_EN_INT]     = offsetof(MAX30003_ConfigTypeDef, en_int),
+    [MAX30003_SHADOW_EN_INT2]    = offsetof(MAX30003_ConfigTypeDef, en_int2),
+    [MAX30003_SHADOW_MNGR_INT]   = offsetof(MAX30003_ConfigTypeDef, mngr_int),
+    [MAX30003_SHADOW_MNGR_DYN]   = offsetof(MAX30003_ConfigTypeDef, mngr_dyn),
+    [MAX30003_SHADOW_CNFG_GEN]   = offsetof(MAX30003_ConfigTypeDef, cnfg_gen),
+    [MAX30003_SHADOW_CNFG_CAL]   = offsetof(MAX30003_ConfigTypeDef, cnfg_cal),
+    [MAX30003_SHADOW_CNFG_EMUX]  = offsetof(MAX30003_ConfigTypeDef, cnfg_emux),
+    [MAX30003_SHADOW_CNFG_ECG]   = offsetof(MAX30003_ConfigTypeDef, cnfg_ecg),
+    [MAX30003_SHADOW_CNFG_RTOR1] = offsetof(MAX30003_ConfigTypeDef, cnfg_rtor1),
+    [MAX30003_SHADOW_CNFG_RTOR2] = offsetof(MAX30003_ConfigTypeDef, cnfg_rtor2),
+};
+
+/**
+ * @brief Map a register address to its shadow slot.
+ * @param reg Register address.
+ * @return MAX30003_SHADOW_x slot, or -1 if the register is not shadowed.
+ */
+static int MAX30003_ShadowIndex(uint8_t reg) {
+    for (int i = 0; i < MAX30003_SHADOW_COUNT; ++i)
+        if (MAX30003_ShadowMap[i].reg == reg)
+            return i;
+    return -1;
+}
+
+/**
+ * @brief Update register shadows after a successful read or write.
+ * @param hmax Device handle.
+ * @param reg Register address.
+ * @param data Register value now held by the device.
+ */
+static void MAX30003_UpdateShadow(MAX30003_HandleTypeDef *hmax, uint8_t reg, uint32_t data) {
+    int idx;
+
+    if (reg == MAX30003_REG_SW_RST) {
+        for (int i = 0; i < MAX30003_SHADOW_COUNT; ++i)
+            hmax->shadow[i] = MAX30003_ShadowMap[i].reset;
+        hmax->shadow_valid = MAX30003_SHADOW_ALL;
+        return;
+    }
+
+    if ((idx = MAX30003_ShadowIndex(reg)) < 0)
+        return;
+
+    hmax->shadow[idx] = data & 0xFFFFFF;
+    hmax->shadow_valid |= 1U << idx;
+}
+
+/**
+ * @brief Anchor overflow accounting at the current time and sample index.
+ * @details Called whenever the device sample stream restarts (SYNCH,
+ *          FIFO_RST, SW_RST) so later gap estimates measure from there.
+ */
+static void MAX30003_MarkSync(MAX30003_HandleTypeDef *hmax) {
+    hmax->sync_index = hmax->sample_index;
+    hmax->sync_tick = HAL_GetTick();
+}
+
+/**
+ * @brief Advance the sample index by the data words in a block.
+ * @details Counts the words that pass MAX30003_ETAG_IS_SAMPLE(), as
+ *          MAX30003_Ring_PushFIFO() stores them.
+ */
+static void MAX30003_CountSamples(MAX30003_HandleTypeDef *hmax, const uint32_t *fifo_data, uint8_t count) {
+    for (uint8_t i = 0; i < count; ++i)
+        if (MAX30003_ETAG_IS_SAMPLE(MAX30003_ExtractETag(fifo_data[i])))
+            hmax->sample_index++;
+}
+
+/**
+ * @brief Initialize MAX30003 handle on an arbitrary transport.
  * @param hmax Pointer to device handle.
- * @param hspi SPI handle.
- * @param cs_port GPIO port for CS pin.
- * @param cs_pin GPIO pin for CS.
+ * @param transport Transport operations (see MAX30003_TransportTypeDef).
+ * @param ctx Transport context, available to the backend as hmax->transport_ctx.
  * @return HAL_OK if successful, HAL_ERROR otherwise.
  */
-HAL_StatusTypeDef MAX30003_Init(MAX30003_HandleTypeDef *hmax,
-                                SPI_HandleTypeDef *hspi,
-                                GPIO_TypeDef *cs_port,
-                                uint16_t cs_pin) {
-    if (hspi == NULL)
+HAL_StatusTypeDef MAX30003_InitTransport(MAX30003_HandleTypeDef *hmax,
+                                         const MAX30003_TransportTypeDef *transport,
+                                         void *ctx) {
+    if (transport == NULL || transport->transfer == NULL ||
+        transport->cs_assert == NULL || transport->cs_release == NULL)
         return HAL_ERROR;
 
-    hmax->hspi = hspi;
-    hmax->cs_port = cs_port;
-    hmax->cs_pin = cs_pin;
+    hmax->transport = transport;
+    hmax->transport_ctx = ctx;
+    for (int i = 0; i < MAX30003_SHADOW_COUNT; ++i)
+        hmax->shadow[i] = MAX30003_ShadowMap[i].reset;
+    hmax->shadow_valid = 0;
+#if MAX30003_ENABLE_DMA
+    hmax->dma_busy = 0;
+    hmax->dma_count = 0;
+    hmax->dma_callback = NULL;
+    memset(hmax->dma_tx, 0, sizeof(hmax->dma_tx));
+#endif
+    hmax->sample_index = 0;
+    hmax->samples_dropped = 0;
+    hmax->overflows = 0;
+    MAX30003_MarkSync(hmax);
 
-    HAL_GPIO_WritePin(cs_port, cs_pin, GPIO_PIN_SET);
+    hmax->transport->cs_release(hmax);
     return HAL_OK;
 }
 
 /**
- * @brief Perform SPI transmit/receive operation.
+ * @brief Perform a full-duplex transfer within one chip-select cycle.
  * @param hmax Device handle.
  * @param tx_data Pointer to data to transmit.
- * @param rx_data Pointer to buffer for received data.
+ * @param rx_data Pointer to buffer for received data, may be NULL.
  * @param size Number of bytes to exchange.
  * @return HAL_OK on success.
  */
 static HAL_StatusTypeDef MAX30003_SPI_TransmitReceive(MAX30003_HandleTypeDef *hmax,
-                                                    uint8_t *tx_data,
+                                                    const uint8_t *tx_data,
                                                     uint8_t *rx_data,
                                                     uint16_t size) {
-    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_RESET);
-    HAL_StatusTypeDef status = HAL_SPI_TransmitReceive(hmax->hspi, tx_data, rx_data, size, MAX30003_SPI_TIMEOUT);
-    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_SET);
+#if MAX30003_ENABLE_DMA
+    if (hmax->dma_busy)
+        return HAL_BUSY;
+#endif
+
+    hmax->transport->cs_assert(hmax);
+    HAL_StatusTypeDef status = hmax->transport->transfer(hmax, tx_data, rx_data, size);
+    hmax->transport->cs_release(hmax);
     return status;
 }
 
@@ -109,6 +232,7 @@ HAL_StatusTypeDef MAX30003_ReadReg(MAX30003_HandleTypeDef *hmax,
         *data = ((uint32_t)rx_buf[1] << 16) |
                 ((uint32_t)rx_buf[2] << 8) |
                 rx_buf[3];
+        MAX30003_UpdateShadow(hmax, reg, *data);
     }
 
     return status;
@@ -130,41 +254,529 @@ HAL_StatusTypeDef MAX30003_WriteReg(MAX30003_HandleTypeDef *hmax,
         data & 0xFF
     };
 
-    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_RESET);
-    HAL_StatusTypeDef status = HAL_SPI_Transmit(hmax->hspi, tx_buf, 4, MAX30003_SPI_TIMEOUT);
-    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_SET);
+    HAL_StatusTypeDef status = MAX30003_SPI_TransmitReceive(hmax, tx_buf, NULL, 4);
+
+    if (status == HAL_OK) {
+        MAX30003_UpdateShadow(hmax, reg, data);
+        if (reg == MAX30003_REG_SYNCH || reg == MAX30003_REG_FIFO_RST || reg == MAX30003_REG_SW_RST)
+            MAX30003_MarkSync(hmax);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Master clock and sample period configured in the CNFG_GEN and
+ *        CNFG_ECG shadows.
+ * @param hmax Device handle.
+ * @param fmstr_mHz Output, FMSTR frequency in millihertz (may be NULL).
+ * @param ticks Output, FMSTR cycles per ECG sample, 0 if reserved (may be NULL).
+ * @return HAL_OK, HAL_ERROR for a reserved FMSTR/RATE combination (fmstr_mHz
+ *         is still valid), or the status of a shadow refresh.
+ */
+HAL_StatusTypeDef MAX30003_GetTimebase(MAX30003_HandleTypeDef *hmax,
+                                       uint32_t *fmstr_mHz, uint32_t *ticks) {
+    static const uint32_t fmstr_table_mHz[4] = { 32768000, 32000000, 32000000, 31968780 };
+    HAL_StatusTypeDef status;
+    uint32_t cnfg_gen, cnfg_ecg, fmstr, rate, period;
+
+    if ((status = MAX30003_GetShadow(hmax, MAX30003_REG_CNFG_GEN, &cnfg_gen)) != HAL_OK ||
+        (status = MAX30003_GetShadow(hmax, MAX30003_REG_CNFG_ECG, &cnfg_ecg)) != HAL_OK)
+        return status;
+
+    fmstr = (cnfg_gen >> MAX30003_CNFG_GEN_FMSTR_SHIFT) & MAX30003_CNFG_GEN_FMSTR_MASK;
+    rate = (cnfg_ecg >> MAX30003_CNFG_ECG_RATE_SHIFT) & MAX30003_CNFG_ECG_RATE_MASK;
+
+    /* FMSTR ticks per sample; FMSTR 10/11 only support RATE 10 */
+    if (fmstr <= 1)
+        period = rate == 0 ? 64 : rate == 1 ? 128 : rate == 2 ? 256 : 0;
+    else
+        period = rate == 2 ? 160 : 0;
+
+    if (fmstr_mHz != NULL)
+        *fmstr_mHz = fmstr_table_mHz[fmstr];
+    if (ticks != NULL)
+        *ticks = period;
+    return period != 0 ? HAL_OK : HAL_ERROR;
+}
+
+/**
+ * @brief ECG sample rate configured in the CNFG_GEN and CNFG_ECG shadows.
+ * @param hmax Device handle.
+ * @param rate_mHz Output, sample rate in millihertz (0 if reserved).
+ * @return HAL_OK, HAL_ERROR for a reserved FMSTR/RATE combination, or the
+ *         status of a shadow refresh.
+ */
+HAL_StatusTypeDef MAX30003_GetSampleRate_mHz(MAX30003_HandleTypeDef *hmax,
+                                             uint32_t *rate_mHz) {
+    HAL_StatusTypeDef status;
+    uint32_t fmstr_mHz, ticks;
+
+    *rate_mHz = 0;
+    if ((status = MAX30003_GetTimebase(hmax, &fmstr_mHz, &ticks)) != HAL_OK)
+        return status;
+
+    *rate_mHz = (fmstr_mHz + ticks / 2) / ticks;
+    return HAL_OK;
+}
+
+/**
+ * @brief Index the device is currently writing, from elapsed MCU time.
+ * @details sync_index plus the samples the configured rate produces in the
+ *          HAL_GetTick() time since the last SYNCH/FIFO_RST/SW_RST. Good to
+ *          one tick plus the FMSTR/MCU clock error accumulated since then.
+ * @param hmax Device handle.
+ * @param index Output, estimated sample index.
+ * @return HAL status of the sample rate lookup.
+ */
+HAL_StatusTypeDef MAX30003_EstimateSampleIndex(MAX30003_HandleTypeDef *hmax,
+                                               uint64_t *index) {
+    HAL_StatusTypeDef status;
+    uint32_t rate_mHz;
+
+    if ((status = MAX30003_GetSampleRate_mHz(hmax, &rate_mHz)) != HAL_OK)
+        return status;
+
+    *index = hmax->sync_index
+        + ((uint64_t)(HAL_GetTick() - hmax->sync_tick) * rate_mHz + 500000U) / 1000000U;
+    return HAL_OK;
+}
+
+/**
+ * @brief Read the last R-to-R interval.
+ * @details RTOR counts in units of MAX30003_RTOR_TICKS FMSTR cycles
+ *          (7.8125 ms at 32768 Hz, 8 ms at 32000 Hz); the millisecond value
+ *          uses the FMSTR frequency in the CNFG_GEN shadow.
+ * @param hmax Device handle.
+ * @param rtor Output, raw 14-bit interval (may be NULL).
+ * @param rr_ms Output, interval in milliseconds, rounded (may be NULL).
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_ReadRTOR(MAX30003_HandleTypeDef *hmax,
+                                    uint16_t *rtor, uint32_t *rr_ms) {
+    HAL_StatusTypeDef status;
+    uint32_t data, fmstr_mHz, count;
+
+    if ((status = MAX30003_ReadReg(hmax, MAX30003_FIFO_CMD_RTOR, &data)) != HAL_OK)
+        return status;
+
+    count = (data >> MAX30003_RTOR_DATA_SHIFT) & MAX30003_RTOR_DATA_MASK;
+    if (rtor != NULL)
+        *rtor = (uint16_t)count;
+    if (rr_ms != NULL) {
+        /* Only FMSTR is needed, a reserved RATE does not matter here */
+        fmstr_mHz = 0;
+        status = MAX30003_GetTimebase(hmax, &fmstr_mHz, NULL);
+        if (fmstr_mHz == 0)
+            return status;
+        *rr_ms = (uint32_t)(((uint64_t)count * MAX30003_RTOR_TICKS * 1000000U + fmstr_mHz / 2) / fmstr_mHz);
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief Reset the FIFO after EOVF and account for the lost samples.
+ * @details The gap is the number of samples the configured rate should have
+ *          produced since the last SYNCH/FIFO_RST, minus those read since.
+ *          sample_index is advanced by the gap, so indices of later samples
+ *          stay aligned with time. Resolution is one HAL_GetTick() period.
+ * @param hmax Device handle.
+ * @param dropped Output, estimated samples lost (may be NULL).
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_RecoverOverflow(MAX30003_HandleTypeDef *hmax,
+                                           uint32_t *dropped) {
+    HAL_StatusTypeDef status;
+    uint64_t expected, gap = 0;
+
+    if (dropped != NULL)
+        *dropped = 0;
+
+    if ((status = MAX30003_EstimateSampleIndex(hmax, &expected)) != HAL_OK)
+        return status;
+
+    if (expected > hmax->sample_index)
+        gap = expected - hmax->sample_index;
+
+    if ((status = MAX30003_WriteReg(hmax, MAX30003_REG_FIFO_RST, MAX30003_FIFO_RST_D)) != HAL_OK)
+        return status;
+
+    hmax->sample_index += gap;
+    hmax->samples_dropped += gap;
+    hmax->overflows++;
+    MAX30003_MarkSync(hmax);
+
+    if (dropped != NULL)
+        *dropped = gap > UINT32_MAX ? UINT32_MAX : (uint32_t)gap;
+    return HAL_OK;
+}
+
+/**
+ * @brief Get a register value from the handle shadow.
+ * @details The device is only read if the shadow has not been established
+ *          since MAX30003_Init (no write, read, SW_RST or MAX30003_SyncShadow).
+ * @param hmax Device handle.
+ * @param reg Shadowed register address (EN_INT ... CNFG_RTOR2).
+ * @param data Pointer to output value.
+ * @return HAL_OK on success, HAL_ERROR if reg is not shadowed.
+ */
+HAL_StatusTypeDef MAX30003_GetShadow(MAX30003_HandleTypeDef *hmax,
+                                     uint8_t reg, uint32_t *data) {
+    int idx = MAX30003_ShadowIndex(reg);
+    HAL_StatusTypeDef status;
+
+    if (idx < 0)
+        return HAL_ERROR;
+
+    if (!(hmax->shadow_valid & (1U << idx)))
+        if ((status = MAX30003_ReadReg(hmax, reg, &hmax->shadow[idx])) != HAL_OK)
+            return status;
+
+    *data = hmax->shadow[idx];
+    return HAL_OK;
+}
+
+/**
+ * @brief Read every shadowed register back from the device.
+ * @param hmax Device handle.
+ * @return HAL_OK on success.
+ */
+HAL_StatusTypeDef MAX30003_SyncShadow(MAX30003_HandleTypeDef *hmax) {
+    HAL_StatusTypeDef status;
+    uint32_t data;
+
+    for (int i = 0; i < MAX30003_SHADOW_COUNT; ++i)
+        if ((status = MAX30003_ReadReg(hmax, MAX30003_ShadowMap[i].reg, &data)) != HAL_OK)
+            return status;
+
+    return HAL_OK;
+}
+
+/**
+ * @brief Read-modify-write a shadowed register without reading the device.
+ * @details new = (shadow & ~clear_mask) | set_bits. The write is skipped if
+ *          the value does not change.
+ * @param hmax Device handle.
+ * @param reg Shadowed register address (EN_INT ... CNFG_RTOR2).
+ * @param clear_mask Bits to clear.
+ * @param set_bits Bits to set.
+ * @return HAL_OK on success, HAL_ERROR if reg is not shadowed.
+ */
+HAL_StatusTypeDef MAX30003_UpdateReg(MAX30003_HandleTypeDef *hmax,
+                                     uint8_t reg, uint32_t clear_mask, uint32_t set_bits) {
+    HAL_StatusTypeDef status;
+    uint32_t data, updated;
+
+    if ((status = MAX30003_GetShadow(hmax, reg, &data)) != HAL_OK)
+        return status;
+
+    updated = ((data & ~clear_mask) | set_bits) & 0xFFFFFF;
+    if (updated == data)
+        return HAL_OK;
+
+    return MAX30003_WriteReg(hmax, reg, updated);
+}
+
+/**
+ * @brief Change a single register field using the _SHIFT/_MASK macros.
+ * @details Example: MAX30003_WriteField(hmax, MAX30003_REG_CNFG_ECG,
+ *          MAX30003_CNFG_ECG_GAIN_SHIFT, MAX30003_CNFG_ECG_GAIN_MASK, 0x3);
+ * @param hmax Device handle.
+ * @param reg Shadowed register address (EN_INT ... CNFG_RTOR2).
+ * @param shift Field position, e.g. MAX30003_CNFG_ECG_GAIN_SHIFT.
+ * @param mask Unshifted field mask, e.g. MAX30003_CNFG_ECG_GAIN_MASK.
+ * @param value Unshifted field value.
+ * @return HAL_OK on success.
+ */
+HAL_StatusTypeDef MAX30003_WriteField(MAX30003_HandleTypeDef *hmax,
+                                      uint8_t reg, uint8_t shift, uint32_t mask, uint32_t value) {
+    return MAX30003_UpdateReg(hmax, reg, mask << shift, (value & mask) << shift);
+}
+
+/**
+ * @brief Fill a configuration with the power-on register values.
+ * @param cfg Configuration to initialize.
+ */
+void MAX30003_ConfigDefault(MAX30003_ConfigTypeDef *cfg) {
+    for (int i = 0; i < MAX30003_SHADOW_COUNT; ++i)
+        *(uint32_t *)((uint8_t *)cfg + MAX30003_ConfigOffset[i]) = MAX30003_ShadowMap[i].reset;
+}
+
+/**
+ * @brief Apply a configuration, writing only registers that differ.
+ * @details Each register is compared against the handle shadow and written
+ *          only if it changed or its shadow is not established. Registers are
+ *          written in address order (EN_INT first, CNFG_RTOR2 last). Issue a
+ *          SYNCH afterwards if CNFG_GEN or CNFG_ECG timing fields changed.
+ * @param hmax Device handle.
+ * @param cfg Configuration to apply.
+ * @param[out] written Optional, receives (1 << MAX30003_SHADOW_x) for every
+ *             register written.
+ * @return HAL_OK on success.
+ */
+HAL_StatusTypeDef MAX30003_CommitConfig(MAX30003_HandleTypeDef *hmax,
+                                        const MAX30003_ConfigTypeDef *cfg,
+                                        uint16_t *written) {
+    HAL_StatusTypeDef status = HAL_OK;
+    uint16_t mask = 0;
+
+    for (int i = 0; i < MAX30003_SHADOW_COUNT && status == HAL_OK; ++i) {
+        uint32_t value = *(const uint32_t *)((const uint8_t *)cfg + MAX30003_ConfigOffset[i]) & 0xFFFFFF;
+
+        if ((hmax->shadow_valid & (1U << i)) && hmax->shadow[i] == value)
+            continue;
+
+        status = MAX30003_WriteReg(hmax, MAX30003_ShadowMap[i].reg, value);
+        if (status == HAL_OK)
+            mask |= 1U << i;
+    }
+
+    if (written != NULL)
+        *written = mask;
 
     return status;
 }
 
 /**
  * @brief Read ECG samples from FIFO.
+ * @details Samples are clocked out in a single chip-select cycle: one command
+ *          byte followed by 3 bytes per FIFO word (burst mode for count > 1).
  * @param hmax Device handle.
- * @param fifo_data Output buffer for FIFO data.
- * @param count Number of samples to read.
+ * @param fifo_data Output buffer for FIFO data, may be NULL to discard samples.
+ * @param count Number of samples to read (at most MAX30003_FIFO_LENGTH).
  * @return HAL_OK on success.
  */
 HAL_StatusTypeDef MAX30003_ReadFIFO(MAX30003_HandleTypeDef *hmax,
                                     uint32_t *fifo_data, uint8_t count) {
-    uint8_t tx_buf[4] = {0};
-    uint8_t rx_buf[4] = {0};
-    HAL_StatusTypeDef status = HAL_OK;
+    uint8_t tx_buf[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH] = {0};
+    uint8_t rx_buf[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH];
+    uint32_t scratch[MAX30003_FIFO_LENGTH];
+    uint32_t *words = fifo_data != NULL ? fifo_data : scratch;
+    uint16_t size = 1 + MAX30003_FIFO_WORD_SIZE * count;
+
+    if (count == 0)
+        return HAL_OK;
+    if (count > MAX30003_FIFO_LENGTH)
+        return HAL_ERROR;
 
     tx_buf[0] = ((count > 1 ? MAX30003_FIFO_CMD_ECG_BURST : MAX30003_FIFO_CMD_ECG) << 1) | 0x01;
 
-    for (uint8_t i = 0; i < count && status == HAL_OK; ++i) {
-        status = MAX30003_SPI_TransmitReceive(hmax, tx_buf, rx_buf, 4);
-        fifo_data[i] = ((uint32_t)rx_buf[1] << 16) |
-                    ((uint32_t)rx_buf[2] << 8) |
-                    rx_buf[3];
-        if (i == 0) tx_buf[0] = 0x00;  // Continue burst without command byte
+    HAL_StatusTypeDef status = MAX30003_SPI_TransmitReceive(hmax, tx_buf, rx_buf, size);
+
+    if (status == HAL_OK) {
+        MAX30003_UnpackFIFO(&rx_buf[1], words, count);
+        MAX30003_CountSamples(hmax, words, count);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Check whether a FIFO word ends a drain.
+ * @param etag ETAG of the word.
+ * @return 1 if nothing useful can follow this word, 0 otherwise.
+ */
+static uint8_t MAX30003_IsFIFOEnd(uint8_t etag) {
+    return etag == MAX30003_FIFO_ETAG_VALID_EOF
+        || etag == MAX30003_FIFO_ETAG_FAST_EOF
+        || etag == MAX30003_FIFO_ETAG_OVERFLOW;
+}
+
+/**
+ * @brief Read FIFO words until the FIFO is empty, starting with a fixed burst.
+ * @details Opens one burst read, clocks first words in a single transfer,
+ *          then continues one word at a time under the same CS until a
+ *          VALID_EOF/FAST_EOF or OVERFLOW word, an EMPTY word, or max.
+ *          EMPTY words are not stored or counted; EOF and OVERFLOW words are.
+ * @param hmax Pointer to device handle.
+ * @param fifo_data Output buffer for at least max words, or NULL to discard.
+ * @param max Maximum number of words to read (1-32).
+ * @param first Words in the first transfer, 0 for the EFIT threshold.
+ * @param count Output, number of words stored.
+ * @return HAL status.
+ */
+static HAL_StatusTypeDef MAX30003_DrainFIFOFrom(MAX30003_HandleTypeDef *hmax,
+                                                uint32_t *fifo_data, uint8_t max,
+                                                uint8_t first, uint8_t *count) {
+    uint8_t tx_buf[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH] = {0};
+    uint8_t rx_buf[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH];
+    uint32_t scratch[MAX30003_FIFO_LENGTH];
+    uint32_t *words = fifo_data != NULL ? fifo_data : scratch;
+    uint32_t mngr_int;
+    uint8_t n = 0, done = 0;
+    HAL_StatusTypeDef status;
+
+    if (count != NULL)
+        *count = 0;
+    if (max == 0)
+        return HAL_OK;
+    if (max > MAX30003_FIFO_LENGTH)
+        return HAL_ERROR;
+#if MAX30003_ENABLE_DMA
+    if (hmax->dma_busy)
+        return HAL_BUSY;
+#endif
+
+    if (first == 0) {
+        status = MAX30003_GetShadow(hmax, MAX30003_REG_MNGR_INT, &mngr_int);
+        if (status != HAL_OK)
+            return status;
+        first = ((mngr_int >> MAX30003_MNGR_INT_EFIT_SHIFT) & MAX30003_MNGR_INT_EFIT_MASK) + 1;
+    }
+    if (first > max)
+        first = max;
+
+    tx_buf[0] = (MAX30003_FIFO_CMD_ECG_BURST << 1) | 0x01;
+
+    hmax->transport->cs_assert(hmax);
+
+    status = hmax->transport->transfer(hmax, tx_buf, rx_buf, 1 + MAX30003_FIFO_WORD_SIZE * first);
+    /* Unpack word by word so nothing from an EMPTY word on reaches words[] */
+    for (uint8_t i = 0; status == HAL_OK && i < first && !done; ++i) {
+        uint32_t word;
+        uint8_t etag;
+
+        MAX30003_UnpackFIFO(&rx_buf[1 + MAX30003_FIFO_WORD_SIZE * i], &word, 1);
+        etag = MAX30003_ExtractETag(word);
+        if (etag == MAX30003_FIFO_ETAG_EMPTY)
+            done = 1;
+        else {
+            words[n++] = word;
+            done = MAX30003_IsFIFOEnd(etag);
+        }
+    }
+
+    /* tx_buf[1..3] are still zero: keep clocking the burst a word at a time */
+    while (status == HAL_OK && !done && n < max) {
+        uint8_t etag;
+
+        status = hmax->transport->transfer(hmax, &tx_buf[1], rx_buf, MAX30003_FIFO_WORD_SIZE);
+        if (status != HAL_OK)
+            break;
+
+        MAX30003_UnpackFIFO(rx_buf, &words[n], 1);
+        etag = MAX30003_ExtractETag(words[n]);
+        if (etag == MAX30003_FIFO_ETAG_EMPTY)
+            break;
+        n++;
+        done = MAX30003_IsFIFOEnd(etag);
+    }
+
+    hmax->transport->cs_release(hmax);
+
+    MAX30003_CountSamples(hmax, words, n);
+    if (count != NULL)
+        *count = n;
+    return status;
+}
+
+/**
+ * @brief Read FIFO words until the FIFO is empty.
+ * @details Clocks the EFIT threshold's worth of words in the first transfer,
+ *          then continues one word at a time under the same CS until a
+ *          VALID_EOF/FAST_EOF or OVERFLOW word, an EMPTY word, or max.
+ *          EMPTY words are not stored or counted; EOF and OVERFLOW words are.
+ * @note Call only once EINT has fired, so that at least EFIT words are
+ *       present. Otherwise the first transfer clocks 1 + 3 * EFIT bytes
+ *       regardless; use MAX30003_PollFIFO() when reading without EINT.
+ * @param hmax Pointer to device handle.
+ * @param fifo_data Output buffer for at least max words, or NULL to discard.
+ * @param max Maximum number of words to read (1-32).
+ * @param count Output, number of words stored.
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_DrainFIFO(MAX30003_HandleTypeDef *hmax,
+                                     uint32_t *fifo_data, uint8_t max, uint8_t *count) {
+    return MAX30003_DrainFIFOFrom(hmax, fifo_data, max, 0, count);
+}
+
+/**
+ * @brief Read FIFO words until the FIFO is empty, without waiting for EINT.
+ * @details As MAX30003_DrainFIFO(), but the first transfer is a single word,
+ *          so polling an empty or nearly empty FIFO costs 4 bytes rather
+ *          than the EFIT threshold's worth.
+ * @param hmax Pointer to device handle.
+ * @param fifo_data Output buffer for at least max words, or NULL to discard.
+ * @param max Maximum number of words to read (1-32).
+ * @param count Output, number of words stored.
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_PollFIFO(MAX30003_HandleTypeDef *hmax,
+                                    uint32_t *fifo_data, uint8_t max, uint8_t *count) {
+    return MAX30003_DrainFIFOFrom(hmax, fifo_data, max, 1, count);
+}
+
+#if MAX30003_ENABLE_DMA
+/**
+ * @brief Start a non-blocking FIFO read.
+ * @details CS is asserted and the burst is handed to the transport's
+ *          transfer_async operation (SPI DMA on the HAL backend). The backend
+ *          reports completion through MAX30003_TransferCpltCallback. Other
+ *          driver calls return HAL_BUSY until the transfer finishes.
+ * @param hmax Device handle.
+ * @param count Number of samples to read (at most MAX30003_FIFO_LENGTH).
+ * @param callback Called from the completion context with the decoded words.
+ * @return HAL_OK if the transfer was started, HAL_ERROR if the transport has
+ *         no asynchronous transfer.
+ */
+HAL_StatusTypeDef MAX30003_ReadFIFO_DMA(MAX30003_HandleTypeDef *hmax,
+                                        uint8_t count,
+                                        MAX30003_FIFOCpltCallbackTypeDef callback) {
+    if (count == 0 || count > MAX30003_FIFO_LENGTH || hmax->transport->transfer_async == NULL)
+        return HAL_ERROR;
+    if (hmax->dma_busy)
+        return HAL_BUSY;
+
+    hmax->dma_busy = 1;
+    hmax->dma_count = count;
+    hmax->dma_callback = callback;
+
+    hmax->dma_tx[0] = ((count > 1 ? MAX30003_FIFO_CMD_ECG_BURST : MAX30003_FIFO_CMD_ECG) << 1) | 0x01;
+
+    hmax->transport->cs_assert(hmax);
+    HAL_StatusTypeDef status = hmax->transport->transfer_async(hmax, hmax->dma_tx, hmax->dma_rx,
+                                                              1 + MAX30003_FIFO_WORD_SIZE * count);
+    if (status != HAL_OK) {
+        hmax->transport->cs_release(hmax);
+        hmax->dma_busy = 0;
     }
 
     return status;
 }
 
+/**
+ * @brief Finish an asynchronous FIFO read.
+ * @details Called by the transport backend when transfer_async completes.
+ *          Releases CS and invokes the completion callback, with the decoded
+ *          words on success or with no data on error. Ignored if no
+ *          asynchronous read is pending.
+ * @param hmax Device handle.
+ * @param status HAL_OK if the transfer completed, error status otherwise.
+ */
+void MAX30003_TransferCpltCallback(MAX30003_HandleTypeDef *hmax, HAL_StatusTypeDef status) {
+    if (!hmax->dma_busy)
+        return;
+
+    hmax->transport->cs_release(hmax);
+    if (status == HAL_OK) {
+        MAX30003_UnpackFIFO(&hmax->dma_rx[1], hmax->dma_fifo, hmax->dma_count);
+        MAX30003_CountSamples(hmax, hmax->dma_fifo, hmax->dma_count);
+    }
+    hmax->dma_busy = 0;
+
+    if (hmax->dma_callback != NULL) {
+        if (status == HAL_OK)
+            hmax->dma_callback(hmax, HAL_OK, hmax->dma_fifo, hmax->dma_count);
+        else
+            hmax->dma_callback(hmax, status, NULL, 0);
+    }
+}
+#endif /* MAX30003_ENABLE_DMA */
+
 /**
  * @brief  Gets enabled+active interrupts
+ * @details Only STATUS is read; EN_INT comes from the handle shadow, which is
+ *          maintained by MAX30003_WriteReg (see MAX30003_GetShadow).
  * @param  hmax Pointer to MAX30003 handle
  * @param[out] enabled_active Interrupts that are both enabled and active
  * @retval HAL status
@@ -177,13 +789,14 @@ HAL_StatusTypeDef MAX30003_GetInterruptStatus(
     uint32_t en_int_reg = 0;
     HAL_StatusTypeDef ret;
     
-    // Read STATUS (0x01) and EN_INT (0x02)
+    // EN_INT (0x02) from shadow, read once if not yet established
+    if((ret = MAX30003_GetShadow(hmax, MAX30003_REG_EN_INT, &en_int_reg)) != HAL_OK) return ret;
+
+    // Read STATUS (0x01)
     if((ret = MAX30003_ReadReg(hmax, MAX30003_REG_STATUS, &raw_status)) != HAL_OK) return ret;
-    if((ret = MAX30003_ReadReg(hmax, MAX30003_REG_EN_INT, &en_int_reg)) != HAL_OK) return ret;
 
     // Mask STATUS with EN_INT to get enabled+active interrupts
     *enabled_active = raw_status & en_int_reg & 0xF00F00;
     
     return HAL_OK;
 }
-
@@ -40,15 +40,6 @@
 #include <stdbool.h>
 #include "main.h"
 
-/**
- * @brief MAX30003 device handle structure
- */
-typedef struct {
-    SPI_HandleTypeDef *hspi;     /**< SPI handle */
-    GPIO_TypeDef *cs_port;       /**< Chip Select GPIO port */
-    uint16_t cs_pin;             /**< Chip Select GPIO pin */
-} MAX30003_HandleTypeDef;
-
 /************************************************
  * MAX30003 Interrupt masks
  ***********************************************/
@@ -65,6 +56,11 @@ typedef struct {
 
 #define MAX30003_SPI_TIMEOUT      	100	/**< SPI transaction timeout in milliseconds */
 #define MAX30003_FIFO_LENGTH		32	/**< FIFO length */
+#define MAX30003_FIFO_WORD_SIZE		3	/**< Bytes per FIFO word on the SPI bus */
+
+#ifndef MAX30003_ENABLE_DMA
+#define MAX30003_ENABLE_DMA         1   /**< 0 drops MAX30003_ReadFIFO_DMA() and its ~330 B of handle buffers */
+#endif
 
 /************************************************
  * MAX30003 Register Map
@@ -108,12 +104,21 @@ typedef struct {
 #define MAX30003_FIFO_ETAG_EMPTY         0x06  /**< FIFO empty */
 #define MAX30003_FIFO_ETAG_OVERFLOW      0x07  /**< FIFO overflow */
 
+/** @brief Non-zero if the ETAG marks a word carrying a sample (VALID/FAST, with or
+ *         without EOF); EMPTY, OVERFLOW and the reserved tags 4 and 5 do not */
+#define MAX30003_ETAG_IS_SAMPLE(etag)    ((etag) <= MAX30003_FIFO_ETAG_FAST_EOF)
+
 /* FIFO Tag Bit Masks */
 #define MAX30003_ETAG_MASK               0x07		/**< 8bit ETAG mask */
 #define MAX30003_ETAG_SHIFT              3			/**< Right shift for ETAG data bits */
 #define MAX30003_ECG_VOLTAGE_DATA_MASK   0x3FFFF	/**< 32bit ECG data mask */
 #define MAX30003_ECG_VOLTAGE_DATA_SHIFT  6			/**< Right shift for ECG data bits */
 
+/* RTOR Bit Masks */
+#define MAX30003_RTOR_DATA_MASK          0x3FFF		/**< 14bit R-to-R interval mask */
+#define MAX30003_RTOR_DATA_SHIFT         10			/**< Right shift for R-to-R interval bits */
+#define MAX30003_RTOR_TICKS              256		/**< FMSTR cycles per RTOR LSB (~8 ms) */
+
 /************************************************
  * Register Bit Masks
  ************************************************/
@@ -152,6 +157,8 @@ typedef struct {
 #define MAX30003_EN_INT_PLLINT_DIS                         (0 << 8)
 #define MAX30003_EN_INT_PLLINT_EN                          (1 << 8)     /**< PLL Unlocked Interrupt. Indicates that the PLL has not yet achieved or has lost its phase lock. PLLINT will only be asserted when the PLL is powered up and active (ECG and/or BIOZ Channel enabled). Remains asserted while the PLL unlocked condition persists, then held until cleared by STATUS read back (32nd SCLK).*/
 
+#define MAX30003_EN_INT_INTB_TYPE_SHIFT                    0      /**< Shift for INTB port type*/
+#define MAX30003_EN_INT_INTB_TYPE_MASK                     0x3    /**< Mask for INTB port type*/
 #define MAX30003_EN_INT_INTB_TYPE_DEFAULT                  (0x3 << 0)   /**< EN_INT INTB_TYPE default config value. Open-Drain N/nMOS Driver with Internal 125kΩ Pullup Resistance*/
 #define MAX30003_EN_INT_INTB_TYPE_3S                       (0x0 << 0)   /**< Disabled (Three-state)*/
 #define MAX30003_EN_INT_INTB_TYPE_CMOS                     (0x1 << 0)   /**< CMOS Driver*/
@@ -163,6 +170,8 @@ typedef struct {
 
 /* MNGR_INT (0x04) */
 
+#define MAX30003_MNGR_INT_EFIT_SHIFT                                19     /**< Shift for EFIT bits (threshold = EFIT + 1)*/
+#define MAX30003_MNGR_INT_EFIT_MASK                                 0x1F   /**< Mask for EFIT bits (threshold = EFIT + 1)*/
 #define MAX30003_MNGR_INT_EFIT_16                                   (0x0F << 19) /**< MNGR_INT EFIT default config value. ECG FIFO Interrupt Threshold = 16*/
 #define MAX30003_MNGR_INT_EFIT_1                                    (0x00 << 19) /**< ECG FIFO Interrupt Threshold = 1*/
 #define MAX30003_MNGR_INT_EFIT_2                                    (0x01 << 19) /**< ECG FIFO Interrupt Threshold = 2*/
@@ -197,19 +206,27 @@ typedef struct {
 #define MAX30003_MNGR_INT_EFIT_31                                   (0x1E << 19) /**< ECG FIFO Interrupt Threshold = 31*/
 #define MAX30003_MNGR_INT_EFIT_32                                   (0x1F << 19) /**< ECG FIFO Interrupt Threshold = 32*/
 
+#define MAX30003_MNGR_INT_CLR_FAST_SHIFT                            6      /**< Shift for CLR_FAST bit*/
+#define MAX30003_MNGR_INT_CLR_FAST_MASK                             0x1    /**< Mask for CLR_FAST bit*/
 #define MAX30003_MNGR_INT_CLR_FAST_DEFAULT                          (0 << 6) /**< MNGR_INT CLR_FAST default config value. FSTINT remains active until the FAST mode is disengaged (manually or automatically), then held until cleared by STATUS read back (32nd SCLK)*/
 #define MAX30003_MNGR_INT_CLR_FAST_DIS                              (0 << 6) /**< FSTINT remains active until the FAST mode is disengaged (manually or automatically), then held until cleared by STATUS read back (32nd SCLK)*/
 #define MAX30003_MNGR_INT_CLR_FAST_EN                               (1 << 6) /**< FSTINT remains active until cleared by STATUS read back (32nd SCLK), even if the MAX30003 remains in FAST recovery mode. Once cleared, FSTINT will not be re-asserted until FAST mode is exited and re-entered, either manually or automatically*/
 
+#define MAX30003_MNGR_INT_CLR_RRINT_SHIFT                           4      /**< Shift for CLR_RRINT bits*/
+#define MAX30003_MNGR_INT_CLR_RRINT_MASK                            0x3    /**< Mask for CLR_RRINT bits*/
 #define MAX30003_MNGR_INT_CLR_RRINT_DEFAULT                         (0x0 << 4) /**< MNGR_INT CLR_RRINT default config value. Clear RRINT on STATUS Register Read Back*/
 #define MAX30003_MNGR_INT_CLR_RRINT_ON_STATUS_REGISTER_READ_BACK    (0x0 << 4) /**< Clear RRINT on STATUS Register Read Back*/
 #define MAX30003_MNGR_INT_CLR_RRINT_ON_RTOR_REGISTER_READ_BACK      (0x1 << 4) /**< Clear RRINT on RTOR Register Read Back*/
 #define MAX30003_MNGR_INT_CLR_RRINT_SELF_CLEAR                      (0x2 << 4) /**< Self-Clear RRINT after one ECG data rate cycle, approximately 2ms to 8ms*/
 
+#define MAX30003_MNGR_INT_CLR_SAMP_SHIFT                            2      /**< Shift for CLR_SAMP bit*/
+#define MAX30003_MNGR_INT_CLR_SAMP_MASK                             0x1    /**< Mask for CLR_SAMP bit*/
 #define MAX30003_MNGR_INT_CLR_SAMP_DEFAULT                          (1 << 2) /**< MNGR_INT CLR_SAMP default config value. Self-clear SAMP after approximately one-fourth of one data rate cycle*/
 #define MAX30003_MNGR_INT_CLR_SAMP_SELF_CLEAR_ON_STATUS_READBACK    (0 << 2) /**< Clear SAMP on STATUS Register Read Back (recommended for debug/evaluation only)*/
 #define MAX30003_MNGR_INT_CLR_SAMP_SELF_CLEAR                       (1 << 2) /**< Self-clear SAMP after approximately one-fourth of one data rate cycle*/
 
+#define MAX30003_MNGR_INT_SAMP_IT_SHIFT                             0      /**< Shift for SAMP_IT bits*/
+#define MAX30003_MNGR_INT_SAMP_IT_MASK                              0x3    /**< Mask for SAMP_IT bits*/
 #define MAX30003_MNGR_INT_SAMP_IT_DEFAULT                           (0x0 << 0) /**< MNGR_INT SAMP_IT default config value. Sample Synchronization Pulse (SAMP) Frequency. Issued every sample instant*/
 #define MAX30003_MNGR_INT_SAMP_IT_EVERY_SAMPLE                      (0x0 << 0) /**< Sample Synchronization Pulse (SAMP) Frequency. Issued every sample instant*/
 #define MAX30003_MNGR_INT_SAMP_IT_EVERY_2ND_SAMPLE                  (0x1 << 0) /**< Sample Synchronization Pulse (SAMP) Frequency. Issued every 2nd sample instant*/
@@ -220,6 +237,8 @@ typedef struct {
 
 /* MNGR_DYN (0x05) */
 
+#define MAX30003_MNGR_DYN_FAST_SHIFT              22     /**< Shift for FAST bits*/
+#define MAX30003_MNGR_DYN_FAST_MASK               0x3    /**< Mask for FAST bits*/
 #define MAX30003_MNGR_DYN_FAST_DEFAULT            (0x0 << 22) /**< MNGR_DYN FAST default config value. Normal Mode (Fast Recovery Mode Disabled)*/
 #define MAX30003_MNGR_DYN_FAST_NORMAL_MODE        (0x0 << 22) /**< Normal Mode (Fast Recovery Mode Disabled)*/
 #define MAX30003_MNGR_DYN_FAST_MANUAL_MODE        (0x1 << 22) /**< Manual Fast Recovery Mode Enable (remains active until disabled)*/
@@ -245,28 +264,40 @@ typedef struct {
 
 /* CNFG_GEN (0x10) */
 
+#define MAX30003_CNFG_GEN_EN_ULP_LON_SHIFT              22     /**< Shift for EN_ULP_LON bits*/
+#define MAX30003_CNFG_GEN_EN_ULP_LON_MASK               0x3    /**< Mask for EN_ULP_LON bits*/
 #define MAX30003_CNFG_GEN_EN_ULP_LON_DEFAULT            (0x0 << 22) /**< CNFG_GEN EN_ULP_LON default config value. ULP Lead-On Detection disabled*/
 #define MAX30003_CNFG_GEN_EN_ULP_LON_DIS                (0x0 << 22) /**< ULP Lead-On Detection disabled*/
 #define MAX30003_CNFG_GEN_EN_ULP_LON_EN                 (0x1 << 22) /**< ECG ULP Lead-On Detection enabled*/
 
+#define MAX30003_CNFG_GEN_FMSTR_SHIFT                   20     /**< Shift for FMSTR bits*/
+#define MAX30003_CNFG_GEN_FMSTR_MASK                    0x3    /**< Mask for FMSTR bits*/
 #define MAX30003_CNFG_GEN_FMSTR_DEFAULT                 (0x0 << 20) /**< CNFG_GEN FMSTR default config value. FMSTR = 32768Hz, TRES = 15.26µs (512Hz ECG progressions)*/
 #define MAX30003_CNFG_GEN_FMSTR_512HZ_ECG_PROGGRESION   (0x0 << 20) /**< FMSTR = 32768Hz, TRES = 15.26µs (512Hz ECG progressions)*/
 #define MAX30003_CNFG_GEN_FMSTR_500HZ_ECG_PROGGRESION   (0x1 << 20) /**< FMSTR = 32000Hz, TRES = 15.63µs (500Hz ECG progressions)*/
 #define MAX30003_CNFG_GEN_FMSTR_200HZ_ECG_PROGGRESION   (0x2 << 20) /**< FMSTR = 32000Hz, TRES = 15.63µs (200Hz ECG progressions)*/
 #define MAX30003_CNFG_GEN_FMSTR_199HZ_ECG_PROGGRESION   (0x3 << 20) /**< FMSTR = 31968.78Hz, TRES = 15.64µs (199.8049Hz ECG progressions)*/
 
+#define MAX30003_CNFG_GEN_EN_ECG_SHIFT                  19     /**< Shift for EN_ECG bit*/
+#define MAX30003_CNFG_GEN_EN_ECG_MASK                   0x1    /**< Mask for EN_ECG bit*/
 #define MAX30003_CNFG_GEN_EN_ECG_DEFAULT                (0 << 19) /**< CNFG_GEN EN_ECG default config value. ECG Channel disabled*/
 #define MAX30003_CNFG_GEN_EN_ECG_DIS                    (0 << 19) /**< ECG Channel disabled*/
 #define MAX30003_CNFG_GEN_EN_ECG_EN                     (1 << 19) /**< ECG Channel enabled*/
 
+#define MAX30003_CNFG_GEN_EN_DCLOFF_SHIFT               12     /**< Shift for EN_DCLOFF bits*/
+#define MAX30003_CNFG_GEN_EN_DCLOFF_MASK                0x3    /**< Mask for EN_DCLOFF bits*/
 #define MAX30003_CNFG_GEN_EN_DCLOFF_DEFAULT             (0x0 << 12) /**< CNFG_GEN EN_DCLOFF default config value. DC Lead-Off Detection disabled*/
 #define MAX30003_CNFG_GEN_EN_DCLOFF_DIS                 (0x0 << 12) /**< DC Lead-Off Detection disabled*/
 #define MAX30003_CNFG_GEN_EN_DCLOFF_EN                  (0x1 << 12) /**< DCLOFF Detection applied to the ECGP/N pins*/
 
+#define MAX30003_CNFG_GEN_DCLOFF_IPOL_SHIFT             11     /**< Shift for DCLOFF_IPOL bit*/
+#define MAX30003_CNFG_GEN_DCLOFF_IPOL_MASK              0x1    /**< Mask for DCLOFF_IPOL bit*/
 #define MAX30003_CNFG_GEN_DCLOFF_IPOL_DEFAULT           (0 << 11) /**< CNFG_GEN DCLOFF_IPOL default config value. ECGP - Pullup, ECGN – Pulldown*/
 #define MAX30003_CNFG_GEN_DCLOFF_IPOL_ECGP_PULLUP       (0 << 11) /**< ECGP - Pullup, ECGN – Pulldown*/
 #define MAX30003_CNFG_GEN_DCLOFF_IPOL_ECGP_PULLDOWN     (1 << 11) /**< ECGP - Pulldown, ECGN – Pullup*/
 
+#define MAX30003_CNFG_GEN_DCLOFF_IMAG_SHIFT             8      /**< Shift for DCLOFF_IMAG bits*/
+#define MAX30003_CNFG_GEN_DCLOFF_IMAG_MASK              0x7    /**< Mask for DCLOFF_IMAG bits*/
 #define MAX30003_CNFG_GEN_DCLOFF_IMAG_DEFAULT           (0x0 << 8) /**< CNFG_GEN DCLOFF_IMAG default config value. DC Lead-Off Current 0nA (Disable and Disconnect Current Sources)*/
 #define MAX30003_CNFG_GEN_DCLOFF_IMAG_0nA               (0x0 << 8) /**< DC Lead-Off Current 0nA (Disable and Disconnect Current Sources)*/
 #define MAX30003_CNFG_GEN_DCLOFF_IMAG_5nA               (0x1 << 8) /**< DC Lead-Off Current 5nA*/
@@ -275,25 +306,35 @@ typedef struct {
 #define MAX30003_CNFG_GEN_DCLOFF_IMAG_50nA              (0x4 << 8) /**< DC Lead-Off Current 50nA*/
 #define MAX30003_CNFG_GEN_DCLOFF_IMAG_100nA             (0x5 << 8) /**< DC Lead-Off Current 100nA*/
 
+#define MAX30003_CNFG_GEN_DCLOFF_VTH_SHIFT              6      /**< Shift for DCLOFF_VTH bits*/
+#define MAX30003_CNFG_GEN_DCLOFF_VTH_MASK               0x3    /**< Mask for DCLOFF_VTH bits*/
 #define MAX30003_CNFG_GEN_DCLOFF_VTH_DEFAULT            (0x0 << 6) /**< CNFG_GEN DCLOFF_VTH default config value. VMID ± 300mV*/
 #define MAX30003_CNFG_GEN_DCLOFF_VTH_VMID_PM_300        (0x0 << 6) /**< VMID ± 300mV*/
 #define MAX30003_CNFG_GEN_DCLOFF_VTH_VMID_PM_400        (0x1 << 6) /**< VMID ± 400mV*/
 #define MAX30003_CNFG_GEN_DCLOFF_VTH_VMID_PM_450        (0x2 << 6) /**< VMID ± 450mV*/
 #define MAX30003_CNFG_GEN_DCLOFF_VTH_VMID_PM_500        (0x3 << 6) /**< VMID ± 500mV*/
 
+#define MAX30003_CNFG_GEN_EN_RBIAS_SHIFT                4      /**< Shift for EN_RBIAS bits*/
+#define MAX30003_CNFG_GEN_EN_RBIAS_MASK                 0x3    /**< Mask for EN_RBIAS bits*/
 #define MAX30003_CNFG_GEN_EN_RBIAS_DEFAULT              (0x0 << 4) /**< CNFG_GEN EN_RBIAS default config value. Resistive Bias disabled*/
 #define MAX30003_CNFG_GEN_EN_RBIAS_DIS                  (0x0 << 4) /**< Resistive Bias disabled*/
 #define MAX30003_CNFG_GEN_EN_RBIAS_EN                   (0x1 << 4) /**< ECG Resistive Bias enabled if EN_ECG is also enabled*/
 
+#define MAX30003_CNFG_GEN_RBIASV_SHIFT                  2      /**< Shift for RBIASV bits*/
+#define MAX30003_CNFG_GEN_RBIASV_MASK                   0x3    /**< Mask for RBIASV bits*/
 #define MAX30003_CNFG_GEN_RBIASV_DEFAULT                (0x1 << 2) /**< CNFG_GEN RBIASV default config value. RBIAS = 100MΩ*/
 #define MAX30003_CNFG_GEN_RBIASV_50M                    (0x0 << 2) /**< RBIAS = 50MΩ*/
 #define MAX30003_CNFG_GEN_RBIASV_100M                   (0x1 << 2) /**< RBIAS = 100MΩ*/
 #define MAX30003_CNFG_GEN_RBIASV_200M                   (0x2 << 2) /**< RBIAS = 200MΩ*/
 
+#define MAX30003_CNFG_GEN_RBIASP_SHIFT                  1      /**< Shift for RBIASP bit*/
+#define MAX30003_CNFG_GEN_RBIASP_MASK                   0x1    /**< Mask for RBIASP bit*/
 #define MAX30003_CNFG_GEN_RBIASP_DEFAULT                (0 << 1) /**< CNFG_GEN RBIASP default config value. ECGP is not resistively connected to VMID*/
 #define MAX30003_CNFG_GEN_RBIASP_DIS                    (0 << 1) /**< ECGP is not resistively connected to VMID*/
 #define MAX30003_CNFG_GEN_RBIASP_EN                     (1 << 1) /**< ECGP is connected to VMID through a resistor (selected by RBIASV)*/
 
+#define MAX30003_CNFG_GEN_RBIASN_SHIFT                  0      /**< Shift for RBIASN bit*/
+#define MAX30003_CNFG_GEN_RBIASN_MASK                   0x1    /**< Mask for RBIASN bit*/
 #define MAX30003_CNFG_GEN_RBIASN_DEFAULT                (0 << 0) /**< CNFG_GEN RBIASN default config value. ECGN is not resistively connected to VMID*/
 #define MAX30003_CNFG_GEN_RBIASN_DIS                    (0 << 0) /**< ECGN is not resistively connected to VMID*/
 #define MAX30003_CNFG_GEN_RBIASN_EN                     (1 << 0) /**< ECGN is connected to VMID through a resistor (selected by RBIASV)*/
@@ -302,18 +343,26 @@ typedef struct {
 
 /* CNFG_CAL (0x12) */
 
+#define MAX30003_CNFG_CAL_EN_VCAL_SHIFT                 22     /**< Shift for EN_VCAL bit*/
+#define MAX30003_CNFG_CAL_EN_VCAL_MASK                  0x1    /**< Mask for EN_VCAL bit*/
 #define MAX30003_CNFG_CAL_EN_VCAL_DEFAULT               (0 << 22) /**< CNFG_CAL EN_VCAL default value. Calibration sources and modes disabled*/
 #define MAX30003_CNFG_CAL_EN_VCAL_DIS                   (0 << 22) /**< Calibration sources and modes disabled*/
 #define MAX30003_CNFG_CAL_EN_VCAL_EN                    (1 << 22) /**< Calibration sources and modes enabled*/
 
+#define MAX30003_CNFG_CAL_VMODE_SHIFT                   21     /**< Shift for VMODE bit*/
+#define MAX30003_CNFG_CAL_VMODE_MASK                    0x1    /**< Mask for VMODE bit*/
 #define MAX30003_CNFG_CAL_VMODE_DEFAULT                 (0 << 21) /**< CNFG_CAL VMODE default value. Unipolar, sources swing between VMID ± VMAG and VMID*/
 #define MAX30003_CNFG_CAL_VMODE_UNIPOLAR                (0 << 21) /**< Unipolar, sources swing between VMID ± VMAG and VMID*/
 #define MAX30003_CNFG_CAL_VMODE_BIPOLAR                 (1 << 21) /**< Bipolar, sources swing between VMID + VMAG and VMID - VMAG*/
 
+#define MAX30003_CNFG_CAL_VMAG_SHIFT                    20     /**< Shift for VMAG bit*/
+#define MAX30003_CNFG_CAL_VMAG_MASK                     0x1    /**< Mask for VMAG bit*/
 #define MAX30003_CNFG_CAL_VMAG_DEFAULT                  (0 << 20) /**< CNFG_CAL VMAG default value. VMAG = 0.25mV*/
 #define MAX30003_CNFG_CAL_VMAG_0_25mV                   (0 << 20) /**< VMAG = 0.25mV*/
 #define MAX30003_CNFG_CAL_VMAG_0_50mV                   (1 << 20) /**< VMAG = 0.50mV*/
 
+#define MAX30003_CNFG_CAL_FCAL_SHIFT                    12     /**< Shift for FCAL bits*/
+#define MAX30003_CNFG_CAL_FCAL_MASK                     0x7    /**< Mask for FCAL bits*/
 #define MAX30003_CNFG_CAL_FCAL_DEFAULT                  (0x4 << 12) /**< CNFG_CAL FCAL default value. Calibration Source Frequency = FMSTR/2^15 (Approximately 1Hz)*/
 #define MAX30003_CNFG_CAL_FCAL_256Hz                    (0x0 << 12) /**< Calibration Source Frequency = FMSTR/128 (Approximately 256Hz)*/
 #define MAX30003_CNFG_CAL_FCAL_64Hz                     (0x1 << 12) /**< Calibration Source Frequency = FMSTR/512 (Approximately 64Hz)*/
@@ -324,6 +373,8 @@ typedef struct {
 #define MAX30003_CNFG_CAL_FCAL_1_16Hz                   (0x6 << 12) /**< Calibration Source Frequency = FMSTR/2^19 (Approximately 1/16Hz)*/
 #define MAX30003_CNFG_CAL_FCAL_1_64Hz                   (0x7 << 12) /**< Calibration Source Frequency = FMSTR/2^21 (Approximately 1/64Hz)*/
 
+#define MAX30003_CNFG_CAL_FIFTY_SHIFT                   11     /**< Shift for FIFTY bit*/
+#define MAX30003_CNFG_CAL_FIFTY_MASK                    0x1    /**< Mask for FIFTY bit*/
 #define MAX30003_CNFG_CAL_FIFTY_DEFAULT                 (1 << 11) /**< CNFG_CAL FIFTY default value. THIGH = 50% (CAL_THIGH[10:0] are ignored)*/
 #define MAX30003_CNFG_CAL_FIFTY_DUTY_SELECT             (0 << 11) /**< Use CAL_THIGH to select time high for VCALP and VCALN*/
 #define MAX30003_CNFG_CAL_FIFTY_DUTY_50                 (1 << 11) /**< THIGH = 50% (CAL_THIGH[10:0] are ignored)*/
@@ -336,24 +387,34 @@ typedef struct {
 
 /* CNFG_EMUX (0x14) */
 
+#define MAX30003_CNFG_EMUX_POL_SHIFT                        23     /**< Shift for POL bit*/
+#define MAX30003_CNFG_EMUX_POL_MASK                         0x1    /**< Mask for POL bit*/
 #define MAX30003_CNFG_EMUX_POL_DEFAULT                      (0 << 23) /**< CFNG_EMUX POL default value. ECG Input Polarity Non-inverted*/
 #define MAX30003_CNFG_EMUX_POL_NON_INVERTED                 (0 << 23) /**< ECG Input Polarity Non-inverted*/
 #define MAX30003_CNFG_EMUX_POL_INVERTED                     (1 << 23) /**< ECG Input Polarity Inverted*/
 
+#define MAX30003_CNFG_EMUX_OPENP_SHIFT                      21     /**< Shift for OPENP bit*/
+#define MAX30003_CNFG_EMUX_OPENP_MASK                       0x1    /**< Mask for OPENP bit*/
 #define MAX30003_CNFG_EMUX_OPENP_DEFAULT                    (1 << 21) /**< CFNG_EMUX OPENP default value. ECGP is internally isolated from the ECG AFE Channel*/
 #define MAX30003_CNFG_EMUX_OPENP_INTERNALLY_CONNECTED       (0 << 21) /**< ECGP is internally connected to the ECG AFE Channel*/
 #define MAX30003_CNFG_EMUX_OPENP_INTERNALLY_ISOLATED        (1 << 21) /**< ECGP is internally isolated from the ECG AFE Channel*/
 
+#define MAX30003_CNFG_EMUX_OPENN_SHIFT                      20     /**< Shift for OPENN bit*/
+#define MAX30003_CNFG_EMUX_OPENN_MASK                       0x1    /**< Mask for OPENN bit*/
 #define MAX30003_CNFG_EMUX_OPENN_DEFAULT                    (1 << 20) /**< CFNG_EMUX OPENN default value. ECGN is internally isolated from the ECG AFE Channel*/
 #define MAX30003_CNFG_EMUX_OPENN_INTERNALLY_CONNECTED       (0 << 20) /**< ECGN is internally connected to the ECG AFE Channel*/
 #define MAX30003_CNFG_EMUX_OPENN_INTERNALLY_ISOLATED        (1 << 20) /**< ECGN is internally isolated from the ECG AFE Channel*/
 
+#define MAX30003_CNFG_EMUX_CALP_SEL_SHIFT                   18     /**< Shift for CALP_SEL bits*/
+#define MAX30003_CNFG_EMUX_CALP_SEL_MASK                    0x3    /**< Mask for CALP_SEL bits*/
 #define MAX30003_CNFG_EMUX_CALP_SEL_DEFAULT                 (0x0 << 18) /**< CFNG_EMUX CALP_SEL default value. No calibration signal applied*/
 #define MAX30003_CNFG_EMUX_CALP_SEL_NONE                    (0x0 << 18) /**< No calibration signal applied*/
 #define MAX30003_CNFG_EMUX_CALP_SEL_IN_TO_VMID              (0x1 << 18) /**< Input is connected to VMID*/
 #define MAX30003_CNFG_EMUX_CALP_SEL_IN_TO_VCALP             (0x2 << 18) /**< Input is connected to VCALP (only available if CAL_EN_VCAL = 1)*/
 #define MAX30003_CNFG_EMUX_CALP_SEL_IN_TO_VCALN             (0x3 << 18) /**< Input is connected to VCALN (only available if CAL_EN_VCAL = 1)*/
 
+#define MAX30003_CNFG_EMUX_CALN_SEL_SHIFT                   16     /**< Shift for CALN_SEL bits*/
+#define MAX30003_CNFG_EMUX_CALN_SEL_MASK                    0x3    /**< Mask for CALN_SEL bits*/
 #define MAX30003_CNFG_EMUX_CALN_SEL_DEFAULT                 (0x0 << 16) /**< CFNG_EMUX CALN_SEL default value. No calibration signal applied*/
 #define MAX30003_CNFG_EMUX_CALN_SEL_NONE                    (0x0 << 16) /**< No calibration signal applied*/
 #define MAX30003_CNFG_EMUX_CALN_SEL_IN_TO_VMID              (0x1 << 16) /**< Input is connected to VMID*/
@@ -366,21 +427,29 @@ typedef struct {
 
 #define MAX30003_CNFG_ECG_DEFAULT      (0x000000 << 0)
 
+#define MAX30003_CNFG_ECG_RATE_SHIFT   22     /**< Shift for RATE bits*/
+#define MAX30003_CNFG_ECG_RATE_MASK    0x3    /**< Mask for RATE bits*/
 #define MAX30003_CNFG_ECG_RATE_DEFAULT (0x2 << 22) /**< CNFG_ECG RATE default value. FMSTR = 00/01/10/11. ECG Data Rate = 128/125/200/199.8 sps*/
 #define MAX30003_CNFG_ECG_RATE_512     (0x0 << 22) /**< FMSTR = 00/01/10/11. ECG Data Rate = 512/500/RESERVED/RESERVED sps*/
 #define MAX30003_CNFG_ECG_RATE_256     (0x1 << 22) /**< FMSTR = 00/01/10/11. ECG Data Rate = 256/250/RESERVED/RESERVED sps*/
 #define MAX30003_CNFG_ECG_RATE_128     (0x2 << 22) /**< FMSTR = 00/01/10/11. ECG Data Rate = 128/125/200/199.8 sps*/
 
+#define MAX30003_CNFG_ECG_GAIN_SHIFT   16     /**< Shift for GAIN bits*/
+#define MAX30003_CNFG_ECG_GAIN_MASK    0x3    /**< Mask for GAIN bits*/
 #define MAX30003_CNFG_ECG_GAIN_DEFAULT (0x0 << 16) /**< CNFG_ECG GAIN default value. ECG Channel Gain = 20V/V*/
 #define MAX30003_CNFG_ECG_GAIN_20      (0x0 << 16) /**< ECG Channel Gain = 20V/V*/
 #define MAX30003_CNFG_ECG_GAIN_40      (0x1 << 16) /**< ECG Channel Gain = 40V/V*/
 #define MAX30003_CNFG_ECG_GAIN_80      (0x2 << 16) /**< ECG Channel Gain = 80V/V*/
 #define MAX30003_CNFG_ECG_GAIN_160     (0x3 << 16) /**< ECG Channel Gain = 160V/V*/
 
+#define MAX30003_CNFG_ECG_DHPF_SHIFT   14     /**< Shift for DHPF bit*/
+#define MAX30003_CNFG_ECG_DHPF_MASK    0x1    /**< Mask for DHPF bit*/
 #define MAX30003_CNFG_ECG_DHPF_DEFAULT (1 << 14) /**< CNFG_ECG DHPF default value. ECG Channel Digital High-Pass Filter Cutoff Frequency = 0.50Hz*/
 #define MAX30003_CNFG_ECG_DHPF_DIS     (0 << 14) /**< ECG Channel Digital High-Pass Filter Cutoff Frequency = Bypass (DC)*/
 #define MAX30003_CNFG_ECG_DHPF_EN      (1 << 14) /**< ECG Channel Digital High-Pass Filter Cutoff Frequency = 0.50Hz*/
 
+#define MAX30003_CNFG_ECG_DLPF_SHIFT   12     /**< Shift for DLPF bits*/
+#define MAX30003_CNFG_ECG_DLPF_MASK    0x3    /**< Mask for DLPF bits*/
 #define MAX30003_CNFG_ECG_DLPF_DEFAULT (0x1 << 12) /**< CNFG_ECG DLPF default value. ECG Channel Digital Low-Pass Filter Cutoff Frequency = approximately 40Hz (Except for 125 and 128sps settings)*/
 #define MAX30003_CNFG_ECG_DLPF_BYPASS  (0x0 << 12) /**< ECG Channel Digital Low-Pass Filter Cutoff Frequency = Bypass (Decimation only, no FIR filter applied)*/
 #define MAX30003_CNFG_ECG_DLPF_40      (0x1 << 12) /**< ECG Channel Digital Low-Pass Filter Cutoff Frequency = approximately 40Hz (Except for 125 and 128sps settings)*/
@@ -391,6 +460,8 @@ typedef struct {
 
 /* CNFG_RTOR (0x1D & 0x1E) */
 
+#define MAX30003_CNFG_RTOR_eWNDW_SHIFT         20     /**< Shift for eWNDW bits*/
+#define MAX30003_CNFG_RTOR_eWNDW_MASK          0xF    /**< Mask for eWNDW bits*/
 #define MAX30003_CNFG_RTOR_eWNDW_DEFAULT       (0x3 << 20) /**< CNFG_RTOR eWNDW default value. R to R Window Averaging (Window Width = RTOR_WNDW[3:0] * 8ms) = 12 * 8ms = 96*/
 #define MAX30003_CNFG_RTOR_eWNDW_6             (0x0 << 20) /**< R to R Window Averaging (Window Width = RTOR_WNDW[3:0] * 8ms) = 6 * 8ms = 48ms*/
 #define MAX30003_CNFG_RTOR_eWNDW_8             (0x1 << 20) /**< R to R Window Averaging (Window Width = RTOR_WNDW[3:0] * 8ms) = 8 * 8ms = 64ms*/
@@ -405,6 +476,8 @@ typedef struct {
 #define MAX30003_CNFG_RTOR_eWNDW_26            (0xA << 20) /**< R to R Window Averaging (Window Width = RTOR_WNDW[3:0] * 8ms) = 26 * 8ms = 208*/
 #define MAX30003_CNFG_RTOR_eWNDW_28            (0xB << 20) /**< R to R Window Averaging (Window Width = RTOR_WNDW[3:0] * 8ms) = 28 * 8ms = 224*/
 
+#define MAX30003_CNFG_RTOR_GAIN_SHIFT          16     /**< Shift for GAIN bits*/
+#define MAX30003_CNFG_RTOR_GAIN_MASK           0xF    /**< Mask for GAIN bits*/
 #define MAX30003_CNFG_RTOR_GAIN_DEFAULT        (0xF << 16) /**< CNFG_RTOR GAIN default value. R to R Gain = AUTO*/
 #define MAX30003_CNFG_RTOR_GAIN_1              (0x0 << 16) /**< R to R Gain = 1*/
 #define MAX30003_CNFG_RTOR_GAIN_2              (0x1 << 16) /**< R to R Gain = 2*/
@@ -423,10 +496,14 @@ typedef struct {
 #define MAX30003_CNFG_RTOR_GAIN_16384          (0xE << 16) /**< R to R Gain = 16384*/
 #define MAX30003_CNFG_RTOR_GAIN_AUTO           (0xF << 16) /**< R to R Gain = AUTO*/
 
+#define MAX30003_CNFG_RTOR_EN_RTOR_SHIFT       15     /**< Shift for EN_RTOR bit*/
+#define MAX30003_CNFG_RTOR_EN_RTOR_MASK        0x1    /**< Mask for EN_RTOR bit*/
 #define MAX30003_CNFG_RTOR_EN_RTOR_DEFAULT     (0 << 15) /**< CNFG_RTOR EN_RTOR default value. RTOR Detection disabled*/
 #define MAX30003_CNFG_RTOR_EN_RTOR_DIS         (0 << 15) /**< RTOR Detection disabled*/
 #define MAX30003_CNFG_RTOR_EN_RTOR_EN          (1 << 15) /**< RTOR Detection enabled if EN_ECG is also enabled*/
 
+#define MAX30003_CNFG_RTOR_PAVG_SHIFT         12     /**< Shift for PAVG bits*/
+#define MAX30003_CNFG_RTOR_PAVG_MASK          0x3    /**< Mask for PAVG bits*/
 #define MAX30003_CNFG_RTOR_PAVG_DEFAULT       (0x2 << 12) /**< CNFG_RTOR PAVG default value. R to R Peak Averaging Weight Factor = 8*/
 #define MAX30003_CNFG_RTOR_PAVG_2             (0x0 << 12) /**< R to R Peak Averaging Weight Factor = 2*/
 #define MAX30003_CNFG_RTOR_PAVG_4             (0x1 << 12) /**< R to R Peak Averaging Weight Factor = 4*/
@@ -441,6 +518,8 @@ typedef struct {
 #define MAX30003_CNFG_RTOR2_HOFF_MASK         0x3F                                     /**< Mask for PTSF bits*/
 #define MAX30003_CNFG_RTOR2_HOFF_DEFAULT      (0x20 << MAX30003_CNFG_RTOR2_HOFF_SHIFT) /**< Default PTSF value*/
 
+#define MAX30003_CNFG_RTOR2_RAVG_SHIFT         12     /**< Shift for RAVG bits*/
+#define MAX30003_CNFG_RTOR2_RAVG_MASK          0x3    /**< Mask for RAVG bits*/
 #define MAX30003_CNFG_RTOR2_RAVG_DEFAULT       (0x2 << 12) /**< CNFG_RTOR RAVG default value. R to R Interval Averaging Weight Factor = 8*/
 #define MAX30003_CNFG_RTOR2_RAVG_2             (0x0 << 12) /**< R to R Interval Averaging Weight Factor = 2*/
 #define MAX30003_CNFG_RTOR2_RAVG_4             (0x1 << 12) /**< R to R Interval Averaging Weight Factor = 4*/
@@ -454,6 +533,105 @@ typedef struct {
 #define MAX30003_CNFG_RTOR_DEFAULT_CONFIG      (0x3F2300 << 0) /**< Default CNFG_RTOR register config*/
 #define MAX30003_CNFG_RTOR2_DEFAULT_CONFIG     (0x202400 << 0) /**< Default CNFG_RTOR2 register config*/
 
+/************************************************
+ * Device Handle
+ ************************************************/
+
+/* Register shadow slots (writable configuration registers) */
+#define MAX30003_SHADOW_EN_INT      0   /**< Shadow slot of EN_INT */
+#define MAX30003_SHADOW_EN_INT2     1   /**< Shadow slot of EN_INT2 */
+#define MAX30003_SHADOW_MNGR_INT    2   /**< Shadow slot of MNGR_INT */
+#define MAX30003_SHADOW_MNGR_DYN    3   /**< Shadow slot of MNGR_DYN */
+#define MAX30003_SHADOW_CNFG_GEN    4   /**< Shadow slot of CNFG_GEN */
+#define MAX30003_SHADOW_CNFG_CAL    5   /**< Shadow slot of CNFG_CAL */
+#define MAX30003_SHADOW_CNFG_EMUX   6   /**< Shadow slot of CNFG_EMUX */
+#define MAX30003_SHADOW_CNFG_ECG    7   /**< Shadow slot of CNFG_ECG */
+#define MAX30003_SHADOW_CNFG_RTOR1  8   /**< Shadow slot of CNFG_RTOR1 */
+#define MAX30003_SHADOW_CNFG_RTOR2  9   /**< Shadow slot of CNFG_RTOR2 */
+#define MAX30003_SHADOW_COUNT       10  /**< Number of shadowed registers */
+#define MAX30003_SHADOW_ALL         ((1U << MAX30003_SHADOW_COUNT) - 1) /**< All shadow_valid flags */
+
+struct __MAX30003_HandleTypeDef;
+
+/**
+ * @brief Asynchronous FIFO read completion callback
+ * @param hmax Device handle the transfer was started on.
+ * @param status HAL_OK if the transfer completed, error status otherwise.
+ * @param fifo_data Decoded FIFO words (valid only during the callback).
+ * @param count Number of words in fifo_data.
+ */
+typedef void (*MAX30003_FIFOCpltCallbackTypeDef)(struct __MAX30003_HandleTypeDef *hmax,
+                                                 HAL_StatusTypeDef status,
+                                                 const uint32_t *fifo_data,
+                                                 uint8_t count);
+
+/**
+ * @brief Transport operations used by the driver to reach the device
+ * @details The driver brackets every transaction with cs_assert/cs_release and
+ *          moves bytes with transfer. Backends: STM32 HAL
+ *          (max30003_transport_hal.c, used by MAX30003_Init), STM32 LL
+ *          (max30003_transport_ll.h) and the host simulator
+ *          (host/max30003_transport_sim.h).
+ */
+typedef struct {
+    /** Blocking full-duplex transfer; tx is never NULL, rx may be NULL. */
+    HAL_StatusTypeDef (*transfer)(struct __MAX30003_HandleTypeDef *hmax,
+                                  const uint8_t *tx, uint8_t *rx, uint16_t size);
+    /** Optional non-blocking transfer; completion must be reported through
+     *  MAX30003_TransferCpltCallback. NULL if not supported. */
+    HAL_StatusTypeDef (*transfer_async)(struct __MAX30003_HandleTypeDef *hmax,
+                                        const uint8_t *tx, uint8_t *rx, uint16_t size);
+    void (*cs_assert)(struct __MAX30003_HandleTypeDef *hmax);  /**< Drive CS low */
+    void (*cs_release)(struct __MAX30003_HandleTypeDef *hmax); /**< Drive CS high */
+} MAX30003_TransportTypeDef;
+
+/**
+ * @brief MAX30003 device handle structure
+ */
+typedef struct __MAX30003_HandleTypeDef {
+    const MAX30003_TransportTypeDef *transport; /**< Transport operations */
+    void *transport_ctx;         /**< Transport backend context */
+#ifdef HAL_SPI_MODULE_ENABLED
+    SPI_HandleTypeDef *hspi;     /**< SPI handle (STM32 HAL transport) */
+    GPIO_TypeDef *cs_port;       /**< Chip Select GPIO port (STM32 HAL transport) */
+    uint16_t cs_pin;             /**< Chip Select GPIO pin (STM32 HAL transport) */
+#endif
+
+    uint32_t shadow[MAX30003_SHADOW_COUNT]; /**< Register shadows, indexed by MAX30003_SHADOW_x */
+    uint16_t shadow_valid;       /**< Bit (1 << MAX30003_SHADOW_x) set while that shadow matches the device */
+
+#if MAX30003_ENABLE_DMA
+    volatile uint8_t dma_busy;                       /**< Asynchronous FIFO read in progress */
+    uint8_t dma_count;                               /**< Words requested by the asynchronous read */
+    MAX30003_FIFOCpltCallbackTypeDef dma_callback;   /**< Asynchronous read completion callback */
+    uint8_t dma_tx[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH]; /**< DMA transmit buffer, zero after the command */
+    uint8_t dma_rx[1 + MAX30003_FIFO_WORD_SIZE * MAX30003_FIFO_LENGTH]; /**< DMA receive buffer */
+    uint32_t dma_fifo[MAX30003_FIFO_LENGTH];         /**< Decoded words handed to dma_callback */
+#endif
+
+    uint64_t sample_index;       /**< Samples read plus samples accounted as dropped, never decreases */
+    uint64_t samples_dropped;    /**< Samples estimated lost to FIFO overflows */
+    uint64_t sync_index;         /**< sample_index at the last SYNCH/FIFO_RST/SW_RST write */
+    uint32_t sync_tick;          /**< HAL_GetTick() at the last SYNCH/FIFO_RST/SW_RST write */
+    uint32_t overflows;          /**< Overflows handled by MAX30003_RecoverOverflow() */
+} MAX30003_HandleTypeDef;
+
+/**
+ * @brief MAX30003 register configuration, one field per shadowed register
+ */
+typedef struct {
+    uint32_t en_int;             /**< EN_INT (0x02) */
+    uint32_t en_int2;            /**< EN_INT2 (0x03) */
+    uint32_t mngr_int;           /**< MNGR_INT (0x04) */
+    uint32_t mngr_dyn;           /**< MNGR_DYN (0x05) */
+    uint32_t cnfg_gen;           /**< CNFG_GEN (0x10) */
+    uint32_t cnfg_cal;           /**< CNFG_CAL (0x12) */
+    uint32_t cnfg_emux;          /**< CNFG_EMUX (0x14) */
+    uint32_t cnfg_ecg;           /**< CNFG_ECG (0x15) */
+    uint32_t cnfg_rtor1;         /**< CNFG_RTOR1 (0x1D) */
+    uint32_t cnfg_rtor2;         /**< CNFG_RTOR2 (0x1E) */
+} MAX30003_ConfigTypeDef;
+
 /************************************************
  * Function Prototypes
  ************************************************/
@@ -462,11 +640,27 @@ typedef struct {
 extern "C" {
 #endif
 
+HAL_StatusTypeDef MAX30003_InitTransport(MAX30003_HandleTypeDef *hmax,
+                                         const MAX30003_TransportTypeDef *transport,
+                                         void *ctx);
+
+#ifdef HAL_SPI_MODULE_ENABLED
+extern const MAX30003_TransportTypeDef MAX30003_HAL_Transport;
+
 HAL_StatusTypeDef MAX30003_Init(MAX30003_HandleTypeDef *hmax,
                                 SPI_HandleTypeDef *hspi,
                                 GPIO_TypeDef *cs_port,
                                 uint16_t cs_pin);
 
+#if MAX30003_ENABLE_DMA
+void MAX30003_SPI_TxRxCpltCallback(MAX30003_HandleTypeDef *hmax,
+                                   SPI_HandleTypeDef *hspi);
+
+void MAX30003_SPI_ErrorCallback(MAX30003_HandleTypeDef *hmax,
+                                SPI_HandleTypeDef *hspi);
+#endif
+#endif
+
 HAL_StatusTypeDef MAX30003_ReadReg(MAX30003_HandleTypeDef *hmax,
                                     uint8_t reg, uint32_t *data);
 
@@ -476,6 +670,53 @@ HAL_StatusTypeDef MAX30003_WriteReg(MAX30003_HandleTypeDef *hmax,
 HAL_StatusTypeDef MAX30003_ReadFIFO(MAX30003_HandleTypeDef *hmax,
                                     uint32_t *fifo_data, uint8_t count);
 
+HAL_StatusTypeDef MAX30003_DrainFIFO(MAX30003_HandleTypeDef *hmax,
+                                     uint32_t *fifo_data, uint8_t max, uint8_t *count);
+
+HAL_StatusTypeDef MAX30003_PollFIFO(MAX30003_HandleTypeDef *hmax,
+                                    uint32_t *fifo_data, uint8_t max, uint8_t *count);
+
+#if MAX30003_ENABLE_DMA
+HAL_StatusTypeDef MAX30003_ReadFIFO_DMA(MAX30003_HandleTypeDef *hmax,
+                                        uint8_t count,
+                                        MAX30003_FIFOCpltCallbackTypeDef callback);
+
+void MAX30003_TransferCpltCallback(MAX30003_HandleTypeDef *hmax,
+                                   HAL_StatusTypeDef status);
+#endif
+
+HAL_StatusTypeDef MAX30003_GetTimebase(MAX30003_HandleTypeDef *hmax,
+                                       uint32_t *fmstr_mHz, uint32_t *ticks);
+
+HAL_StatusTypeDef MAX30003_GetSampleRate_mHz(MAX30003_HandleTypeDef *hmax,
+                                             uint32_t *rate_mHz);
+
+HAL_StatusTypeDef MAX30003_EstimateSampleIndex(MAX30003_HandleTypeDef *hmax,
+                                               uint64_t *index);
+
+HAL_StatusTypeDef MAX30003_ReadRTOR(MAX30003_HandleTypeDef *hmax,
+                                    uint16_t *rtor, uint32_t *rr_ms);
+
+HAL_StatusTypeDef MAX30003_RecoverOverflow(MAX30003_HandleTypeDef *hmax,
+                                           uint32_t *dropped);
+
+HAL_StatusTypeDef MAX30003_GetShadow(MAX30003_HandleTypeDef *hmax,
+                                     uint8_t reg, uint32_t *data);
+
+HAL_StatusTypeDef MAX30003_SyncShadow(MAX30003_HandleTypeDef *hmax);
+
+HAL_StatusTypeDef MAX30003_UpdateReg(MAX30003_HandleTypeDef *hmax,
+                                     uint8_t reg, uint32_t clear_mask, uint32_t set_bits);
+
+HAL_StatusTypeDef MAX30003_WriteField(MAX30003_HandleTypeDef *hmax,
+                                      uint8_t reg, uint8_t shift, uint32_t mask, uint32_t value);
+
+void MAX30003_ConfigDefault(MAX30003_ConfigTypeDef *cfg);
+
+HAL_StatusTypeDef MAX30003_CommitConfig(MAX30003_HandleTypeDef *hmax,
+                                        const MAX30003_ConfigTypeDef *cfg,
+                                        uint16_t *written);
+
 uint8_t MAX30003_ExtractETag(uint32_t fifo_data);
 
 uint32_t MAX30003_ExtractECGData(uint32_t fifo_data);
@@ -0,0 +1,53 @@
+/**
+ ******************************************************************************
+ * @file    max30003_atomic.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 atomic counter type for C and C++ - Header file
+ *
+ * @note    The single-producer queues keep their indices in atomic_uint_fast32_t.
+ *          C++ before C++23 has no <stdatomic.h>, so C++ translation units get
+ *          std::atomic_uint_fast32_t, which has the same size and layout as the
+ *          C type on GCC, Clang and Arm Compiler. The queue functions themselves
+ *          are compiled as C.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_ATOMIC_H_
+#define INC_MAX30003_ATOMIC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+#include <atomic>
+
+using std::atomic_uint_fast32_t;
+
+static_assert(sizeof(atomic_uint_fast32_t) == sizeof(uint_fast32_t),
+              "std::atomic_uint_fast32_t must match the C layout");
+#else
+#include <stdatomic.h>
+#endif
+
+#endif /* INC_MAX30003_ATOMIC_H_ */
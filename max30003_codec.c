@@ -0,0 +1,361 @@
+/**
+ ******************************************************************************
+ * @file    max30003_codec.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 lossless ECG codec - Source file
+ *
+ * @note    The encoder makes three short passes over the block it is given and keeps
+ *          no buffer of its own. The decoder reads through a 64-bit bit buffer and
+ *          counts unary runs with a leading-zero count where the compiler has one.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_codec.h"
+#include "max30003_pack.h"
+
+#define MAX30003_CODEC_CODE_MIN     (-(1L << 17))
+#define MAX30003_CODEC_CODE_MAX     ((1L << 17) - 1)
+#define MAX30003_CODEC_K_MAX        (MAX30003_CODEC_RAW_BITS - 1U)
+
+/* ---------------------------------------------------------------------------
+ * Prediction
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Fixed polynomial predictor of the given order.
+ */
+static int32_t MAX30003_Codec_Predict(uint32_t order, int32_t h1, int32_t h2, int32_t h3) {
+    switch (order) {
+    case 0:
+        return 0;
+    case 1:
+        return h1;
+    case 2:
+        return 2 * h1 - h2;
+    default:
+        return 3 * (h1 - h2) + h3;
+    }
+}
+
+/** @brief Signed residual to the non-negative Rice input: 0, -1, 1, -2, ... -> 0, 1, 2, 3, ... */
+static uint32_t MAX30003_Codec_ZigZag(int32_t e) {
+    return ((uint32_t)e << 1) ^ (uint32_t)(e >> 31);
+}
+
+/** @brief Bits taken by one Rice-coded value */
+static uint32_t MAX30003_Codec_RiceBits(uint32_t u, uint32_t k) {
+    const uint32_t q = u >> k;
+
+    return q < MAX30003_CODEC_ESCAPE ? q + 1U + k : MAX30003_CODEC_ESCAPE + MAX30003_CODEC_RAW_BITS;
+}
+
+/* ---------------------------------------------------------------------------
+ * Bit Writer
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    uint8_t *p;
+    uint32_t acc;               /**< Pending bits in the low `bits` positions */
+    uint32_t bits;
+} MAX30003_Codec_WriterTypeDef;
+
+/**
+ * @brief Append the n low bits of v, MSB first; n <= 24.
+ */
+static void MAX30003_Codec_Put(MAX30003_Codec_WriterTypeDef *w, uint32_t v, uint32_t n) {
+    w->acc = (w->acc << n) | v;
+    w->bits += n;
+    while (w->bits >= 8U) {
+        w->bits -= 8U;
+        *w->p++ = (uint8_t)(w->acc >> w->bits);
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Encoder
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Reset the state and make the next block a key block.
+ * @param c Encoder or decoder state.
+ * @param key_interval Blocks between key blocks, 0 for the first block only.
+ */
+void MAX30003_Codec_Init(MAX30003_CodecTypeDef *c, uint32_t key_interval) {
+    c->h1 = c->h2 = c->h3 = 0;
+    c->key_interval = key_interval;
+    c->until_key = 0;
+}
+
+/**
+ * @brief Make the next encoded block a key block, e.g. after a FIFO
+ *        overflow, so the samples on either side are not predicted from
+ *        each other.
+ */
+void MAX30003_Codec_Key(MAX30003_CodecTypeDef *c) {
+    c->until_key = 0;
+}
+
+/**
+ * @brief Encode one block of ECG codes.
+ * @details Picks the predictor order with the smallest absolute residual
+ *          sum, then the Rice parameter with the fewest bits among the
+ *          estimate from the mean and its two neighbours. Residuals whose
+ *          unary part would reach MAX30003_CODEC_ESCAPE are sent raw. If
+ *          the coded block would not be smaller than PACK18, the samples
+ *          are stored as PACK18 instead, so a block never exceeds
+ *          MAX30003_CODEC_MAX_BYTES(count). The sample count is not
+ *          stored; the framing around the block must carry it.
+ * @param c Encoder state.
+ * @param ecg Sign-extended 18-bit ECG codes.
+ * @param count Samples in the block, at least 1.
+ * @param out Output, room for MAX30003_CODEC_MAX_BYTES(count) bytes.
+ * @return Bytes written.
+ */
+uint32_t MAX30003_Codec_Encode(MAX30003_CodecTypeDef *c, const int32_t *ecg, uint32_t count, uint8_t *out) {
+    const uint32_t key = c->until_key == 0U;
+    const int32_t s1 = key ? 0 : c->h1, s2 = key ? 0 : c->h2, s3 = key ? 0 : c->h3;
+    int32_t h1 = s1, h2 = s2, h3 = s3;
+    uint64_t sum[MAX30003_CODEC_MAX_ORDER + 1U] = { 0 }, cost[3] = { 0 }, total = 0;
+    uint32_t order = 0, k, k_lo;
+    MAX30003_Codec_WriterTypeDef w;
+
+    c->until_key = key ? (c->key_interval != 0U ? c->key_interval - 1U : UINT32_MAX) : c->until_key - 1U;
+
+    /* Pass 1: residual magnitude per order, as successive differences */
+    for (uint32_t i = 0; i < count; ++i) {
+        const int32_t e0 = ecg[i], e1 = e0 - h1, e2 = e1 - (h1 - h2), e3 = e2 - ((h1 - h2) - (h2 - h3));
+
+        sum[0] += (uint32_t)(e0 < 0 ? -e0 : e0);
+        sum[1] += (uint32_t)(e1 < 0 ? -e1 : e1);
+        sum[2] += (uint32_t)(e2 < 0 ? -e2 : e2);
+        sum[3] += (uint32_t)(e3 < 0 ? -e3 : e3);
+        h3 = h2;
+        h2 = h1;
+        h1 = e0;
+    }
+    for (uint32_t o = 1; o <= MAX30003_CODEC_MAX_ORDER; ++o)
+        if (sum[o] < sum[order])
+            order = o;
+
+    /* Pass 2: exact size for 2^k just above the mean absolute residual and
+     * for its neighbours */
+    for (k = 0; k < MAX30003_CODEC_K_MAX && ((uint64_t)count << k) < sum[order]; ++k)
+        ;
+    k_lo = k > 0U ? k - 1U : 0U;
+    h1 = s1;
+    h2 = s2;
+    h3 = s3;
+    for (uint32_t i = 0; i < count; ++i) {
+        const uint32_t u = MAX30003_Codec_ZigZag(ecg[i] - MAX30003_Codec_Predict(order, h1, h2, h3));
+
+        for (uint32_t j = 0; j < 3U; ++j)
+            cost[j] += MAX30003_Codec_RiceBits(u, k_lo + j > MAX30003_CODEC_K_MAX ? MAX30003_CODEC_K_MAX : k_lo + j);
+        h3 = h2;
+        h2 = h1;
+        h1 = ecg[i];
+    }
+    c->h1 = h1;
+    c->h2 = h2;
+    c->h3 = h3;
+    k = k_lo;
+    total = cost[0];
+    for (uint32_t j = 1; j < 3U; ++j) {
+        if (k_lo + j <= MAX30003_CODEC_K_MAX && cost[j] < total) {
+            total = cost[j];
+            k = k_lo + j;
+        }
+    }
+
+    /* Pass 3: emit */
+    if ((total + 7U) / 8U >= MAX30003_PACK18_BYTES(count)) {
+        out[0] = (uint8_t)((key ? MAX30003_CODEC_HDR_KEY : 0U) | MAX30003_CODEC_VERBATIM);
+        MAX30003_Pack18(ecg, out + 1, count);
+        w.p = out + 1 + MAX30003_PACK18_BYTES(count);
+    } else {
+        w.p = out;
+        w.acc = 0;
+        w.bits = 0;
+        MAX30003_Codec_Put(&w, (key ? MAX30003_CODEC_HDR_KEY : 0U) | (order << MAX30003_CODEC_HDR_ORDER_SHIFT) | k, 8U);
+
+        h1 = s1;
+        h2 = s2;
+        h3 = s3;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t u = MAX30003_Codec_ZigZag(ecg[i] - MAX30003_Codec_Predict(order, h1, h2, h3));
+            const uint32_t q = u >> k;
+
+            if (q < MAX30003_CODEC_ESCAPE) {
+                MAX30003_Codec_Put(&w, ((1U << q) - 1U) << 1, q + 1U);     /* q ones, then a zero */
+                MAX30003_Codec_Put(&w, u & ((1U << k) - 1U), k);
+            } else {
+                MAX30003_Codec_Put(&w, (1U << MAX30003_CODEC_ESCAPE) - 1U, MAX30003_CODEC_ESCAPE);
+                MAX30003_Codec_Put(&w, u, MAX30003_CODEC_RAW_BITS);
+            }
+            h3 = h2;
+            h2 = h1;
+            h1 = ecg[i];
+        }
+        if (w.bits != 0U)
+            MAX30003_Codec_Put(&w, 0, 8U - w.bits);
+    }
+
+    return (uint32_t)(w.p - out);
+}
+
+/* ---------------------------------------------------------------------------
+ * Decoder
+ * ------------------------------------------------------------------------- */
+
+typedef struct {
+    const uint8_t *p, *end;
+    uint64_t buf;               /**< Next bits, MSB first */
+    uint32_t avail;             /**< Valid bits in buf */
+    uint32_t padding;           /**< Zero bytes fed past the end */
+} MAX30003_Codec_ReaderTypeDef;
+
+/**
+ * @brief Top up the bit buffer to at least 57 bits, padding with zeros
+ *        past the end of the input.
+ */
+static void MAX30003_Codec_Refill(MAX30003_Codec_ReaderTypeDef *r) {
+    while (r->avail <= 56U) {
+        uint64_t byte = 0;
+
+        if (r->p < r->end)
+            byte = *r->p++;
+        else
+            r->padding++;
+        r->buf |= byte << (56U - r->avail);
+        r->avail += 8U;
+    }
+}
+
+/** @brief Take n bits, 1 <= n <= 32; the buffer must hold them */
+static uint32_t MAX30003_Codec_Get(MAX30003_Codec_ReaderTypeDef *r, uint32_t n) {
+    const uint32_t v = (uint32_t)(r->buf >> (64U - n));
+
+    r->buf <<= n;
+    r->avail -= n;
+    return v;
+}
+
+/** @brief Leading one bits in the buffer, at most 64 */
+static uint32_t MAX30003_Codec_Ones(uint64_t buf) {
+#if defined(__GNUC__)
+    return ~buf == 0U ? 64U : (uint32_t)__builtin_clzll(~buf);
+#else
+    uint32_t n = 0;
+
+    while (n < 64U && (buf & (1ULL << (63U - n))) != 0U)
+        n++;
+    return n;
+#endif
+}
+
+/**
+ * @brief Decode one block.
+ * @details A key block resets the history first, so decoding can start at
+ *          any key block. The decoder cannot detect a lost non-key block;
+ *          after a loss, skip blocks until the next key block.
+ * @param c Decoder state.
+ * @param in Encoded block.
+ * @param size Bytes available at in.
+ * @param ecg Output, count sign-extended ECG codes.
+ * @param count Samples in the block, as carried by the framing.
+ * @return Bytes consumed, or 0 if the block is truncated or decodes to
+ *         values outside the 18-bit code range.
+ */
+uint32_t MAX30003_Codec_Decode(MAX30003_CodecTypeDef *c, const uint8_t *in, uint32_t size, int32_t *ecg,
+                               uint32_t count) {
+    MAX30003_Codec_ReaderTypeDef r;
+    uint32_t hdr, order, k, used;
+    int32_t h1, h2, h3;
+
+    if (size == 0U || count == 0U)
+        return 0;
+    hdr = in[0];
+    order = (hdr >> MAX30003_CODEC_HDR_ORDER_SHIFT) & 0x3U;
+    k = hdr & MAX30003_CODEC_HDR_K_MASK;
+    if ((hdr & MAX30003_CODEC_HDR_KEY) != 0U)
+        c->h1 = c->h2 = c->h3 = 0;
+    h1 = c->h1;
+    h2 = c->h2;
+    h3 = c->h3;
+
+    if (k == MAX30003_CODEC_VERBATIM) {
+        used = 1U + MAX30003_PACK18_BYTES(count);
+        if (used > size)
+            return 0;
+        MAX30003_Unpack18(in + 1, ecg, count);
+        for (uint32_t i = 0; i < count; ++i) {
+            h3 = h2;
+            h2 = h1;
+            h1 = ecg[i];
+        }
+    } else {
+        if (k > MAX30003_CODEC_K_MAX)
+            return 0;
+        r.p = in + 1;
+        r.end = in + size;
+        r.buf = 0;
+        r.avail = 0;
+        r.padding = 0;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t u, q;
+            int32_t x;
+
+            MAX30003_Codec_Refill(&r);
+            q = MAX30003_Codec_Ones(r.buf);
+            if (q >= MAX30003_CODEC_ESCAPE) {
+                MAX30003_Codec_Get(&r, MAX30003_CODEC_ESCAPE);
+                u = MAX30003_Codec_Get(&r, MAX30003_CODEC_RAW_BITS);
+            } else {
+                MAX30003_Codec_Get(&r, q + 1U);
+                u = q << k;
+                if (k != 0U)
+                    u |= MAX30003_Codec_Get(&r, k);
+            }
+
+            x = MAX30003_Codec_Predict(order, h1, h2, h3) + (int32_t)((u >> 1) ^ (0U - (u & 1U)));
+            if (x < MAX30003_CODEC_CODE_MIN || x > MAX30003_CODEC_CODE_MAX)
+                return 0;
+            ecg[i] = x;
+            h3 = h2;
+            h2 = h1;
+            h1 = x;
+        }
+
+        /* Bits taken from the stream, rounded up to the block's padding */
+        used = (uint32_t)(r.p - in) + r.padding - r.avail / 8U;
+        if (used > size)
+            return 0;
+    }
+
+    c->h1 = h1;
+    c->h2 = h2;
+    c->h3 = h3;
+    return used;
+}
@@ -0,0 +1,96 @@
+/**
+ ******************************************************************************
+ * @file    max30003_codec.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 lossless ECG codec - Header file
+ *
+ * @note    Per-block fixed polynomial prediction with Rice-coded residuals for
+ *          18-bit ECG codes; blocks are byte-aligned and bounded in size.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_CODEC_H_
+#define INC_MAX30003_CODEC_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Codec Configuration
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_CODEC_MAX_ORDER    3U      /**< Highest fixed predictor order */
+#define MAX30003_CODEC_ESCAPE       16U     /**< Unary length that switches to a raw residual */
+#define MAX30003_CODEC_RAW_BITS     22U     /**< Raw residual width, order-3 residuals of 18-bit codes */
+#define MAX30003_CODEC_VERBATIM     31U     /**< Rice parameter value marking a PACK18 block */
+
+/* Block header, one byte: key (1) | order (2) | Rice parameter (5) */
+#define MAX30003_CODEC_HDR_KEY      0x80U
+#define MAX30003_CODEC_HDR_ORDER_SHIFT 5U
+#define MAX30003_CODEC_HDR_K_MASK   0x1FU
+
+/** @brief Largest encoded block: header plus a PACK18 fallback */
+#define MAX30003_CODEC_MAX_BYTES(n) (1U + ((uint32_t)(n) * 18U + 7U) / 8U)
+
+/* ---------------------------------------------------------------------------
+ * Codec Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Encoder or decoder state
+ *
+ * Prediction runs across block boundaries, so each side keeps the last
+ * three samples. A key block starts from zero history and can be decoded
+ * on its own; the encoder emits one every key_interval blocks and after
+ * MAX30003_Codec_Key(), and the decoder resets whenever it sees the key
+ * flag.
+ */
+typedef struct {
+    int32_t h1, h2, h3;         /**< Last three samples, newest first */
+    uint32_t key_interval;      /**< Blocks between key blocks, 0 = first block only */
+    uint32_t until_key;         /**< Blocks before the next key block, 0 = next */
+} MAX30003_CodecTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Codec_Init(MAX30003_CodecTypeDef *c, uint32_t key_interval);
+
+void MAX30003_Codec_Key(MAX30003_CodecTypeDef *c);
+
+uint32_t MAX30003_Codec_Encode(MAX30003_CodecTypeDef *c, const int32_t *ecg, uint32_t count, uint8_t *out);
+
+uint32_t MAX30003_Codec_Decode(MAX30003_CodecTypeDef *c, const uint8_t *in, uint32_t size, int32_t *ecg,
+                               uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_CODEC_H_ */
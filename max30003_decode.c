@@ -0,0 +1,167 @@
+/**
+ ******************************************************************************
+ * @file    max30003_decode.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 batch FIFO word decoder - Source file
+ *
+ * @note    Cortex-M4/M7 DSP SIMD works on 8/16-bit lanes only and does not help with
+ *          24-bit words, so those cores use the unrolled scalar path.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "max30003_decode.h"
+
+#if MAX30003_DECODE_IMPL == MAX30003_DECODE_AVX2
+#include <immintrin.h>
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_SSE2
+#include <emmintrin.h>
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_MVE
+#include <arm_mve.h>
+#endif
+
+/*
+ * Data occupies bits 23:6: shifting left by 8 puts the sign bit at bit 31,
+ * an arithmetic right shift by 14 then leaves the sign-extended 18-bit code.
+ * Every supported compiler implements >> on negative int32_t as arithmetic.
+ */
+#define MAX30003_DECODE_LSHIFT  (32U - 24U)
+#define MAX30003_DECODE_RSHIFT  (MAX30003_DECODE_LSHIFT + MAX30003_ECG_VOLTAGE_DATA_SHIFT)
+
+/**
+ * @brief Decode the ECG field of one FIFO word.
+ * @param fifo_data Raw FIFO 24-bit word.
+ * @return Sign-extended 18-bit ECG code.
+ */
+int32_t MAX30003_DecodeSample(uint32_t fifo_data) {
+    return (int32_t)(fifo_data << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+}
+
+/**
+ * @brief Portable reference decoder.
+ * @param fifo_data Raw FIFO words.
+ * @param ecg Output, sign-extended ECG codes (count entries).
+ * @param etag Output, ETAG codes (count entries).
+ * @param count Number of words.
+ */
+void MAX30003_DecodeFIFO_Scalar(const uint32_t *fifo_data, int32_t *ecg, uint8_t *etag, uint32_t count) {
+    uint32_t i = 0;
+
+    for (; i + 4U <= count; i += 4U) {
+        uint32_t w0 = fifo_data[i], w1 = fifo_data[i + 1U];
+        uint32_t w2 = fifo_data[i + 2U], w3 = fifo_data[i + 3U];
+
+        ecg[i]      = (int32_t)(w0 << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+        ecg[i + 1U] = (int32_t)(w1 << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+        ecg[i + 2U] = (int32_t)(w2 << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+        ecg[i + 3U] = (int32_t)(w3 << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+        etag[i]      = (uint8_t)((w0 >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK);
+        etag[i + 1U] = (uint8_t)((w1 >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK);
+        etag[i + 2U] = (uint8_t)((w2 >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK);
+        etag[i + 3U] = (uint8_t)((w3 >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK);
+    }
+
+    for (; i < count; ++i) {
+        ecg[i] = (int32_t)(fifo_data[i] << MAX30003_DECODE_LSHIFT) >> MAX30003_DECODE_RSHIFT;
+        etag[i] = (uint8_t)((fifo_data[i] >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK);
+    }
+}
+
+/**
+ * @brief Decode a block of FIFO words into ECG codes and ETAGs.
+ * @details Uses the vector path selected by MAX30003_DECODE_IMPL; the tail
+ *          that does not fill a vector goes through the scalar decoder.
+ *          Buffers need no particular alignment.
+ * @param fifo_data Raw FIFO words, as returned by MAX30003_ReadFIFO().
+ * @param ecg Output, sign-extended ECG codes (count entries).
+ * @param etag Output, ETAG codes (count entries).
+ * @param count Number of words.
+ */
+void MAX30003_DecodeFIFO(const uint32_t *fifo_data, int32_t *ecg, uint8_t *etag, uint32_t count) {
+    uint32_t i = 0;
+
+#if MAX30003_DECODE_IMPL == MAX30003_DECODE_AVX2
+    const __m256i mask = _mm256_set1_epi32(MAX30003_ETAG_MASK);
+    /* Byte 0 of each dword to the low 4 bytes of its 128-bit lane */
+    const __m256i pick = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+
+    for (; i + 8U <= count; i += 8U) {
+        __m256i w = _mm256_loadu_si256((const __m256i *)(fifo_data + i));
+        __m256i s = _mm256_srai_epi32(_mm256_slli_epi32(w, MAX30003_DECODE_LSHIFT), MAX30003_DECODE_RSHIFT);
+        __m256i t = _mm256_shuffle_epi8(_mm256_and_si256(_mm256_srli_epi32(w, MAX30003_ETAG_SHIFT), mask), pick);
+        uint32_t lo = (uint32_t)_mm_cvtsi128_si32(_mm256_castsi256_si128(t));
+        uint32_t hi = (uint32_t)_mm_cvtsi128_si32(_mm256_extracti128_si256(t, 1));
+
+        _mm256_storeu_si256((__m256i *)(ecg + i), s);
+        memcpy(etag + i, &lo, 4);
+        memcpy(etag + i + 4U, &hi, 4);
+    }
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_SSE2
+    const __m128i mask = _mm_set1_epi32(MAX30003_ETAG_MASK);
+
+    for (; i + 4U <= count; i += 4U) {
+        __m128i w = _mm_loadu_si128((const __m128i *)(fifo_data + i));
+        __m128i s = _mm_srai_epi32(_mm_slli_epi32(w, MAX30003_DECODE_LSHIFT), MAX30003_DECODE_RSHIFT);
+        __m128i t = _mm_and_si128(_mm_srli_epi32(w, MAX30003_ETAG_SHIFT), mask);
+        uint32_t packed;
+
+        /* 0..7 survive both saturating narrows unchanged */
+        t = _mm_packus_epi16(_mm_packs_epi32(t, t), t);
+        packed = (uint32_t)_mm_cvtsi128_si32(t);
+
+        _mm_storeu_si128((__m128i *)(ecg + i), s);
+        memcpy(etag + i, &packed, 4);
+    }
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_MVE
+    for (; i + 4U <= count; i += 4U) {
+        uint32x4_t w = vld1q_u32(fifo_data + i);
+        int32x4_t s = vshrq_n_s32(vreinterpretq_s32_u32(vshlq_n_u32(w, MAX30003_DECODE_LSHIFT)),
+                                  MAX30003_DECODE_RSHIFT);
+        uint32x4_t t = vandq_u32(vshrq_n_u32(w, MAX30003_ETAG_SHIFT), vdupq_n_u32(MAX30003_ETAG_MASK));
+
+        vst1q_s32(ecg + i, s);
+        vstrbq_u32(etag + i, t);    /* Narrowing store, one byte per lane */
+    }
+#endif
+
+    if (i < count)
+        MAX30003_DecodeFIFO_Scalar(fifo_data + i, ecg + i, etag + i, count - i);
+}
+
+/**
+ * @brief Name of the decoder path compiled in, for logs and benchmarks.
+ */
+const char *MAX30003_DecodeImplName(void) {
+#if MAX30003_DECODE_IMPL == MAX30003_DECODE_AVX2
+    return "avx2";
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_SSE2
+    return "sse2";
+#elif MAX30003_DECODE_IMPL == MAX30003_DECODE_MVE
+    return "mve";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,82 @@
+/**
+ ******************************************************************************
+ * @file    max30003_decode.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 batch FIFO word decoder - Header file
+ *
+ * @note    Splits raw FIFO words into sign-extended ECG codes and ETAGs in one pass.
+ *          SSE2/AVX2 on x86 hosts, Helium (MVE) on Cortex-M55/M85, scalar otherwise.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_DECODE_H_
+#define INC_MAX30003_DECODE_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Decoder Implementation Selection
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_DECODE_SCALAR  0U  /**< Portable C */
+#define MAX30003_DECODE_SSE2    1U  /**< x86 SSE2, 4 words per step */
+#define MAX30003_DECODE_AVX2    2U  /**< x86 AVX2, 8 words per step */
+#define MAX30003_DECODE_MVE     3U  /**< Arm Helium (M-profile vector extension), 4 words per step */
+
+/* Picked from the compiler's target flags; define to MAX30003_DECODE_SCALAR
+ * to force the portable path */
+#ifndef MAX30003_DECODE_IMPL
+#if defined(__AVX2__)
+#define MAX30003_DECODE_IMPL    MAX30003_DECODE_AVX2
+#elif defined(__SSE2__)
+#define MAX30003_DECODE_IMPL    MAX30003_DECODE_SSE2
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#define MAX30003_DECODE_IMPL    MAX30003_DECODE_MVE
+#else
+#define MAX30003_DECODE_IMPL    MAX30003_DECODE_SCALAR
+#endif
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t MAX30003_DecodeSample(uint32_t fifo_data);
+
+void MAX30003_DecodeFIFO(const uint32_t *fifo_data, int32_t *ecg, uint8_t *etag, uint32_t count);
+
+void MAX30003_DecodeFIFO_Scalar(const uint32_t *fifo_data, int32_t *ecg, uint8_t *etag, uint32_t count);
+
+const char *MAX30003_DecodeImplName(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_DECODE_H_ */
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    max30003_efit.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 adaptive EFIT controller - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_efit.h"
+
+/**
+ * @brief Program a new threshold through the MNGR_INT shadow.
+ * @details One SPI write; nothing is sent if the value is unchanged.
+ */
+static HAL_StatusTypeDef MAX30003_EFIT_Apply(MAX30003_EFIT_ControllerTypeDef *ctl,
+                                             MAX30003_HandleTypeDef *hmax, uint8_t efit) {
+    HAL_StatusTypeDef status;
+
+    if (efit == ctl->efit)
+        return HAL_OK;
+
+    status = MAX30003_WriteField(hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_EFIT_SHIFT,
+                                 MAX30003_MNGR_INT_EFIT_MASK, efit - 1U);
+    if (status != HAL_OK)
+        return status;
+
+    if (efit > ctl->efit)
+        ctl->raises++;
+    else
+        ctl->lowers++;
+    ctl->efit = efit;
+    ctl->stable = 0;
+    return HAL_OK;
+}
+
+/**
+ * @brief Initialize the controller from the threshold currently programmed.
+ * @param ctl Controller state.
+ * @param hmax Device handle; EFIT is taken from the MNGR_INT shadow.
+ * @param rate_mHz ECG sample rate in mHz, or 0 to ignore latency_us.
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_EFIT_Init(MAX30003_EFIT_ControllerTypeDef *ctl,
+                                     MAX30003_HandleTypeDef *hmax, uint32_t rate_mHz) {
+    uint32_t mngr_int;
+    HAL_StatusTypeDef status;
+
+    if ((status = MAX30003_GetShadow(hmax, MAX30003_REG_MNGR_INT, &mngr_int)) != HAL_OK)
+        return status;
+
+    ctl->efit = ((mngr_int >> MAX30003_MNGR_INT_EFIT_SHIFT) & MAX30003_MNGR_INT_EFIT_MASK) + 1U;
+    ctl->min_efit = MAX30003_EFIT_MIN;
+    ctl->max_efit = MAX30003_EFIT_MAX;
+    ctl->margin = MAX30003_EFIT_DEFAULT_MARGIN;
+    ctl->raise_after = MAX30003_EFIT_DEFAULT_RAISE;
+    ctl->stable = 0;
+    ctl->peak_backlog_q = 0;
+    ctl->rate_mHz = rate_mHz;
+    ctl->raises = 0;
+    ctl->lowers = 0;
+    return HAL_OK;
+}
+
+/**
+ * @brief Feed one EINT service into the controller.
+ * @details Call after each FIFO drain. Writes MNGR_INT at most once.
+ * @param ctl Controller state.
+ * @param hmax Device handle.
+ * @param words Words read by the drain (MAX30003_DrainFIFO() count).
+ * @param latency_us Time from INTB assertion to the drain, 0 if unknown.
+ * @param overflow Non-zero if EOVF or an OVERFLOW word was seen.
+ * @return HAL status of the MNGR_INT write, HAL_OK if none was needed.
+ */
+HAL_StatusTypeDef MAX30003_EFIT_Update(MAX30003_EFIT_ControllerTypeDef *ctl,
+                                       MAX30003_HandleTypeDef *hmax,
+                                       uint8_t words, uint32_t latency_us, uint8_t overflow) {
+    uint32_t backlog = words > ctl->efit ? (uint32_t)(words - ctl->efit) : 0U;
+    uint32_t peak, limit;
+
+    /* Latency in samples, rounded up; covers words the drain may have missed */
+    if (ctl->rate_mHz != 0U) {
+        uint32_t late = (uint32_t)(((uint64_t)latency_us * ctl->rate_mHz + 999999999ULL) / 1000000000ULL);
+        if (late > backlog)
+            backlog = late;
+    }
+    if (overflow)
+        backlog = MAX30003_FIFO_LENGTH;
+
+    peak = (uint32_t)ctl->peak_backlog_q;
+    if (backlog << MAX30003_EFIT_PEAK_DECAY_SHIFT >= peak)
+        peak = backlog << MAX30003_EFIT_PEAK_DECAY_SHIFT;
+    else
+        peak--;
+    ctl->peak_backlog_q = (uint16_t)peak;
+
+    /* Round the decaying peak up, so it only relaxes a full word at a time */
+    peak = (peak + (1U << MAX30003_EFIT_PEAK_DECAY_SHIFT) - 1U) >> MAX30003_EFIT_PEAK_DECAY_SHIFT;
+    limit = peak + ctl->margin < MAX30003_FIFO_LENGTH ? MAX30003_FIFO_LENGTH - peak - ctl->margin : 0U;
+    if (limit > ctl->max_efit)
+        limit = ctl->max_efit;
+    if (limit < ctl->min_efit)
+        limit = ctl->min_efit;
+
+    if (ctl->efit > limit)
+        return MAX30003_EFIT_Apply(ctl, hmax, (uint8_t)limit);
+
+    /* Headroom must be consecutive: a service at the limit restarts the count */
+    if (ctl->efit >= limit) {
+        ctl->stable = 0;
+        return HAL_OK;
+    }
+    if (++ctl->stable >= ctl->raise_after)
+        return MAX30003_EFIT_Apply(ctl, hmax, ctl->efit + 1U);
+
+    return HAL_OK;
+}
@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * @file    max30003_efit.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 adaptive EFIT controller - Header file
+ *
+ * @note    Tunes the ECG FIFO interrupt threshold at runtime from the observed FIFO
+ *          fill at service time, trading wakeups against overflow headroom.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_EFIT_H_
+#define INC_MAX30003_EFIT_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Controller Defaults
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_EFIT_MIN               1U      /**< Lowest threshold the controller will set */
+#define MAX30003_EFIT_MAX               MAX30003_FIFO_LENGTH
+#define MAX30003_EFIT_DEFAULT_MARGIN    2U      /**< Words kept free above the worst observed fill */
+#define MAX30003_EFIT_DEFAULT_RAISE     8U      /**< Services with headroom before EFIT is raised by one */
+#define MAX30003_EFIT_PEAK_DECAY_SHIFT  4U      /**< Backlog peak decays one word per 2^n services */
+
+/* ---------------------------------------------------------------------------
+ * Controller Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Adaptive EFIT controller state
+ *
+ * Backlog is the number of words that arrived between EFIT being reached and
+ * the FIFO being drained, i.e. service latency in samples. The controller
+ * keeps efit + peak backlog + margin <= 32: it lowers EFIT at once when the
+ * backlog grows, and raises it one step at a time after raise_after
+ * consecutive services that would still fit.
+ */
+typedef struct {
+    uint8_t efit;               /**< Threshold currently programmed (1-32) */
+    uint8_t min_efit;           /**< Lower bound */
+    uint8_t max_efit;           /**< Upper bound */
+    uint8_t margin;             /**< Spare words to keep below the FIFO depth */
+    uint16_t raise_after;       /**< Services with headroom required before raising */
+    uint16_t stable;            /**< Consecutive services with headroom */
+    uint16_t peak_backlog_q;    /**< Decaying peak backlog, words << MAX30003_EFIT_PEAK_DECAY_SHIFT */
+    uint32_t rate_mHz;          /**< Sample rate, to convert latency into words (0 = words only) */
+    uint32_t raises;            /**< Number of increases written */
+    uint32_t lowers;            /**< Number of decreases written */
+} MAX30003_EFIT_ControllerTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef MAX30003_EFIT_Init(MAX30003_EFIT_ControllerTypeDef *ctl,
+                                     MAX30003_HandleTypeDef *hmax, uint32_t rate_mHz);
+
+HAL_StatusTypeDef MAX30003_EFIT_Update(MAX30003_EFIT_ControllerTypeDef *ctl,
+                                       MAX30003_HandleTypeDef *hmax,
+                                       uint8_t words, uint32_t latency_us, uint8_t overflow);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_EFIT_H_ */
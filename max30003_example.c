@@ -30,7 +30,17 @@
  ******************************************************************************
  */
 
-#include "max30003.h"
+#include "max30003_example.h"
+
+/**
+ * @brief Samples read by MAX30003_IRQHandler(), drained by the application
+ */
+MAX30003_RingTypeDef MAX30003_SampleRing;
+
+/**
+ * @brief R events read by MAX30003_IRQHandler(), drained by the application
+ */
+MAX30003_RRQueueTypeDef MAX30003_RRQueue;
 
 /**
  * @brief  Handles the interrupts from MAX30003
@@ -38,13 +48,24 @@
  */
 void MAX30003_IRQHandler(MAX30003_HandleTypeDef *hmax) {
     uint32_t enabled_active;
+    uint32_t fifo[MAX30003_FIFO_LENGTH];
+    uint8_t count;
+    uint32_t dropped;
 
     // 1. Read critical registers first
     MAX30003_GetInterruptStatus(hmax, &enabled_active);
 
     // 2. Handle enabled interrupts
-    if(enabled_active & MAX30003_INT_EINT) MAX30003_ReadFIFO(hmax, NULL, MAX30003_FIFO_LENGTH); // Read FIFO to clear interrupt
-    if(enabled_active & MAX30003_INT_EOVF) MAX30003_WriteReg(hmax, MAX30003_REG_FIFO_RST, MAX30003_FIFO_RST_D); // Clear FIFO overflow
+    if(enabled_active & MAX30003_INT_EINT) {
+        // Read FIFO to clear interrupt and hand the samples to the main loop
+        if(MAX30003_DrainFIFO(hmax, fifo, MAX30003_FIFO_LENGTH, &count) == HAL_OK)
+            MAX30003_Ring_PushFIFO(&MAX30003_SampleRing, fifo, count);
+    }
+    if(enabled_active & MAX30003_INT_EOVF) {
+        // Reset the FIFO and tell the consumer how many samples are missing
+        if(MAX30003_RecoverOverflow(hmax, &dropped) == HAL_OK)
+            MAX30003_Ring_PushGap(&MAX30003_SampleRing, dropped);
+    }
     if(enabled_active & MAX30003_INT_FSTINT) {
     }
     if(enabled_active & MAX30003_INT_DCLOFFINT) {
@@ -52,6 +73,8 @@ void MAX30003_IRQHandler(MAX30003_HandleTypeDef *hmax) {
     if(enabled_active & MAX30003_INT_LONINT) {
     }
     if(enabled_active & MAX30003_INT_RRINT) {
+        // Read RTOR and queue the beat; after EINT so sample_index is current
+        MAX30003_RR_HandleInterrupt(&MAX30003_RRQueue, hmax, NULL);
     }
     if(enabled_active & MAX30003_INT_SAMP) {
     }
@@ -86,37 +109,13 @@ void MAX30003_HandleETag(uint8_t etag, int32_t ecg_sample) {
             break;
     }
 }
-/** 
- * @brief  Configure MAX30003 registers with default values
- * @param  hmax Pointer to MAX30003 handle
- * @retval HAL status
- */
-HAL_StatusTypeDef MAX30003_ConfigureRegistersDefault(MAX30003_HandleTypeDef *hmax) {
-    HAL_StatusTypeDef ret;
-    
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_EN_INT, MAX30003_EN_INT_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_EN_INT2, MAX30003_EN_INT_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_MNGR_DYN, MAX30003_MNGR_DYN_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_GEN, MAX30003_CNFG_GEN_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_CAL, MAX30003_CNFG_CAL_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_EMUX, MAX30003_CNFG_EMUX_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_ECG, MAX30003_CNFG_ECG_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_RTOR1, MAX30003_CNFG_RTOR_DEFAULT_CONFIG)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_RTOR2, MAX30003_CNFG_RTOR2_DEFAULT_CONFIG)) != HAL_OK) return ret;
-
-    return HAL_OK;
-}
 
 /**
- * @brief  Configure MAX30003 registers with custom values
- * @param  hmax Pointer to MAX30003 handle
- * @retval HAL status
+ * @brief  Fill a configuration with the example custom register values
+ * @param  cfg Configuration to fill
  */
-HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax) {
-    HAL_StatusTypeDef ret;
-
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_EN_INT, MAX30003_EN_INT_DEFAULT_CONFIG
+void MAX30003_GetExampleConfig(MAX30003_ConfigTypeDef *cfg) {
+    cfg->en_int = MAX30003_EN_INT_DEFAULT_CONFIG
         | MAX30003_EN_INT_EINT_EN
         | MAX30003_EN_INT_EOVF_EN
         | MAX30003_EN_INT_FSTINT_DIS
@@ -125,8 +124,8 @@ HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax) {
         | MAX30003_EN_INT_RRINT_DIS
         | MAX30003_EN_INT_SAMP_DIS
         | MAX30003_EN_INT_PLLINT_DIS
-        | MAX30003_EN_INT_INTB_TYPE_OPEN_DRAIN_125K_PULLUP)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_EN_INT2, MAX30003_EN_INT_DEFAULT_CONFIG
+        | MAX30003_EN_INT_INTB_TYPE_OPEN_DRAIN_125K_PULLUP;
+    cfg->en_int2 = MAX30003_EN_INT_DEFAULT_CONFIG
         | MAX30003_EN_INT_EINT_EN
         | MAX30003_EN_INT_EOVF_EN
         | MAX30003_EN_INT_FSTINT_DIS
@@ -135,17 +134,17 @@ HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax) {
         | MAX30003_EN_INT_RRINT_DIS
         | MAX30003_EN_INT_SAMP_DIS
         | MAX30003_EN_INT_PLLINT_DIS
-        | MAX30003_EN_INT_INTB_TYPE_OPEN_DRAIN_125K_PULLUP)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_MNGR_INT, MAX30003_MNGR_INT_DEFAULT_CONFIG
+        | MAX30003_EN_INT_INTB_TYPE_OPEN_DRAIN_125K_PULLUP;
+    cfg->mngr_int = MAX30003_MNGR_INT_DEFAULT_CONFIG
         | MAX30003_MNGR_INT_EFIT_32 
         | MAX30003_MNGR_INT_CLR_FAST_DIS
         | MAX30003_MNGR_INT_CLR_RRINT_ON_STATUS_REGISTER_READ_BACK
         | MAX30003_MNGR_INT_CLR_SAMP_SELF_CLEAR
-        | MAX30003_MNGR_INT_SAMP_IT_EVERY_SAMPLE)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_MNGR_DYN, MAX30003_MNGR_DYN_DEFAULT_CONFIG
+        | MAX30003_MNGR_INT_SAMP_IT_EVERY_SAMPLE;
+    cfg->mngr_dyn = MAX30003_MNGR_DYN_DEFAULT_CONFIG
         | MAX30003_MNGR_DYN_FAST_NORMAL_MODE
-        | (0x3F << MAX30003_MNGR_DYN_FAST_TH_SHIFT))) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_GEN, MAX30003_CNFG_GEN_DEFAULT_CONFIG
+        | (0x3F << MAX30003_MNGR_DYN_FAST_TH_SHIFT);
+    cfg->cnfg_gen = MAX30003_CNFG_GEN_DEFAULT_CONFIG
         | MAX30003_CNFG_GEN_EN_ULP_LON_DIS
         | MAX30003_CNFG_GEN_FMSTR_512HZ_ECG_PROGGRESION
         | MAX30003_CNFG_GEN_EN_ECG_EN
@@ -156,35 +155,60 @@ HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax) {
         | MAX30003_CNFG_GEN_EN_RBIAS_DIS
         | MAX30003_CNFG_GEN_RBIASV_100M
         | MAX30003_CNFG_GEN_RBIASP_DIS
-        | MAX30003_CNFG_GEN_RBIASN_DIS)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_CAL, MAX30003_CNFG_CAL_DEFAULT_CONFIG
+        | MAX30003_CNFG_GEN_RBIASN_DIS;
+    cfg->cnfg_cal = MAX30003_CNFG_CAL_DEFAULT_CONFIG
         | MAX30003_CNFG_CAL_EN_VCAL_DIS
         | MAX30003_CNFG_CAL_VMODE_UNIPOLAR
         | MAX30003_CNFG_CAL_VMAG_0_25mV
         | MAX30003_CNFG_CAL_FCAL_1Hz
         | MAX30003_CNFG_CAL_FIFTY_DUTY_50
-        | (0x000 << MAX30003_CNFG_CAL_THIGH_SHIFT))) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_EMUX, MAX30003_CNFG_EMUX_DEFAULT_CONFIG
+        | (0x000 << MAX30003_CNFG_CAL_THIGH_SHIFT);
+    cfg->cnfg_emux = MAX30003_CNFG_EMUX_DEFAULT_CONFIG
         | MAX30003_CNFG_EMUX_POL_NON_INVERTED
         | MAX30003_CNFG_EMUX_OPENP_INTERNALLY_ISOLATED
         | MAX30003_CNFG_EMUX_OPENN_INTERNALLY_ISOLATED
         | MAX30003_CNFG_EMUX_CALP_SEL_NONE
-        | MAX30003_CNFG_EMUX_CALN_SEL_NONE)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_ECG, MAX30003_CNFG_ECG_DEFAULT_CONFIG
+        | MAX30003_CNFG_EMUX_CALN_SEL_NONE;
+    cfg->cnfg_ecg = MAX30003_CNFG_ECG_DEFAULT
         | MAX30003_CNFG_ECG_RATE_512
         | MAX30003_CNFG_ECG_GAIN_80
         | MAX30003_CNFG_ECG_DHPF_EN
-        | MAX30003_CNFG_ECG_DLPF_40)) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_RTOR1, MAX30003_CNFG_RTOR_DEFAULT_CONFIG
+        | MAX30003_CNFG_ECG_DLPF_40;
+    cfg->cnfg_rtor1 = MAX30003_CNFG_RTOR_DEFAULT_CONFIG
         | MAX30003_CNFG_RTOR_eWNDW_12
         | MAX30003_CNFG_RTOR_GAIN_DEFAULT
         | MAX30003_CNFG_RTOR_EN_RTOR_DIS
         | MAX30003_CNFG_RTOR_PAVG_DEFAULT
-        | (0x3 << MAX30003_CNFG_RTOR_PTSF_SHIFT))) != HAL_OK) return ret;
-    if((ret = MAX30003_WriteReg(hmax, MAX30003_REG_CNFG_RTOR2, MAX30003_CNFG_RTOR2_DEFAULT_CONFIG
+        | (0x3 << MAX30003_CNFG_RTOR_PTSF_SHIFT);
+    cfg->cnfg_rtor2 = MAX30003_CNFG_RTOR2_DEFAULT_CONFIG
         | (0x20 << MAX30003_CNFG_RTOR2_HOFF_SHIFT)
         | MAX30003_CNFG_RTOR2_RAVG_DEFAULT
-        | (0x4 << MAX30003_CNFG_RTOR2_RHSF_SHIFT))) != HAL_OK) return ret;
+        | (0x4 << MAX30003_CNFG_RTOR2_RHSF_SHIFT);
+}
+
+/** 
+ * @brief  Configure MAX30003 registers with default values
+ * @details Only registers whose shadow differs from the default are written.
+ * @param  hmax Pointer to MAX30003 handle
+ * @retval HAL status
+ */
+HAL_StatusTypeDef MAX30003_ConfigureRegistersDefault(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_ConfigTypeDef cfg;
+
+    MAX30003_ConfigDefault(&cfg);
+    return MAX30003_CommitConfig(hmax, &cfg, NULL);
+}
+
+/**
+ * @brief  Configure MAX30003 registers with custom values
+ * @details Only registers whose shadow differs from the example configuration
+ *          are written.
+ * @param  hmax Pointer to MAX30003 handle
+ * @retval HAL status
+ */
+HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_ConfigTypeDef cfg;
 
-    return HAL_OK;
+    MAX30003_GetExampleConfig(&cfg);
+    return MAX30003_CommitConfig(hmax, &cfg, NULL);
 }
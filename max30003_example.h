@@ -34,11 +34,19 @@
 #define INC_MAX30003_EXAMPLE_H_
 
 #include "max30003.h"
+#include "max30003_ring.h"
+#include "max30003_rtor.h"
+
+extern MAX30003_RingTypeDef MAX30003_SampleRing;
+
+extern MAX30003_RRQueueTypeDef MAX30003_RRQueue;
 
 void MAX30003_IRQHandler(MAX30003_HandleTypeDef *hmax);
 
 void MAX30003_HandleETag(uint8_t etag, int32_t ecg_sample);
 
+void MAX30003_GetExampleConfig(MAX30003_ConfigTypeDef *cfg);
+
 HAL_StatusTypeDef MAX30003_ConfigureRegistersDefault(MAX30003_HandleTypeDef *hmax);
 
 HAL_StatusTypeDef MAX30003_ConfigureRegisters(MAX30003_HandleTypeDef *hmax);
@@ -0,0 +1,395 @@
+/**
+ ******************************************************************************
+ * @file    max30003_filter.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 Q31 biquad filter bank - Source file
+ *
+ * @note    Cortex-M4/M7 DSP SIMD (SMLAD etc.) works on 16-bit lanes and cannot hold Q31
+ *          samples; those cores use the scalar path, whose 32x32+64 MACs compile to
+ *          SMLAL. The x86 paths run neighbouring channels in parallel lanes.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <math.h>
+#include <string.h>
+#include "max30003_filter.h"
+
+#if MAX30003_FILTER_IMPL == MAX30003_FILTER_AVX2
+#include <immintrin.h>
+#elif MAX30003_FILTER_IMPL == MAX30003_FILTER_SSE41
+#include <smmintrin.h>
+#endif
+
+#define MAX30003_FILTER_ONE         (1LL << MAX30003_FILTER_COEFF_FRAC)
+#define MAX30003_FILTER_ERR_MASK    (MAX30003_FILTER_ONE - 1)
+#define MAX30003_FILTER_PI          3.14159265358979323846
+
+/* Section shapes */
+#define MAX30003_FILTER_LOWPASS     0U
+#define MAX30003_FILTER_HIGHPASS    1U
+#define MAX30003_FILTER_NOTCH       2U
+
+/* Pole Q of the two sections of a 4th-order Butterworth, 1 / (2 cos(k pi / 8)) for k = 3, 1;
+ * the flat section goes first so the peaking one sees a band-limited input */
+static const double MAX30003_Filter_ButterQ[2] = { 0.54119610014619698, 1.30656296487637652 };
+
+/* ---------------------------------------------------------------------------
+ * Design
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Round a coefficient to Q2.30, saturating.
+ */
+static int32_t MAX30003_Filter_Q30(double v) {
+    double q = floor(v * MAX30003_FILTER_ONE + 0.5);
+
+    if (q > 2147483647.0)
+        return INT32_MAX;
+    if (q < -2147483648.0)
+        return INT32_MIN;
+    return (int32_t)q;
+}
+
+/**
+ * @brief Bilinear-transform biquad (RBJ cookbook forms).
+ * @details The numerator is built from b0 in integer arithmetic, so the
+ *          high-pass has an exact zero at DC, the low-pass an exact zero at
+ *          Nyquist and the notch a symmetric numerator.
+ * @param q Output section.
+ * @param shape MAX30003_FILTER_LOWPASS, _HIGHPASS or _NOTCH.
+ * @param w0 Centre or corner frequency, radians per sample.
+ * @param Q Pole quality factor.
+ */
+static void MAX30003_Filter_Design(MAX30003_BiquadTypeDef *q, uint8_t shape, double w0, double Q) {
+    const double cw = cos(w0), alpha = sin(w0) / (2.0 * Q), a0 = 1.0 + alpha;
+
+    q->na1 = MAX30003_Filter_Q30(2.0 * cw / a0);
+    q->na2 = MAX30003_Filter_Q30(-(1.0 - alpha) / a0);
+
+    switch (shape) {
+    case MAX30003_FILTER_LOWPASS:
+        q->b0 = MAX30003_Filter_Q30((1.0 - cw) / 2.0 / a0);
+        q->b1 = 2 * q->b0;
+        break;
+    case MAX30003_FILTER_HIGHPASS:
+        q->b0 = MAX30003_Filter_Q30((1.0 + cw) / 2.0 / a0);
+        q->b1 = -2 * q->b0;
+        break;
+    default:
+        q->b0 = MAX30003_Filter_Q30(1.0 / a0);
+        q->b1 = MAX30003_Filter_Q30(-2.0 * cw / a0);
+        break;
+    }
+    q->b2 = q->b0;
+}
+
+/**
+ * @brief Design the cascade and clear all channel state.
+ * @details Sections run high-pass, notch, low-pass. Design uses double
+ *          precision once; processing is integer only.
+ * @param fb Filter bank.
+ * @param channels Channels to run, 1..MAX30003_FILTER_CHANNELS.
+ * @param rate_mHz Sample rate, e.g. from MAX30003_GetSampleRate_mHz().
+ * @param cfg Corner frequencies, or NULL for the defaults (0.5 Hz, 50 Hz, 40 Hz).
+ * @return HAL_OK, or HAL_ERROR if a frequency is not below Nyquist.
+ */
+HAL_StatusTypeDef MAX30003_Filter_Init(MAX30003_FilterBankTypeDef *fb, uint32_t channels, uint32_t rate_mHz,
+                                       const MAX30003_FilterConfigTypeDef *cfg) {
+    static const MAX30003_FilterConfigTypeDef defaults = {
+        MAX30003_FILTER_HP_mHz, MAX30003_FILTER_NOTCH_mHz, MAX30003_FILTER_LP_mHz
+    };
+    const double rad_per_mHz = 2.0 * MAX30003_FILTER_PI / rate_mHz;
+
+    if (fb == NULL || channels == 0U || channels > MAX30003_FILTER_CHANNELS || rate_mHz == 0U)
+        return HAL_ERROR;
+    if (cfg == NULL)
+        cfg = &defaults;
+    if (cfg->hp_mHz >= rate_mHz / 2U || cfg->notch_mHz >= rate_mHz / 2U || cfg->lp_mHz >= rate_mHz / 2U)
+        return HAL_ERROR;
+
+    memset(fb, 0, sizeof(*fb));
+    fb->channels = channels;
+
+    if (cfg->hp_mHz != 0U)
+        for (uint32_t i = 0; i < MAX30003_FILTER_HP_SECTIONS; ++i)
+            MAX30003_Filter_Design(&fb->sec[fb->sections++], MAX30003_FILTER_HIGHPASS,
+                                   cfg->hp_mHz * rad_per_mHz, MAX30003_Filter_ButterQ[i]);
+    if (cfg->notch_mHz != 0U)
+        MAX30003_Filter_Design(&fb->sec[fb->sections++], MAX30003_FILTER_NOTCH, cfg->notch_mHz * rad_per_mHz,
+                               (double)cfg->notch_mHz / MAX30003_FILTER_NOTCH_BW_mHz);
+    if (cfg->lp_mHz != 0U)
+        for (uint32_t i = 0; i < MAX30003_FILTER_LP_SECTIONS; ++i)
+            MAX30003_Filter_Design(&fb->sec[fb->sections++], MAX30003_FILTER_LOWPASS,
+                                   cfg->lp_mHz * rad_per_mHz, MAX30003_Filter_ButterQ[i]);
+    return HAL_OK;
+}
+
+/**
+ * @brief Set one channel to the steady state for a constant input.
+ * @details Starting from the electrode offset instead of zero keeps the
+ *          high-pass from ringing for several seconds after start-up or a
+ *          lead-off episode. Pass 0 to clear the channel.
+ * @param fb Filter bank.
+ * @param channel Channel index.
+ * @param ecg ECG code the channel is assumed to have been at.
+ */
+void MAX30003_Filter_Reset(MAX30003_FilterBankTypeDef *fb, uint32_t channel, int32_t ecg) {
+    int64_t x = (int64_t)ecg * (1 << MAX30003_FILTER_SHIFT);
+
+    if (channel >= fb->channels)
+        return;
+
+    for (uint32_t s = 0; s < fb->sections; ++s) {
+        const MAX30003_BiquadTypeDef *q = &fb->sec[s];
+        const int64_t num = (int64_t)q->b0 + q->b1 + q->b2;
+        const int64_t den = MAX30003_FILTER_ONE - q->na1 - q->na2;
+        int64_t y = den > 0 ? num * x / den : 0;
+
+        fb->x1[s][channel] = fb->x2[s][channel] = (int32_t)x;
+        fb->y1[s][channel] = fb->y2[s][channel] = (int32_t)y;
+        fb->err[s][channel] = 0;
+        x = y;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Processing
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Scale ECG codes into the Q31 working range.
+ */
+static void MAX30003_Filter_Load(const int32_t *ecg, int32_t *out, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i)
+        out[i] = (int32_t)((uint32_t)ecg[i] << MAX30003_FILTER_SHIFT);
+}
+
+/**
+ * @brief Run every section over one channel's block, in place.
+ * @details Section state lives in registers for the whole block. The
+ *          64-bit accumulator starts from the bits truncated on the
+ *          previous sample, and the output keeps bits 61:30 of the sum.
+ */
+static void MAX30003_Filter_Channel(MAX30003_FilterBankTypeDef *fb, uint32_t c, int32_t *buf, uint32_t count) {
+    for (uint32_t s = 0; s < fb->sections; ++s) {
+        const int32_t b0 = fb->sec[s].b0, b1 = fb->sec[s].b1, b2 = fb->sec[s].b2;
+        const int32_t na1 = fb->sec[s].na1, na2 = fb->sec[s].na2;
+        int32_t x1 = fb->x1[s][c], x2 = fb->x2[s][c], y1 = fb->y1[s][c], y2 = fb->y2[s][c];
+        int64_t err = fb->err[s][c];
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const int32_t x = buf[i];
+            int64_t acc = err;
+
+            acc += (int64_t)b0 * x;
+            acc += (int64_t)b1 * x1;
+            acc += (int64_t)b2 * x2;
+            acc += (int64_t)na1 * y1;
+            acc += (int64_t)na2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = (int32_t)(acc >> MAX30003_FILTER_COEFF_FRAC);
+            err = acc & MAX30003_FILTER_ERR_MASK;
+            buf[i] = y1;
+        }
+
+        fb->x1[s][c] = x1;
+        fb->x2[s][c] = x2;
+        fb->y1[s][c] = y1;
+        fb->y2[s][c] = y2;
+        fb->err[s][c] = (int32_t)err;
+    }
+}
+
+/**
+ * @brief Portable reference filter, one channel at a time.
+ * @param fb Filter bank.
+ * @param ecg Input ECG codes, one pointer per channel.
+ * @param out Output at 2^MAX30003_FILTER_SHIFT per code, one pointer per
+ *            channel; may be the same buffers as ecg.
+ * @param count Samples per channel.
+ */
+void MAX30003_Filter_Process_Scalar(MAX30003_FilterBankTypeDef *fb, const int32_t *const *ecg,
+                                    int32_t *const *out, uint32_t count) {
+    for (uint32_t c = 0; c < fb->channels; ++c) {
+        MAX30003_Filter_Load(ecg[c], out[c], count);
+        MAX30003_Filter_Channel(fb, c, out[c], count);
+    }
+}
+
+#if MAX30003_FILTER_IMPL == MAX30003_FILTER_AVX2
+
+#define MAX30003_FILTER_LANES   4U
+
+/* Low dword of each 64-bit lane to the low 128 bits */
+#define MAX30003_FILTER_AVX2_NARROW(v) \
+    _mm256_castsi256_si128(_mm256_permutevar8x32_epi32((v), _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)))
+
+/**
+ * @brief Run every section over four channels, one channel per 64-bit lane.
+ * @details _mm256_mul_epi32 multiplies the low dwords of each lane, so the
+ *          state keeps the sample in the low half and anything above it is
+ *          ignored. A logical shift leaves the same low 32 bits as the
+ *          scalar arithmetic shift, so the two paths agree bit for bit.
+ */
+static void MAX30003_Filter_Group(MAX30003_FilterBankTypeDef *fb, uint32_t c, int32_t *const *out, uint32_t count) {
+    int32_t *p0 = out[c], *p1 = out[c + 1U], *p2 = out[c + 2U], *p3 = out[c + 3U];
+    const __m256i mask = _mm256_set1_epi64x(MAX30003_FILTER_ERR_MASK);
+
+    for (uint32_t s = 0; s < fb->sections; ++s) {
+        const __m256i b0 = _mm256_set1_epi64x(fb->sec[s].b0), b1 = _mm256_set1_epi64x(fb->sec[s].b1);
+        const __m256i b2 = _mm256_set1_epi64x(fb->sec[s].b2);
+        const __m256i na1 = _mm256_set1_epi64x(fb->sec[s].na1), na2 = _mm256_set1_epi64x(fb->sec[s].na2);
+        __m256i x1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&fb->x1[s][c]));
+        __m256i x2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&fb->x2[s][c]));
+        __m256i y1 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&fb->y1[s][c]));
+        __m256i y2 = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&fb->y2[s][c]));
+        __m256i err = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)&fb->err[s][c]));
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const __m256i x = _mm256_cvtepi32_epi64(_mm_setr_epi32(p0[i], p1[i], p2[i], p3[i]));
+            __m256i acc = _mm256_add_epi64(err, _mm256_mul_epi32(b0, x));
+            __m128i y;
+
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(b1, x1));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(b2, x2));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(na1, y1));
+            acc = _mm256_add_epi64(acc, _mm256_mul_epi32(na2, y2));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = _mm256_srli_epi64(acc, MAX30003_FILTER_COEFF_FRAC);
+            err = _mm256_and_si256(acc, mask);
+
+            y = MAX30003_FILTER_AVX2_NARROW(y1);
+            p0[i] = _mm_cvtsi128_si32(y);
+            p1[i] = _mm_extract_epi32(y, 1);
+            p2[i] = _mm_extract_epi32(y, 2);
+            p3[i] = _mm_extract_epi32(y, 3);
+        }
+
+        _mm_storeu_si128((__m128i *)&fb->x1[s][c], MAX30003_FILTER_AVX2_NARROW(x1));
+        _mm_storeu_si128((__m128i *)&fb->x2[s][c], MAX30003_FILTER_AVX2_NARROW(x2));
+        _mm_storeu_si128((__m128i *)&fb->y1[s][c], MAX30003_FILTER_AVX2_NARROW(y1));
+        _mm_storeu_si128((__m128i *)&fb->y2[s][c], MAX30003_FILTER_AVX2_NARROW(y2));
+        _mm_storeu_si128((__m128i *)&fb->err[s][c], MAX30003_FILTER_AVX2_NARROW(err));
+    }
+}
+
+#elif MAX30003_FILTER_IMPL == MAX30003_FILTER_SSE41
+
+#define MAX30003_FILTER_LANES   2U
+
+/* Low dword of each 64-bit lane to the low 64 bits */
+#define MAX30003_FILTER_SSE41_LOAD(p)       _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)(p)))
+#define MAX30003_FILTER_SSE41_STORE(p, v)   _mm_storel_epi64((__m128i *)(p), _mm_shuffle_epi32((v), 0x08))
+
+/**
+ * @brief Run every section over two channels, one channel per 64-bit lane.
+ * @details Same arithmetic as the AVX2 path with half the lanes.
+ */
+static void MAX30003_Filter_Group(MAX30003_FilterBankTypeDef *fb, uint32_t c, int32_t *const *out, uint32_t count) {
+    int32_t *p0 = out[c], *p1 = out[c + 1U];
+    const __m128i mask = _mm_set1_epi64x(MAX30003_FILTER_ERR_MASK);
+
+    for (uint32_t s = 0; s < fb->sections; ++s) {
+        const __m128i b0 = _mm_set1_epi64x(fb->sec[s].b0), b1 = _mm_set1_epi64x(fb->sec[s].b1);
+        const __m128i b2 = _mm_set1_epi64x(fb->sec[s].b2);
+        const __m128i na1 = _mm_set1_epi64x(fb->sec[s].na1), na2 = _mm_set1_epi64x(fb->sec[s].na2);
+        __m128i x1 = MAX30003_FILTER_SSE41_LOAD(&fb->x1[s][c]);
+        __m128i x2 = MAX30003_FILTER_SSE41_LOAD(&fb->x2[s][c]);
+        __m128i y1 = MAX30003_FILTER_SSE41_LOAD(&fb->y1[s][c]);
+        __m128i y2 = MAX30003_FILTER_SSE41_LOAD(&fb->y2[s][c]);
+        __m128i err = MAX30003_FILTER_SSE41_LOAD(&fb->err[s][c]);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const __m128i x = _mm_set_epi64x(p1[i], p0[i]);
+            __m128i acc = _mm_add_epi64(err, _mm_mul_epi32(b0, x));
+
+            acc = _mm_add_epi64(acc, _mm_mul_epi32(b1, x1));
+            acc = _mm_add_epi64(acc, _mm_mul_epi32(b2, x2));
+            acc = _mm_add_epi64(acc, _mm_mul_epi32(na1, y1));
+            acc = _mm_add_epi64(acc, _mm_mul_epi32(na2, y2));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = _mm_srli_epi64(acc, MAX30003_FILTER_COEFF_FRAC);
+            err = _mm_and_si128(acc, mask);
+
+            p0[i] = _mm_cvtsi128_si32(y1);
+            p1[i] = _mm_extract_epi32(y1, 2);
+        }
+
+        MAX30003_FILTER_SSE41_STORE(&fb->x1[s][c], x1);
+        MAX30003_FILTER_SSE41_STORE(&fb->x2[s][c], x2);
+        MAX30003_FILTER_SSE41_STORE(&fb->y1[s][c], y1);
+        MAX30003_FILTER_SSE41_STORE(&fb->y2[s][c], y2);
+        MAX30003_FILTER_SSE41_STORE(&fb->err[s][c], err);
+    }
+}
+
+#endif
+
+/**
+ * @brief Filter one block on every channel.
+ * @details Call once per drain with the decoded samples of each device.
+ *          Channels are processed in groups of the vector width selected by
+ *          MAX30003_FILTER_IMPL; the remainder goes through the scalar path.
+ *          Results match MAX30003_Filter_Process_Scalar() exactly.
+ * @param fb Filter bank.
+ * @param ecg Input ECG codes, one pointer per channel.
+ * @param out Output at 2^MAX30003_FILTER_SHIFT per code, one pointer per
+ *            channel; may be the same buffers as ecg.
+ * @param count Samples per channel.
+ */
+void MAX30003_Filter_Process(MAX30003_FilterBankTypeDef *fb, const int32_t *const *ecg, int32_t *const *out,
+                             uint32_t count) {
+    uint32_t c = 0;
+
+    for (uint32_t k = 0; k < fb->channels; ++k)
+        MAX30003_Filter_Load(ecg[k], out[k], count);
+
+#if MAX30003_FILTER_IMPL != MAX30003_FILTER_SCALAR
+    for (; c + MAX30003_FILTER_LANES <= fb->channels; c += MAX30003_FILTER_LANES)
+        MAX30003_Filter_Group(fb, c, out, count);
+#endif
+
+    for (; c < fb->channels; ++c)
+        MAX30003_Filter_Channel(fb, c, out[c], count);
+}
+
+/**
+ * @brief Name of the filter path compiled in, for logs and benchmarks.
+ */
+const char *MAX30003_Filter_ImplName(void) {
+#if MAX30003_FILTER_IMPL == MAX30003_FILTER_AVX2
+    return "avx2";
+#elif MAX30003_FILTER_IMPL == MAX30003_FILTER_SSE41
+    return "sse4.1";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ * @file    max30003_filter.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 Q31 biquad filter bank - Header file
+ *
+ * @note    Baseline high-pass, mains notch and low-pass as a cascade of Q31 biquads,
+ *          run block-wise over several channels that share one design.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_FILTER_H_
+#define INC_MAX30003_FILTER_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Filter Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_FILTER_CHANNELS
+#define MAX30003_FILTER_CHANNELS    8U          /**< Channels per bank */
+#endif
+
+#define MAX30003_FILTER_HP_SECTIONS 2U          /**< 4th-order Butterworth high-pass */
+#define MAX30003_FILTER_LP_SECTIONS 2U          /**< 4th-order Butterworth low-pass */
+#define MAX30003_FILTER_SECTIONS    (MAX30003_FILTER_HP_SECTIONS + 1U + MAX30003_FILTER_LP_SECTIONS)
+
+#define MAX30003_FILTER_HP_mHz      500U        /**< Default high-pass corner */
+#define MAX30003_FILTER_NOTCH_mHz   50000U      /**< Default notch, 50 Hz mains */
+#define MAX30003_FILTER_LP_mHz      40000U      /**< Default low-pass corner */
+#define MAX30003_FILTER_NOTCH_BW_mHz 2000U      /**< Notch -3 dB bandwidth */
+
+/* ECG codes enter at 2^SHIFT: an 18-bit code then spans +/-2^29, leaving
+ * two bits of headroom for filter overshoot inside the cascade */
+#define MAX30003_FILTER_SHIFT       12U
+#define MAX30003_FILTER_COEFF_FRAC  30U         /**< Coefficients are Q2.30 */
+
+/** @brief Filter output to ECG codes, truncating the fraction */
+#define MAX30003_FILTER_TO_CODE(y)  ((int32_t)(y) >> MAX30003_FILTER_SHIFT)
+
+/* ---------------------------------------------------------------------------
+ * Filter Implementation Selection
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_FILTER_SCALAR  0U  /**< Portable C, 64-bit MACs (SMLAL on Cortex-M) */
+#define MAX30003_FILTER_SSE41   1U  /**< x86 SSE4.1, 2 channels per step */
+#define MAX30003_FILTER_AVX2    2U  /**< x86 AVX2, 4 channels per step */
+
+/* Picked from the compiler's target flags; define to MAX30003_FILTER_SCALAR
+ * to force the portable path */
+#ifndef MAX30003_FILTER_IMPL
+#if defined(__AVX2__)
+#define MAX30003_FILTER_IMPL    MAX30003_FILTER_AVX2
+#elif defined(__SSE4_1__)
+#define MAX30003_FILTER_IMPL    MAX30003_FILTER_SSE41
+#else
+#define MAX30003_FILTER_IMPL    MAX30003_FILTER_SCALAR
+#endif
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Filter Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Corner frequencies; 0 disables a stage
+ */
+typedef struct {
+    uint32_t hp_mHz;            /**< High-pass corner */
+    uint32_t notch_mHz;         /**< Mains frequency, 50000 or 60000 */
+    uint32_t lp_mHz;            /**< Low-pass corner */
+} MAX30003_FilterConfigTypeDef;
+
+/**
+ * @brief One biquad section, Q2.30, feedback terms stored negated
+ */
+typedef struct {
+    int32_t b0, b1, b2;
+    int32_t na1, na2;
+} MAX30003_BiquadTypeDef;
+
+/**
+ * @brief Filter bank state
+ *
+ * Every channel runs the same cascade of direct-form I sections. Each
+ * section accumulates in 64 bits and keeps the bits it truncates from the
+ * output, adding them to the next sample (first-order error feedback), so
+ * the low-frequency high-pass poles do not amplify rounding noise into a
+ * baseline offset. State is stored per section across channels, so the
+ * vector paths load neighbouring channels with one access.
+ */
+typedef struct {
+    MAX30003_BiquadTypeDef sec[MAX30003_FILTER_SECTIONS];
+    uint32_t sections;          /**< Sections in use */
+    uint32_t channels;          /**< Channels in use */
+    int32_t x1[MAX30003_FILTER_SECTIONS][MAX30003_FILTER_CHANNELS];
+    int32_t x2[MAX30003_FILTER_SECTIONS][MAX30003_FILTER_CHANNELS];
+    int32_t y1[MAX30003_FILTER_SECTIONS][MAX30003_FILTER_CHANNELS];
+    int32_t y2[MAX30003_FILTER_SECTIONS][MAX30003_FILTER_CHANNELS];
+    int32_t err[MAX30003_FILTER_SECTIONS][MAX30003_FILTER_CHANNELS];    /**< Truncated bits, 0..2^30-1 */
+} MAX30003_FilterBankTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef MAX30003_Filter_Init(MAX30003_FilterBankTypeDef *fb, uint32_t channels, uint32_t rate_mHz,
+                                       const MAX30003_FilterConfigTypeDef *cfg);
+
+void MAX30003_Filter_Reset(MAX30003_FilterBankTypeDef *fb, uint32_t channel, int32_t ecg);
+
+void MAX30003_Filter_Process(MAX30003_FilterBankTypeDef *fb, const int32_t *const *ecg, int32_t *const *out,
+                             uint32_t count);
+
+void MAX30003_Filter_Process_Scalar(MAX30003_FilterBankTypeDef *fb, const int32_t *const *ecg,
+                                    int32_t *const *out, uint32_t count);
+
+const char *MAX30003_Filter_ImplName(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_FILTER_H_ */
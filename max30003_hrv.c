@@ -0,0 +1,194 @@
+/**
+ ******************************************************************************
+ * @file    max30003_hrv.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 incremental HRV metrics - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <string.h>
+#ifdef MAX30003_HRV_DOUBLE
+#include <math.h>
+#endif
+#include "max30003_hrv.h"
+
+/**
+ * @brief Initialize an empty engine.
+ * @param hrv Engine.
+ * @param window_ms Window length, 0 for MAX30003_HRV_WINDOW_MS.
+ */
+void MAX30003_HRV_Init(MAX30003_HRV_TypeDef *hrv, uint32_t window_ms) {
+    memset(hrv, 0, sizeof(*hrv));
+    hrv->window_ms = window_ms != 0 ? window_ms : MAX30003_HRV_WINDOW_MS;
+}
+
+/**
+ * @brief Drop the oldest interval and, if linked, the difference to the
+ *        interval after it.
+ */
+static void MAX30003_HRV_Evict(MAX30003_HRV_TypeDef *hrv) {
+    uint32_t tail = (hrv->head - hrv->count) & MAX30003_HRV_MASK;
+    uint32_t rr = hrv->rr[tail] & ~MAX30003_HRV_LINKED;
+
+    hrv->sum_rr -= rr;
+    hrv->sum_rr2 -= (MAX30003_HRV_AccTypeDef)(rr * rr);
+    hrv->count--;
+
+    if (hrv->count > 0) {
+        uint16_t *next = &hrv->rr[(tail + 1U) & MAX30003_HRV_MASK];
+
+        if (*next & MAX30003_HRV_LINKED) {
+            uint32_t nrr = *next & ~MAX30003_HRV_LINKED;
+            uint32_t d = nrr > rr ? nrr - rr : rr - nrr;
+
+            hrv->sum_d2 -= (MAX30003_HRV_AccTypeDef)(d * d);
+            hrv->diffs--;
+            if (d > MAX30003_HRV_NN50_MS)
+                hrv->nn50--;
+            *next &= ~MAX30003_HRV_LINKED;
+        }
+    }
+}
+
+/**
+ * @brief Add one RR interval.
+ * @details Intervals outside MAX30003_HRV_RR_MIN_MS..MAX30003_HRV_RR_MAX_MS
+ *          are counted as rejected and break the successive-difference
+ *          chain. Oldest intervals are evicted until the window holds at
+ *          most window_ms (or MAX30003_HRV_CAPACITY beats).
+ * @param hrv Engine.
+ * @param rr_ms RR interval, e.g. MAX30003_RREventTypeDef.rr_ms.
+ * @return 1 if accepted, 0 if rejected.
+ */
+uint8_t MAX30003_HRV_Push(MAX30003_HRV_TypeDef *hrv, uint32_t rr_ms) {
+    uint16_t slot = (uint16_t)rr_ms;
+
+    if (rr_ms < MAX30003_HRV_RR_MIN_MS || rr_ms > MAX30003_HRV_RR_MAX_MS) {
+        hrv->rejected++;
+        hrv->linked = 0;
+        return 0;
+    }
+
+    if (hrv->count == MAX30003_HRV_CAPACITY)
+        MAX30003_HRV_Evict(hrv);
+
+    if (hrv->linked && hrv->count > 0) {
+        uint32_t d = rr_ms > hrv->last_rr ? rr_ms - hrv->last_rr : hrv->last_rr - rr_ms;
+
+        hrv->sum_d2 += (MAX30003_HRV_AccTypeDef)(d * d);
+        hrv->diffs++;
+        if (d > MAX30003_HRV_NN50_MS)
+            hrv->nn50++;
+        slot |= MAX30003_HRV_LINKED;
+    }
+
+    hrv->rr[hrv->head] = slot;
+    hrv->head = (hrv->head + 1U) & MAX30003_HRV_MASK;
+    hrv->count++;
+    hrv->sum_rr += rr_ms;
+    hrv->sum_rr2 += (MAX30003_HRV_AccTypeDef)(rr_ms * rr_ms);
+    hrv->last_rr = (uint16_t)rr_ms;
+    hrv->linked = 1;
+
+    while (hrv->sum_rr > hrv->window_ms && hrv->count > 1)
+        MAX30003_HRV_Evict(hrv);
+
+    return 1;
+}
+
+/**
+ * @brief Do not take a successive difference across the next interval,
+ *        e.g. after a ring gap or an RR event with resync set.
+ * @param hrv Engine.
+ */
+void MAX30003_HRV_Break(MAX30003_HRV_TypeDef *hrv) {
+    hrv->linked = 0;
+}
+
+#ifndef MAX30003_HRV_DOUBLE
+/**
+ * @brief floor(sqrt(v)).
+ */
+static uint32_t MAX30003_HRV_Sqrt(uint64_t v) {
+    uint64_t r = 0, bit = 1ULL << 62;
+
+    while (bit > v)
+        bit >>= 2;
+    while (bit != 0) {
+        if (v >= r + bit) {
+            v -= r + bit;
+            r = (r >> 1) + bit;
+        } else {
+            r >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)r;
+}
+#endif
+
+/**
+ * @brief Metrics over the current window.
+ * @details Values are Q8 (MAX30003_HRV_FRAC_BITS) in the fixed-point build
+ *          and plain doubles with MAX30003_HRV_DOUBLE; metrics without
+ *          enough data are 0.
+ * @param hrv Engine.
+ * @param m Output.
+ */
+void MAX30003_HRV_Get(const MAX30003_HRV_TypeDef *hrv, MAX30003_HRV_MetricsTypeDef *m) {
+    const uint32_t n = hrv->count, nd = hrv->diffs;
+
+    memset(m, 0, sizeof(*m));
+    m->beats = n;
+    m->diffs = nd;
+    m->span_ms = hrv->sum_rr;
+    if (n == 0)
+        return;
+
+#ifdef MAX30003_HRV_DOUBLE
+    m->mean_rr_ms = (double)hrv->sum_rr / n;
+    m->hr_bpm = 60000.0 * n / hrv->sum_rr;
+    if (n > 1) {
+        double var = (n * hrv->sum_rr2 - (double)hrv->sum_rr * hrv->sum_rr) / ((double)n * (n - 1));
+        m->sdnn_ms = var > 0 ? sqrt(var) : 0;
+    }
+    if (nd > 0) {
+        m->rmssd_ms = sqrt(hrv->sum_d2 / nd);
+        m->pnn50_pct = 100.0 * hrv->nn50 / nd;
+    }
+#else
+    /* n * sum(NN^2) - sum(NN)^2 is exact in 64 bits for a 5 min window */
+    m->mean_rr_ms = (uint32_t)((((uint64_t)hrv->sum_rr << MAX30003_HRV_FRAC_BITS) + n / 2U) / n);
+    m->hr_bpm = (uint32_t)((((uint64_t)60000U * n << MAX30003_HRV_FRAC_BITS) + hrv->sum_rr / 2U) / hrv->sum_rr);
+    if (n > 1) {
+        uint64_t var_num = n * hrv->sum_rr2 - (uint64_t)hrv->sum_rr * hrv->sum_rr;
+        m->sdnn_ms = MAX30003_HRV_Sqrt((var_num << (2U * MAX30003_HRV_FRAC_BITS)) / ((uint64_t)n * (n - 1U)));
+    }
+    if (nd > 0) {
+        m->rmssd_ms = MAX30003_HRV_Sqrt((hrv->sum_d2 << (2U * MAX30003_HRV_FRAC_BITS)) / nd);
+        m->pnn50_pct = (uint32_t)((((uint64_t)hrv->nn50 * 100U << MAX30003_HRV_FRAC_BITS) + nd / 2U) / nd);
+    }
+#endif
+}
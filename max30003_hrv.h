@@ -0,0 +1,136 @@
+/**
+ ******************************************************************************
+ * @file    max30003_hrv.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 incremental HRV metrics - Header file
+ *
+ * @note    Fixed point by default; define MAX30003_HRV_DOUBLE for a double-precision build.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_HRV_H_
+#define INC_MAX30003_HRV_H_
+
+#include <stdint.h>
+
+/* ---------------------------------------------------------------------------
+ * Engine Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_HRV_CAPACITY
+#define MAX30003_HRV_CAPACITY       2048U       /**< Beats held, must be a power of two; 1200 fill 5 min at 240 bpm */
+#endif
+
+#if (MAX30003_HRV_CAPACITY < 2U) || ((MAX30003_HRV_CAPACITY & (MAX30003_HRV_CAPACITY - 1U)) != 0U)
+#error "MAX30003_HRV_CAPACITY must be a power of two >= 2"
+#endif
+
+#if !defined(MAX30003_HRV_DOUBLE) && (MAX30003_HRV_CAPACITY > 4096U)
+#error "MAX30003_HRV_CAPACITY above 4096 overflows the fixed-point SDNN sums"
+#endif
+
+#define MAX30003_HRV_MASK           (MAX30003_HRV_CAPACITY - 1U)
+#define MAX30003_HRV_WINDOW_MS      300000U     /**< Default window, 5 minutes */
+#define MAX30003_HRV_RR_MIN_MS      250U        /**< Shorter intervals are rejected (240 bpm) */
+#define MAX30003_HRV_RR_MAX_MS      2500U       /**< Longer intervals are rejected (24 bpm) */
+#define MAX30003_HRV_NN50_MS        50U         /**< pNN50 successive-difference threshold */
+#define MAX30003_HRV_LINKED         0x8000U     /**< Slot flag: difference to the previous slot counts */
+
+#ifdef MAX30003_HRV_DOUBLE
+typedef double MAX30003_HRV_AccTypeDef;         /**< Running sums */
+typedef double MAX30003_HRV_ValueTypeDef;       /**< Metric, plain units */
+#define MAX30003_HRV_FRAC_BITS      0U
+#define MAX30003_HRV_TO_DOUBLE(v)   ((double)(v))
+#else
+typedef uint64_t MAX30003_HRV_AccTypeDef;       /**< Running sums, exact */
+typedef uint32_t MAX30003_HRV_ValueTypeDef;     /**< Metric, Q8 */
+#define MAX30003_HRV_FRAC_BITS      8U
+#define MAX30003_HRV_TO_DOUBLE(v)   ((double)(v) / (double)(1U << MAX30003_HRV_FRAC_BITS))
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Engine Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Windowed HRV metrics
+ */
+typedef struct {
+    MAX30003_HRV_ValueTypeDef mean_rr_ms;   /**< Mean NN interval */
+    MAX30003_HRV_ValueTypeDef sdnn_ms;      /**< Sample standard deviation of NN intervals */
+    MAX30003_HRV_ValueTypeDef rmssd_ms;     /**< Root mean square of successive differences */
+    MAX30003_HRV_ValueTypeDef pnn50_pct;    /**< Successive differences above 50 ms, percent */
+    MAX30003_HRV_ValueTypeDef hr_bpm;       /**< Mean heart rate */
+    uint32_t beats;                         /**< NN intervals in the window */
+    uint32_t diffs;                         /**< Successive differences in the window */
+    uint32_t span_ms;                       /**< Time the window covers; short of window_ms if capacity-bound */
+} MAX30003_HRV_MetricsTypeDef;
+
+/**
+ * @brief HRV engine state
+ *
+ * A ring of the NN intervals in the window, plus running sums of NN,
+ * NN^2, squared successive differences and the NN50 count. Each beat adds
+ * one interval and evicts the oldest ones until the window holds at most
+ * window_ms, so the cost per beat is O(1) amortised. Successive
+ * differences are only taken between accepted intervals that were not
+ * separated by a rejected beat or MAX30003_HRV_Break().
+ */
+typedef struct {
+    uint16_t rr[MAX30003_HRV_CAPACITY];     /**< NN interval in ms | MAX30003_HRV_LINKED */
+    uint32_t head;                          /**< Next slot to write */
+    uint32_t count;                         /**< Intervals in the window */
+    uint32_t window_ms;                     /**< Window length */
+    uint8_t linked;                         /**< The next interval continues the chain */
+    uint16_t last_rr;                       /**< Last accepted interval */
+    uint32_t sum_rr;                        /**< Sum of NN, ms */
+    MAX30003_HRV_AccTypeDef sum_rr2;        /**< Sum of NN^2, ms^2 */
+    MAX30003_HRV_AccTypeDef sum_d2;         /**< Sum of squared successive differences, ms^2 */
+    uint32_t diffs;                         /**< Successive differences in the window */
+    uint32_t nn50;                          /**< Successive differences above MAX30003_HRV_NN50_MS */
+    uint32_t rejected;                      /**< Intervals outside the accepted range */
+} MAX30003_HRV_TypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_HRV_Init(MAX30003_HRV_TypeDef *hrv, uint32_t window_ms);
+
+uint8_t MAX30003_HRV_Push(MAX30003_HRV_TypeDef *hrv, uint32_t rr_ms);
+
+void MAX30003_HRV_Break(MAX30003_HRV_TypeDef *hrv);
+
+void MAX30003_HRV_Get(const MAX30003_HRV_TypeDef *hrv, MAX30003_HRV_MetricsTypeDef *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_HRV_H_ */
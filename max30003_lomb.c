@@ -0,0 +1,253 @@
+/**
+ ******************************************************************************
+ * @file    max30003_lomb.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 Lomb-Scargle RR spectrum (LF/HF) - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <math.h>
+#include <string.h>
+#include "max30003_lomb.h"
+
+#ifdef MAX30003_LOMB_DOUBLE
+#define MAX30003_LOMB_SQRT(x)   sqrt(x)
+#define MAX30003_LOMB_COS(x)    cos(x)
+#define MAX30003_LOMB_SIN(x)    sin(x)
+#else
+#define MAX30003_LOMB_SQRT(x)   sqrtf(x)
+#define MAX30003_LOMB_COS(x)    cosf(x)
+#define MAX30003_LOMB_SIN(x)    sinf(x)
+#endif
+
+#define MAX30003_LOMB_2PI       6.28318530717958647692
+
+typedef MAX30003_LOMB_RealTypeDef MAX30003_Lomb_Real;
+
+/**
+ * @brief Add (sign = 1) or remove (sign = -1) one sample's terms.
+ * @details cos/sin of k*w1*t for every bin come from one cos/sin pair and a
+ *          complex-multiply recurrence; the double angle is the square.
+ * @param sums Sums.
+ * @param t_s Sample time relative to the sums' reference, seconds.
+ * @param y Sample value.
+ * @param sign 1 or -1.
+ */
+static void MAX30003_Lomb_Accumulate(MAX30003_Lomb_SumsTypeDef *sums, MAX30003_Lomb_Real t_s,
+                                     MAX30003_Lomb_Real y, MAX30003_Lomb_Real sign) {
+    const MAX30003_Lomb_Real w1 = (MAX30003_Lomb_Real)(MAX30003_LOMB_2PI * MAX30003_LOMB_DF_uHz / 1e6);
+    const MAX30003_Lomb_Real c1 = MAX30003_LOMB_COS(w1 * t_s), s1 = MAX30003_LOMB_SIN(w1 * t_s);
+    const MAX30003_Lomb_Real sy = sign * y;
+    MAX30003_Lomb_Real c = c1, s = s1;
+
+    for (uint32_t k = 0; k < MAX30003_LOMB_BINS; ++k) {
+        MAX30003_Lomb_Real cn;
+
+        sums->c[k] += sign * c;
+        sums->s[k] += sign * s;
+        sums->c2[k] += sign * (c * c - s * s);
+        sums->s2[k] += sign * (2 * c * s);
+        sums->yc[k] += sy * c;
+        sums->ys[k] += sy * s;
+
+        cn = c * c1 - s * s1;
+        s = s * c1 + c * s1;
+        c = cn;
+    }
+    sums->sum_y += sy;
+    sums->n = sign > 0 ? sums->n + 1U : sums->n - 1U;
+}
+
+/**
+ * @brief Periodogram and band powers from a set of sums.
+ * @details Per bin, the Lomb-Scargle time offset tau makes the sine and
+ *          cosine terms orthogonal; the mean is removed through sum_y. The
+ *          result is scaled to a one-sided PSD in ms^2/Hz. With the grid
+ *          step at most 1 / span the bin sum integrates a tone's spectral
+ *          line exactly, so a sinusoid of amplitude A ms gives a band power
+ *          of A^2 / 2.
+ * @param sums Sums.
+ * @param span_s Time from the first to the last sample, seconds.
+ * @param psd Output, MAX30003_LOMB_BINS values (may be NULL).
+ * @param bands Output band powers.
+ */
+static void MAX30003_Lomb_Spectrum(const MAX30003_Lomb_SumsTypeDef *sums, MAX30003_Lomb_Real span_s,
+                                   MAX30003_Lomb_Real *psd, MAX30003_Lomb_BandsTypeDef *bands) {
+    const MAX30003_Lomb_Real n = (MAX30003_Lomb_Real)sums->n;
+    const MAX30003_Lomb_Real df = (MAX30003_Lomb_Real)(MAX30003_LOMB_DF_uHz / 1e6);
+    MAX30003_Lomb_Real ybar, scale;
+
+    memset(bands, 0, sizeof(*bands));
+    bands->beats = sums->n;
+    if (sums->n < 3 || span_s <= 0) {
+        if (psd != NULL)
+            memset(psd, 0, MAX30003_LOMB_BINS * sizeof(*psd));
+        return;
+    }
+
+    ybar = sums->sum_y / n;
+    scale = 2 * span_s / n;
+
+    for (uint32_t k = 0; k < MAX30003_LOMB_BINS; ++k) {
+        const uint32_t f_uHz = (k + 1U) * MAX30003_LOMB_DF_uHz;
+        MAX30003_Lomb_Real r = MAX30003_LOMB_SQRT(sums->c2[k] * sums->c2[k] + sums->s2[k] * sums->s2[k]);
+        MAX30003_Lomb_Real cos2 = r > 0 ? sums->c2[k] / r : 1, sin2 = r > 0 ? sums->s2[k] / r : 0;
+        MAX30003_Lomb_Real ct = MAX30003_LOMB_SQRT((1 + cos2) / 2);
+        MAX30003_Lomb_Real st = MAX30003_LOMB_SQRT((1 - cos2) / 2);
+        MAX30003_Lomb_Real yc = sums->yc[k] - ybar * sums->c[k];
+        MAX30003_Lomb_Real ys = sums->ys[k] - ybar * sums->s[k];
+        MAX30003_Lomb_Real cc = (n + r) / 2, ss = (n - r) / 2;
+        MAX30003_Lomb_Real yct, yst, p = 0;
+
+        if (sin2 < 0)
+            st = -st;
+        yct = yc * ct + ys * st;
+        yst = ys * ct - yc * st;
+        if (cc > 0)
+            p += yct * yct / cc;
+        if (ss > 0)
+            p += yst * yst / ss;
+        p = p / 2 * scale;
+
+        if (psd != NULL)
+            psd[k] = p;
+        if (f_uHz >= MAX30003_LOMB_LF_LO_uHz && f_uHz < MAX30003_LOMB_LF_HI_uHz)
+            bands->lf_ms2 += p * df;
+        else if (f_uHz >= MAX30003_LOMB_LF_HI_uHz && f_uHz <= MAX30003_LOMB_HF_HI_uHz)
+            bands->hf_ms2 += p * df;
+    }
+    bands->lf_hf = bands->hf_ms2 > 0 ? bands->lf_ms2 / bands->hf_ms2 : 0;
+}
+
+/**
+ * @brief Recompute the sums from the ring, referenced to the oldest beat.
+ */
+static void MAX30003_Lomb_Rebuild(MAX30003_LombTypeDef *l) {
+    uint32_t tail = (l->head - l->count) & MAX30003_LOMB_MASK;
+
+    memset(&l->sums, 0, sizeof(l->sums));
+    l->t0_ms = l->count > 0 ? l->t_ms[tail] : l->now_ms;
+    for (uint32_t i = 0; i < l->count; ++i) {
+        uint32_t slot = (tail + i) & MAX30003_LOMB_MASK;
+
+        MAX30003_Lomb_Accumulate(&l->sums, (MAX30003_Lomb_Real)(l->t_ms[slot] - l->t0_ms) / 1000,
+                                 l->rr[slot], 1);
+    }
+    l->since_rebuild = 0;
+}
+
+/**
+ * @brief Initialize an empty spectrum.
+ * @param l Spectrum state.
+ * @param window_ms Window length, 0 for MAX30003_LOMB_WINDOW_MS.
+ */
+void MAX30003_Lomb_Init(MAX30003_LombTypeDef *l, uint32_t window_ms) {
+    memset(l, 0, sizeof(*l));
+    l->window_ms = window_ms != 0 ? window_ms : MAX30003_LOMB_WINDOW_MS;
+}
+
+/**
+ * @brief Evict the oldest beat.
+ */
+static void MAX30003_Lomb_Evict(MAX30003_LombTypeDef *l) {
+    uint32_t tail = (l->head - l->count) & MAX30003_LOMB_MASK;
+
+    MAX30003_Lomb_Accumulate(&l->sums, (MAX30003_Lomb_Real)(l->t_ms[tail] - l->t0_ms) / 1000, l->rr[tail], -1);
+    l->count--;
+}
+
+/**
+ * @brief Add a beat: an RR interval ending now.
+ * @details The beat is placed rr_ms after the previous one (or skipped
+ *          interval) and beats older than the window are evicted.
+ * @param l Spectrum state.
+ * @param rr_ms RR interval, e.g. MAX30003_RREventTypeDef.rr_ms.
+ */
+void MAX30003_Lomb_Push(MAX30003_LombTypeDef *l, uint32_t rr_ms) {
+    l->now_ms += rr_ms;
+
+    if (l->count == MAX30003_LOMB_CAPACITY)
+        MAX30003_Lomb_Evict(l);
+    while (l->count > 0 && l->now_ms - l->t_ms[(l->head - l->count) & MAX30003_LOMB_MASK] > l->window_ms)
+        MAX30003_Lomb_Evict(l);
+
+    l->t_ms[l->head] = l->now_ms;
+    l->rr[l->head] = (uint16_t)rr_ms;
+    l->head = (l->head + 1U) & MAX30003_LOMB_MASK;
+    l->count++;
+
+    if (++l->since_rebuild >= MAX30003_LOMB_REBUILD)
+        MAX30003_Lomb_Rebuild(l);
+    else
+        MAX30003_Lomb_Accumulate(&l->sums, (MAX30003_Lomb_Real)(l->now_ms - l->t0_ms) / 1000, (MAX30003_Lomb_Real)rr_ms, 1);
+}
+
+/**
+ * @brief Advance time by an interval that is not used as a sample, e.g. a
+ *        rejected artefact. Lomb-Scargle needs no resampling across it.
+ * @param l Spectrum state.
+ * @param rr_ms Interval, ms.
+ */
+void MAX30003_Lomb_Skip(MAX30003_LombTypeDef *l, uint32_t rr_ms) {
+    l->now_ms += rr_ms;
+}
+
+/**
+ * @brief Spectrum of the beats in the window.
+ * @param l Spectrum state.
+ * @param psd Output, MAX30003_LOMB_BINS values in ms^2/Hz (may be NULL).
+ * @param bands Output band powers.
+ */
+void MAX30003_Lomb_Get(const MAX30003_LombTypeDef *l, MAX30003_LOMB_RealTypeDef *psd,
+                       MAX30003_Lomb_BandsTypeDef *bands) {
+    uint32_t span = l->count > 0 ? l->now_ms - l->t_ms[(l->head - l->count) & MAX30003_LOMB_MASK] : 0;
+
+    MAX30003_Lomb_Spectrum(&l->sums, (MAX30003_Lomb_Real)span / 1000, psd, bands);
+}
+
+/**
+ * @brief Spectrum of a recorded RR series in one call.
+ * @details Reentrant: all state is on the stack, so a host tool may run it
+ *          on many recordings in parallel.
+ * @param t_ms Beat times, or NULL to place beats at the running sum of rr_ms.
+ * @param rr_ms RR intervals, ms.
+ * @param n Number of beats.
+ * @param psd Output, MAX30003_LOMB_BINS values in ms^2/Hz (may be NULL).
+ * @param bands Output band powers.
+ */
+void MAX30003_Lomb_Batch(const uint32_t *t_ms, const uint16_t *rr_ms, uint32_t n,
+                         MAX30003_LOMB_RealTypeDef *psd, MAX30003_Lomb_BandsTypeDef *bands) {
+    MAX30003_Lomb_SumsTypeDef sums;
+    uint32_t t = 0, t_first = 0;
+
+    memset(&sums, 0, sizeof(sums));
+    for (uint32_t i = 0; i < n; ++i) {
+        t = t_ms != NULL ? t_ms[i] : t + rr_ms[i];
+        if (i == 0)
+            t_first = t;
+        MAX30003_Lomb_Accumulate(&sums, (MAX30003_Lomb_Real)(t - t_first) / 1000, rr_ms[i], 1);
+    }
+    MAX30003_Lomb_Spectrum(&sums, (MAX30003_Lomb_Real)(t - t_first) / 1000, psd, bands);
+}
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    max30003_lomb.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 Lomb-Scargle RR spectrum (LF/HF) - Header file
+ *
+ * @note    Single precision by default; define MAX30003_LOMB_DOUBLE for a double-precision build.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_LOMB_H_
+#define INC_MAX30003_LOMB_H_
+
+#include <stdint.h>
+
+/* ---------------------------------------------------------------------------
+ * Spectrum Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_LOMB_CAPACITY
+#define MAX30003_LOMB_CAPACITY      512U        /**< Beats held, must be a power of two */
+#endif
+
+#if (MAX30003_LOMB_CAPACITY < 2U) || ((MAX30003_LOMB_CAPACITY & (MAX30003_LOMB_CAPACITY - 1U)) != 0U)
+#error "MAX30003_LOMB_CAPACITY must be a power of two >= 2"
+#endif
+
+#define MAX30003_LOMB_MASK          (MAX30003_LOMB_CAPACITY - 1U)
+#define MAX30003_LOMB_WINDOW_MS     300000U     /**< Default window, 5 minutes */
+#define MAX30003_LOMB_DF_uHz        2500U       /**< Frequency grid step, at most 1 / window */
+#define MAX30003_LOMB_BINS          160U        /**< Bins at k * DF, k = 1..BINS (2.5-400 mHz) */
+#define MAX30003_LOMB_LF_LO_uHz     40000U      /**< LF band, inclusive */
+#define MAX30003_LOMB_LF_HI_uHz     150000U     /**< LF band, exclusive; HF starts here */
+#define MAX30003_LOMB_HF_HI_uHz     400000U     /**< HF band, inclusive */
+#define MAX30003_LOMB_REBUILD       256U        /**< Beats between rebuilds of the running sums */
+
+#ifdef MAX30003_LOMB_DOUBLE
+typedef double MAX30003_LOMB_RealTypeDef;
+#else
+typedef float MAX30003_LOMB_RealTypeDef;
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Spectrum Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Per-frequency Lomb-Scargle sums, t relative to a reference time
+ */
+typedef struct {
+    MAX30003_LOMB_RealTypeDef c[MAX30003_LOMB_BINS];    /**< sum cos(wt) */
+    MAX30003_LOMB_RealTypeDef s[MAX30003_LOMB_BINS];    /**< sum sin(wt) */
+    MAX30003_LOMB_RealTypeDef c2[MAX30003_LOMB_BINS];   /**< sum cos(2wt) */
+    MAX30003_LOMB_RealTypeDef s2[MAX30003_LOMB_BINS];   /**< sum sin(2wt) */
+    MAX30003_LOMB_RealTypeDef yc[MAX30003_LOMB_BINS];   /**< sum y cos(wt) */
+    MAX30003_LOMB_RealTypeDef ys[MAX30003_LOMB_BINS];   /**< sum y sin(wt) */
+    MAX30003_LOMB_RealTypeDef sum_y;                    /**< sum y */
+    uint32_t n;                                         /**< Samples summed */
+} MAX30003_Lomb_SumsTypeDef;
+
+/**
+ * @brief Band powers of the RR series
+ */
+typedef struct {
+    MAX30003_LOMB_RealTypeDef lf_ms2;       /**< 0.04-0.15 Hz */
+    MAX30003_LOMB_RealTypeDef hf_ms2;       /**< 0.15-0.40 Hz */
+    MAX30003_LOMB_RealTypeDef lf_hf;        /**< LF/HF, 0 if HF is 0 */
+    uint32_t beats;                         /**< RR samples used */
+} MAX30003_Lomb_BandsTypeDef;
+
+/**
+ * @brief Streaming spectrum state
+ *
+ * Beats inside the window are kept in a ring with their time; the sums are
+ * updated by adding the new beat's terms and subtracting those of evicted
+ * beats, so a beat costs O(BINS). Every MAX30003_LOMB_REBUILD beats the
+ * sums are rebuilt from the ring with the reference time moved to the
+ * oldest beat, which bounds both rounding drift and the size of w*t.
+ */
+typedef struct {
+    MAX30003_Lomb_SumsTypeDef sums;
+    uint32_t t_ms[MAX30003_LOMB_CAPACITY];  /**< Beat times */
+    uint16_t rr[MAX30003_LOMB_CAPACITY];    /**< RR interval ending at each beat, ms */
+    uint32_t head;                          /**< Next slot to write */
+    uint32_t count;                         /**< Beats in the window */
+    uint32_t now_ms;                        /**< Time of the last beat */
+    uint32_t t0_ms;                         /**< Reference time of the sums */
+    uint32_t window_ms;                     /**< Window length */
+    uint32_t since_rebuild;                 /**< Beats added since the last rebuild */
+} MAX30003_LombTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Lomb_Init(MAX30003_LombTypeDef *l, uint32_t window_ms);
+
+void MAX30003_Lomb_Push(MAX30003_LombTypeDef *l, uint32_t rr_ms);
+
+void MAX30003_Lomb_Skip(MAX30003_LombTypeDef *l, uint32_t rr_ms);
+
+void MAX30003_Lomb_Get(const MAX30003_LombTypeDef *l, MAX30003_LOMB_RealTypeDef *psd,
+                       MAX30003_Lomb_BandsTypeDef *bands);
+
+void MAX30003_Lomb_Batch(const uint32_t *t_ms, const uint16_t *rr_ms, uint32_t n,
+                         MAX30003_LOMB_RealTypeDef *psd, MAX30003_Lomb_BandsTypeDef *bands);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_LOMB_H_ */
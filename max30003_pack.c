@@ -0,0 +1,148 @@
+/**
+ ******************************************************************************
+ * @file    max30003_pack.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 packed sample storage formats - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_pack.h"
+
+/* Sign-extend an 18-bit field held in the low bits */
+#define MAX30003_PACK_SEXT18(x)     ((int32_t)((uint32_t)(x) << 14) >> 14)
+
+/**
+ * @brief Store FIFO words as 3 bytes each, most significant byte first.
+ * @details Same byte layout the device uses on the wire, so a PACK24 buffer
+ *          can also be filled straight from a burst read.
+ * @param fifo_data Raw FIFO words (bits 31:24 ignored).
+ * @param out Output, MAX30003_PACK24_BYTES(count) bytes.
+ * @param count Number of words.
+ */
+void MAX30003_Pack24(const uint32_t *fifo_data, uint8_t *out, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i, out += 3) {
+        uint32_t w = fifo_data[i];
+
+        out[0] = (uint8_t)(w >> 16);
+        out[1] = (uint8_t)(w >> 8);
+        out[2] = (uint8_t)w;
+    }
+}
+
+/**
+ * @brief Expand PACK24 samples back into FIFO words.
+ * @param in PACK24 data.
+ * @param fifo_data Output words.
+ * @param count Number of samples.
+ */
+void MAX30003_Unpack24(const uint8_t *in, uint32_t *fifo_data, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i, in += 3)
+        fifo_data[i] = ((uint32_t)in[0] << 16) | ((uint32_t)in[1] << 8) | in[2];
+}
+
+/**
+ * @brief Decode PACK24 samples directly into ECG codes and ETAGs.
+ * @param in PACK24 data.
+ * @param ecg Output, sign-extended ECG codes.
+ * @param etag Output, ETAG codes.
+ * @param count Number of samples.
+ */
+void MAX30003_Unpack24_Decode(const uint8_t *in, int32_t *ecg, uint8_t *etag, uint32_t count) {
+    for (uint32_t i = 0; i < count; ++i, in += 3) {
+        /* Data is bits 23:6: b0 and b1 whole, top two bits of b2 */
+        uint32_t data = ((uint32_t)in[0] << 10) | ((uint32_t)in[1] << 2) | (in[2] >> 6);
+
+        ecg[i] = MAX30003_PACK_SEXT18(data);
+        etag[i] = (in[2] >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK;
+    }
+}
+
+/**
+ * @brief Pack ECG codes into an 18-bit big-endian bitstream.
+ * @details Groups of four samples fill nine bytes exactly; a trailing
+ *          partial group is zero-padded to a byte boundary. ETAGs are not
+ *          stored, so the format suits blocks of valid samples.
+ * @param ecg Sign-extended ECG codes (only the low 18 bits are kept).
+ * @param out Output, MAX30003_PACK18_BYTES(count) bytes.
+ * @param count Number of samples.
+ */
+void MAX30003_Pack18(const int32_t *ecg, uint8_t *out, uint32_t count) {
+    uint32_t i = 0;
+    uint32_t acc = 0, bits = 0;
+
+    for (; i + MAX30003_PACK18_GROUP <= count; i += MAX30003_PACK18_GROUP, out += MAX30003_PACK18_GROUP_BYTES) {
+        uint32_t s0 = (uint32_t)ecg[i], s1 = (uint32_t)ecg[i + 1];
+        uint32_t s2 = (uint32_t)ecg[i + 2], s3 = (uint32_t)ecg[i + 3];
+
+        out[0] = (uint8_t)(s0 >> 10);
+        out[1] = (uint8_t)(s0 >> 2);
+        out[2] = (uint8_t)((s0 << 6) | ((s1 >> 12) & 0x3F));
+        out[3] = (uint8_t)(s1 >> 4);
+        out[4] = (uint8_t)((s1 << 4) | ((s2 >> 14) & 0x0F));
+        out[5] = (uint8_t)(s2 >> 6);
+        out[6] = (uint8_t)((s2 << 2) | ((s3 >> 16) & 0x03));
+        out[7] = (uint8_t)(s3 >> 8);
+        out[8] = (uint8_t)s3;
+    }
+
+    for (; i < count; ++i) {
+        acc = (acc << 18) | ((uint32_t)ecg[i] & 0x3FFFF);
+        bits += 18;
+        while (bits >= 8) {
+            bits -= 8;
+            *out++ = (uint8_t)(acc >> bits);
+        }
+    }
+    if (bits > 0)
+        *out = (uint8_t)(acc << (8 - bits));
+}
+
+/**
+ * @brief Unpack an 18-bit bitstream into sign-extended ECG codes.
+ * @param in PACK18 data.
+ * @param ecg Output codes.
+ * @param count Number of samples.
+ */
+void MAX30003_Unpack18(const uint8_t *in, int32_t *ecg, uint32_t count) {
+    uint32_t i = 0;
+    uint32_t acc = 0, bits = 0;
+
+    for (; i + MAX30003_PACK18_GROUP <= count; i += MAX30003_PACK18_GROUP, in += MAX30003_PACK18_GROUP_BYTES) {
+        ecg[i]     = MAX30003_PACK_SEXT18(((uint32_t)in[0] << 10) | ((uint32_t)in[1] << 2) | (in[2] >> 6));
+        ecg[i + 1] = MAX30003_PACK_SEXT18(((uint32_t)(in[2] & 0x3F) << 12) | ((uint32_t)in[3] << 4) | (in[4] >> 4));
+        ecg[i + 2] = MAX30003_PACK_SEXT18(((uint32_t)(in[4] & 0x0F) << 14) | ((uint32_t)in[5] << 6) | (in[6] >> 2));
+        ecg[i + 3] = MAX30003_PACK_SEXT18(((uint32_t)(in[6] & 0x03) << 16) | ((uint32_t)in[7] << 8) | in[8]);
+    }
+
+    for (; i < count; ++i) {
+        while (bits < 18) {
+            acc = (acc << 8) | *in++;
+            bits += 8;
+        }
+        bits -= 18;
+        ecg[i] = MAX30003_PACK_SEXT18(acc >> bits);
+        acc &= (1U << bits) - 1U;
+    }
+}
@@ -0,0 +1,71 @@
+/**
+ ******************************************************************************
+ * @file    max30003_pack.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 packed sample storage formats - Header file
+ *
+ * @note    PACK24: 3 bytes per sample, the FIFO word as clocked out (data, ETAG).
+ *          PACK18: big-endian 18-bit bitstream of ECG codes only, 4 samples per 9 bytes.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_PACK_H_
+#define INC_MAX30003_PACK_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Packed Sizes
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_PACK24_BYTES(n)    ((uint32_t)(n) * 3U)            /**< Bytes for n PACK24 samples */
+#define MAX30003_PACK18_BYTES(n)    (((uint32_t)(n) * 18U + 7U) / 8U) /**< Bytes for n PACK18 samples */
+
+#define MAX30003_PACK18_GROUP       4U      /**< Samples per byte-aligned PACK18 group */
+#define MAX30003_PACK18_GROUP_BYTES 9U      /**< Bytes per PACK18 group */
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Pack24(const uint32_t *fifo_data, uint8_t *out, uint32_t count);
+
+void MAX30003_Unpack24(const uint8_t *in, uint32_t *fifo_data, uint32_t count);
+
+void MAX30003_Unpack24_Decode(const uint8_t *in, int32_t *ecg, uint8_t *etag, uint32_t count);
+
+void MAX30003_Pack18(const int32_t *ecg, uint8_t *out, uint32_t count);
+
+void MAX30003_Unpack18(const uint8_t *in, int32_t *ecg, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_PACK_H_ */
@@ -0,0 +1,184 @@
+/**
+ ******************************************************************************
+ * @file    max30003_pool.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 reference-counted FIFO block pool - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <stddef.h>
+#include "max30003_pool.h"
+
+#define MAX30003_POOL_ALL   ((MAX30003_POOL_BLOCKS == 32U) ? 0xFFFFFFFFU : ((1U << MAX30003_POOL_BLOCKS) - 1U))
+
+/**
+ * @brief Mark every block free.
+ * @param pool Pool; no block may be referenced.
+ */
+void MAX30003_Pool_Init(MAX30003_PoolTypeDef *pool) {
+    for (uint32_t i = 0; i < MAX30003_POOL_BLOCKS; ++i) {
+        pool->blocks[i].count = 0;
+        pool->blocks[i].refs = 0;
+    }
+    pool->free_mask = MAX30003_POOL_ALL;
+    pool->in_use = 0;
+    pool->in_use_peak = 0;
+    pool->alloc_failures = 0;
+}
+
+/**
+ * @brief Take a free block, holding one reference.
+ * @param pool Pool.
+ * @return Block, or NULL if every block is referenced.
+ */
+MAX30003_BlockTypeDef *MAX30003_Pool_Alloc(MAX30003_PoolTypeDef *pool) {
+    MAX30003_BlockTypeDef *block = NULL;
+
+    MAX30003_CRITICAL_ENTER();
+    for (uint32_t i = 0; i < MAX30003_POOL_BLOCKS; ++i) {
+        if (pool->free_mask & (1U << i)) {
+            pool->free_mask &= ~(1U << i);
+            block = &pool->blocks[i];
+            block->refs = 1;
+            block->count = 0;
+            break;
+        }
+    }
+    if (block == NULL)
+        pool->alloc_failures++;
+    else if (++pool->in_use > pool->in_use_peak)
+        pool->in_use_peak = pool->in_use;
+    MAX30003_CRITICAL_EXIT();
+
+    return block;
+}
+
+/**
+ * @brief Add a reference for another consumer.
+ * @param block Block the caller already holds.
+ */
+void MAX30003_Pool_Retain(MAX30003_BlockTypeDef *block) {
+    MAX30003_CRITICAL_ENTER();
+    block->refs++;
+    MAX30003_CRITICAL_EXIT();
+}
+
+/**
+ * @brief Drop a reference; the last one returns the block to the pool.
+ * @param pool Pool the block came from.
+ * @param block Block the caller holds.
+ */
+void MAX30003_Pool_Release(MAX30003_PoolTypeDef *pool, MAX30003_BlockTypeDef *block) {
+    uint32_t i = (uint32_t)(block - pool->blocks);
+
+    MAX30003_CRITICAL_ENTER();
+    if (block->refs > 0 && --block->refs == 0) {
+        pool->free_mask |= 1U << i;
+        pool->in_use--;
+    }
+    MAX30003_CRITICAL_EXIT();
+}
+
+/**
+ * @brief Number of free blocks.
+ */
+uint32_t MAX30003_Pool_Available(MAX30003_PoolTypeDef *pool) {
+    return MAX30003_POOL_BLOCKS - pool->in_use;
+}
+
+/**
+ * @brief Drain the FIFO straight into a pool block.
+ * @details On success *block holds one reference owned by the caller, or is
+ *          NULL if the FIFO was empty. HAL_BUSY is returned, and nothing is
+ *          read, when the pool has no free block.
+ * @param hmax Device handle.
+ * @param pool Pool to allocate from.
+ * @param block Output, filled block or NULL.
+ * @return HAL status.
+ */
+HAL_StatusTypeDef MAX30003_DrainFIFOBlock(MAX30003_HandleTypeDef *hmax, MAX30003_PoolTypeDef *pool,
+                                          MAX30003_BlockTypeDef **block) {
+    MAX30003_BlockTypeDef *b;
+    HAL_StatusTypeDef status;
+    uint64_t first;
+
+    *block = NULL;
+    if ((b = MAX30003_Pool_Alloc(pool)) == NULL)
+        return HAL_BUSY;
+
+    first = hmax->sample_index;
+    status = MAX30003_DrainFIFO(hmax, b->words, MAX30003_FIFO_LENGTH, &b->count);
+    if (status != HAL_OK || b->count == 0) {
+        MAX30003_Pool_Release(pool, b);
+        return status;
+    }
+
+    b->first_index = first;
+    *block = b;
+    return HAL_OK;
+}
+
+/**
+ * @brief Empty a block queue.
+ */
+void MAX30003_BlockQueue_Init(MAX30003_BlockQueueTypeDef *queue) {
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+}
+
+/**
+ * @brief Pass a block reference to the consumer (producer side).
+ * @details The reference moves with the block; on failure it stays with
+ *          the caller, who should release it.
+ * @return 1 if queued, 0 if the queue was full.
+ */
+uint8_t MAX30003_BlockQueue_Post(MAX30003_BlockQueueTypeDef *queue, MAX30003_BlockTypeDef *block) {
+    uint32_t head = (uint32_t)atomic_load_explicit(&queue->head, memory_order_relaxed);
+    uint32_t tail = (uint32_t)atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head - tail >= MAX30003_BLOCK_QUEUE_SIZE)
+        return 0;
+
+    queue->slots[head & (MAX30003_BLOCK_QUEUE_SIZE - 1U)] = block;
+    atomic_store_explicit(&queue->head, head + 1U, memory_order_release);
+    return 1;
+}
+
+/**
+ * @brief Take the oldest block reference (consumer side).
+ * @return Block, whose reference now belongs to the caller, or NULL.
+ */
+MAX30003_BlockTypeDef *MAX30003_BlockQueue_Take(MAX30003_BlockQueueTypeDef *queue) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    uint32_t head = (uint32_t)atomic_load_explicit(&queue->head, memory_order_acquire);
+    MAX30003_BlockTypeDef *block;
+
+    if (head == tail)
+        return NULL;
+
+    block = queue->slots[tail & (MAX30003_BLOCK_QUEUE_SIZE - 1U)];
+    atomic_store_explicit(&queue->tail, tail + 1U, memory_order_release);
+    return block;
+}
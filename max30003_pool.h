@@ -0,0 +1,139 @@
+/**
+ ******************************************************************************
+ * @file    max30003_pool.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 reference-counted FIFO block pool - Header file
+ *
+ * @note    Statically allocated FIFO-sized blocks that are drained into directly and
+ *          shared between consumers by reference instead of by copy.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_POOL_H_
+#define INC_MAX30003_POOL_H_
+
+#include "max30003_atomic.h"
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Pool Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_POOL_BLOCKS
+#define MAX30003_POOL_BLOCKS        8U      /**< Blocks in a pool (1-32) */
+#endif
+
+#if (MAX30003_POOL_BLOCKS < 1U) || (MAX30003_POOL_BLOCKS > 32U)
+#error "MAX30003_POOL_BLOCKS must be between 1 and 32"
+#endif
+
+#ifndef MAX30003_BLOCK_QUEUE_SIZE
+#define MAX30003_BLOCK_QUEUE_SIZE   8U      /**< Block pointers in a queue, power of two */
+#endif
+
+#if (MAX30003_BLOCK_QUEUE_SIZE < 2U) || ((MAX30003_BLOCK_QUEUE_SIZE & (MAX30003_BLOCK_QUEUE_SIZE - 1U)) != 0U)
+#error "MAX30003_BLOCK_QUEUE_SIZE must be a power of two >= 2"
+#endif
+
+/*
+ * Reference counts change from interrupt and thread context. Cortex-M0/M0+
+ * have no exclusive load/store, so they are guarded by masking interrupts.
+ * Override both macros (e.g. with taskENTER_CRITICAL()/taskEXIT_CRITICAL())
+ * when blocks are shared between RTOS tasks on several priorities.
+ */
+#ifndef MAX30003_CRITICAL_ENTER
+#define MAX30003_CRITICAL_ENTER()   uint32_t max30003_primask = __get_PRIMASK(); __disable_irq()
+#define MAX30003_CRITICAL_EXIT()    __set_PRIMASK(max30003_primask)
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Pool Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief One drained FIFO block
+ */
+typedef struct {
+    uint32_t words[MAX30003_FIFO_LENGTH];   /**< Raw FIFO words as read */
+    uint64_t first_index;                   /**< Device sample index of words[0] */
+    uint8_t count;                          /**< Words in use */
+    uint8_t refs;                           /**< Holders; 0 while free */
+} MAX30003_BlockTypeDef;
+
+/**
+ * @brief Fixed pool of blocks
+ */
+typedef struct {
+    MAX30003_BlockTypeDef blocks[MAX30003_POOL_BLOCKS];
+    uint32_t free_mask;         /**< Bit i set while blocks[i] is free */
+    uint32_t in_use;            /**< Blocks currently allocated */
+    uint32_t in_use_peak;       /**< Most blocks allocated at once */
+    uint32_t alloc_failures;    /**< Allocations refused because the pool was empty */
+} MAX30003_PoolTypeDef;
+
+/**
+ * @brief SPSC queue handing block references from the interrupt to a task
+ *
+ * Same scheme as MAX30003_RingTypeDef: head written by the producer, tail by
+ * the consumer, acquire/release ordering, no read-modify-write.
+ */
+typedef struct {
+    atomic_uint_fast32_t head;
+    atomic_uint_fast32_t tail;
+    MAX30003_BlockTypeDef *slots[MAX30003_BLOCK_QUEUE_SIZE];
+} MAX30003_BlockQueueTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Pool_Init(MAX30003_PoolTypeDef *pool);
+
+MAX30003_BlockTypeDef *MAX30003_Pool_Alloc(MAX30003_PoolTypeDef *pool);
+
+void MAX30003_Pool_Retain(MAX30003_BlockTypeDef *block);
+
+void MAX30003_Pool_Release(MAX30003_PoolTypeDef *pool, MAX30003_BlockTypeDef *block);
+
+uint32_t MAX30003_Pool_Available(MAX30003_PoolTypeDef *pool);
+
+HAL_StatusTypeDef MAX30003_DrainFIFOBlock(MAX30003_HandleTypeDef *hmax, MAX30003_PoolTypeDef *pool,
+                                          MAX30003_BlockTypeDef **block);
+
+void MAX30003_BlockQueue_Init(MAX30003_BlockQueueTypeDef *queue);
+
+uint8_t MAX30003_BlockQueue_Post(MAX30003_BlockQueueTypeDef *queue, MAX30003_BlockTypeDef *block);
+
+MAX30003_BlockTypeDef *MAX30003_BlockQueue_Take(MAX30003_BlockQueueTypeDef *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_POOL_H_ */
@@ -0,0 +1,340 @@
+/**
+ ******************************************************************************
+ * @file    max30003_qrs.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 fixed-point Pan-Tompkins QRS detector - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <string.h>
+#include "max30003_qrs.h"
+
+/**
+ * @brief floor(log2(v)) for v > 0.
+ */
+static uint8_t MAX30003_QRS_Log2(uint32_t v) {
+    uint8_t n = 0;
+
+    while (v >>= 1)
+        n++;
+    return n;
+}
+
+/**
+ * @brief Samples from the first input until the filter chain has settled.
+ */
+static uint32_t MAX30003_QRS_Settle(const MAX30003_QRS_TypeDef *det) {
+    return 2U * det->lp_len + det->hp_len + 4U * det->deriv_step + det->mwi_len;
+}
+
+/**
+ * @brief Clear the filter chain, keeping thresholds and RR history.
+ */
+static void MAX30003_QRS_ResetFilters(MAX30003_QRS_TypeDef *det) {
+    det->lp_i1 = 0;
+    det->lp_i2 = 0;
+    det->hp_sum = 0;
+    det->mwi_sum = 0;
+    memset(det->x, 0, sizeof(det->x));
+    memset(det->lp, 0, sizeof(det->lp));
+    memset(det->hp, 0, sizeof(det->hp));
+    memset(det->sq, 0, sizeof(det->sq));
+    memset(det->bp, 0, sizeof(det->bp));
+    det->peak = 0;
+    det->slope = 0;
+    det->sb_peak = 0;
+    det->holdoff_until = det->index + MAX30003_QRS_Settle(det);
+}
+
+/**
+ * @brief Initialize a detector for a sample rate.
+ * @details Filter lengths are the 200 Hz Pan-Tompkins design scaled to the
+ *          rate. The first 2 s after the filters settle are used to learn
+ *          the initial thresholds; no QRS is reported during that time.
+ * @param det Detector.
+ * @param rate_mHz Sample rate, e.g. from MAX30003_GetSampleRate_mHz().
+ * @param first_index Sample index of the first sample to be processed.
+ * @return HAL_OK, or HAL_ERROR if the rate is 0 or above MAX30003_QRS_MAX_HZ.
+ */
+HAL_StatusTypeDef MAX30003_QRS_Init(MAX30003_QRS_TypeDef *det, uint32_t rate_mHz, uint64_t first_index) {
+    uint32_t fs = (rate_mHz + 500U) / 1000U;
+
+    if (fs == 0 || fs > MAX30003_QRS_MAX_HZ)
+        return HAL_ERROR;
+
+    memset(det, 0, sizeof(*det));
+    det->lp_len = (uint16_t)((6U * fs + 100U) / 200U);
+    det->hp_len = (uint16_t)((32U * fs + 100U) / 200U);
+    det->deriv_step = (uint16_t)((fs + 100U) / 200U);
+    det->mwi_len = (uint16_t)((150U * fs + 500U) / 1000U);
+    if (det->lp_len == 0)
+        det->lp_len = 1;
+    if (det->hp_len < 2)
+        det->hp_len = 2;
+    if (det->deriv_step == 0)
+        det->deriv_step = 1;
+    if (det->mwi_len == 0)
+        det->mwi_len = 1;
+
+    det->lp_shift = MAX30003_QRS_Log2((uint32_t)det->lp_len * det->lp_len);
+    det->hp_shift = MAX30003_QRS_Log2(det->hp_len);
+    det->bp_delay = (det->lp_len - 1U) + (det->hp_len - 1U) / 2U;
+    det->delay = det->bp_delay + 2U * det->deriv_step + (det->mwi_len - 1U) / 2U;
+    det->refractory = fs * 200U / 1000U;
+    det->twave = fs * 360U / 1000U;
+    det->learn = 2U * fs;
+
+    det->index = first_index;
+    MAX30003_QRS_ResetFilters(det);
+    return HAL_OK;
+}
+
+/**
+ * @brief R position for an integrator peak.
+ * @details Searches the band-pass magnitudes that fed the peak's window
+ *          (mwi_len slopes, each 2 * deriv_step behind the band-pass) for
+ *          the largest, and removes the band-pass delay. Falls back to the
+ *          fixed integrator delay if the window has left the history.
+ */
+static uint64_t MAX30003_QRS_Locate(const MAX30003_QRS_TypeDef *det, uint64_t peak_index) {
+    const uint32_t span = det->mwi_len + 2U * det->deriv_step;
+    uint64_t best = peak_index;
+    uint32_t best_v = 0;
+
+    if (peak_index < span || det->bp_end - (peak_index - span) > MAX30003_QRS_BP_HIST)
+        return peak_index > det->delay ? peak_index - det->delay : 0;
+
+    for (uint64_t j = peak_index - span; j <= peak_index; ++j) {
+        uint32_t v = det->bp[(uint32_t)j & (MAX30003_QRS_BP_HIST - 1U)];
+
+        if (v > best_v) {
+            best_v = v;
+            best = j;
+        }
+    }
+    return best > det->bp_delay ? best - det->bp_delay : 0;
+}
+
+/**
+ * @brief Report a QRS and update the RR average and signal estimate.
+ */
+static void MAX30003_QRS_Emit(MAX30003_QRS_TypeDef *det, uint32_t peak, uint64_t index, uint64_t r_index,
+                              uint16_t slope, uint8_t searchback, MAX30003_QRSEventTypeDef *events,
+                              uint32_t max_events, uint32_t *n) {
+    uint32_t rr = det->have_last ? (uint32_t)(index - det->last_qrs) : 0;
+
+    if (rr != 0)
+        det->rr_avg = det->rr_avg == 0 ? rr
+            : (uint32_t)((int32_t)det->rr_avg + (((int32_t)rr - (int32_t)det->rr_avg) >> 3));
+
+    /* Searchback peaks are weighted more, as in the original */
+    if (searchback)
+        det->spki = (uint32_t)((int64_t)det->spki + (((int64_t)peak - det->spki) >> 2));
+    else
+        det->spki = (uint32_t)((int64_t)det->spki + (((int64_t)peak - det->spki) >> 3));
+
+    det->last_qrs = index;
+    det->have_last = 1;
+    det->qrs_slope = slope;
+    det->sb_peak = 0;
+    det->beats++;
+
+    if (*n < max_events) {
+        MAX30003_QRSEventTypeDef *ev = &events[(*n)++];
+
+        ev->sample_index = r_index;
+        ev->rr = rr;
+        ev->peak = peak;
+        ev->searchback = searchback;
+    }
+}
+
+/**
+ * @brief Classify a finished integrator peak as QRS or noise.
+ */
+static void MAX30003_QRS_Classify(MAX30003_QRS_TypeDef *det, MAX30003_QRSEventTypeDef *events,
+                                  uint32_t max_events, uint32_t *n) {
+    uint32_t peak = det->peak;
+    uint64_t since = det->have_last ? det->peak_index - det->last_qrs : UINT64_MAX;
+    uint8_t twave;
+
+    if (det->spki == 0) {
+        if (peak > det->learn_max)
+            det->learn_max = peak;
+        return;
+    }
+
+    twave = since < det->twave && det->peak_slope < det->qrs_slope / 2U;
+    if (peak >= det->thr1 && since >= det->refractory && !twave) {
+        MAX30003_QRS_Emit(det, peak, det->peak_index, MAX30003_QRS_Locate(det, det->peak_index), det->peak_slope, 0,
+                          events, max_events, n);
+    } else {
+        det->npki = (uint32_t)((int64_t)det->npki + (((int64_t)peak - det->npki) >> 3));
+        if (!twave && since >= det->refractory && peak >= det->thr1 / 2U && peak > det->sb_peak) {
+            det->sb_peak = peak;
+            det->sb_index = det->peak_index;
+            det->sb_r_index = MAX30003_QRS_Locate(det, det->peak_index);
+            det->sb_slope = det->peak_slope;
+        }
+    }
+    det->thr1 = det->npki + (det->spki - det->npki) / 4U;
+}
+
+/**
+ * @brief Run one block of at most MAX30003_QRS_BLOCK samples.
+ */
+static uint32_t MAX30003_QRS_Block(MAX30003_QRS_TypeDef *det, const int32_t *ecg, uint32_t count,
+                                   MAX30003_QRSEventTypeDef *events, uint32_t max_events) {
+    int32_t comb[MAX30003_QRS_BLOCK];
+    uint32_t mwi[MAX30003_QRS_BLOCK];
+    uint16_t slope[MAX30003_QRS_BLOCK];
+    int32_t *x = det->x + MAX30003_QRS_X_HIST;
+    int32_t *lp = det->lp + MAX30003_QRS_LP_HIST;
+    int32_t *hp = det->hp + MAX30003_QRS_HP_HIST;
+    uint32_t *sq = det->sq + MAX30003_QRS_SQ_HIST;
+    const uint32_t m = det->lp_len, M = det->hp_len, s = det->deriv_step, W = det->mwi_len;
+    const uint32_t centre = (M - 1U) / 2U;
+    uint32_t i, n = 0;
+
+    /* Low-pass: comb (1 - z^-m)^2, then two integrators */
+    memcpy(x, ecg, count * sizeof(*x));
+    for (i = 0; i < count; ++i)
+        comb[i] = x[i] - 2 * x[(int32_t)i - (int32_t)m] + x[(int32_t)i - 2 * (int32_t)m];
+    for (i = 0; i < count; ++i) {
+        det->lp_i1 += (uint32_t)comb[i];
+        det->lp_i2 += det->lp_i1;
+        lp[i] = (int32_t)det->lp_i2 >> det->lp_shift;
+    }
+
+    /* High-pass: centre tap minus the running mean, kept scaled by M */
+    for (i = 0; i < count; ++i) {
+        det->hp_sum += lp[i] - lp[(int32_t)i - (int32_t)M];
+        hp[i] = (lp[(int32_t)i - (int32_t)centre] * (int32_t)M - det->hp_sum) >> det->hp_shift;
+    }
+
+    /* Five-point derivative, squared */
+    for (i = 0; i < count; ++i) {
+        int32_t d = (2 * hp[i] + hp[(int32_t)i - (int32_t)s]
+                     - hp[(int32_t)i - 3 * (int32_t)s] - 2 * hp[(int32_t)i - 4 * (int32_t)s]) >> 3;
+
+        d = d > 32767 ? 32767 : d < -32767 ? -32767 : d;
+        slope[i] = (uint16_t)(d < 0 ? -d : d);
+        sq[i] = (uint32_t)(d * d) >> 6;
+        det->bp[(uint32_t)(det->index + i) & (MAX30003_QRS_BP_HIST - 1U)] = (uint32_t)(hp[i] < 0 ? -hp[i] : hp[i]);
+    }
+    det->bp_end = det->index + count;
+
+    /* Moving-window integration */
+    for (i = 0; i < count; ++i) {
+        det->mwi_sum += sq[i] - sq[(int32_t)i - (int32_t)W];
+        mwi[i] = det->mwi_sum;
+    }
+
+    /* Keep each stage's tail as history for the next block */
+    memmove(det->x, det->x + count, MAX30003_QRS_X_HIST * sizeof(det->x[0]));
+    memmove(det->lp, det->lp + count, MAX30003_QRS_LP_HIST * sizeof(det->lp[0]));
+    memmove(det->hp, det->hp + count, MAX30003_QRS_HP_HIST * sizeof(det->hp[0]));
+    memmove(det->sq, det->sq + count, MAX30003_QRS_SQ_HIST * sizeof(det->sq[0]));
+
+    /* Decisions */
+    for (i = 0; i < count; ++i) {
+        uint64_t idx = det->index + i;
+
+        if (idx < det->holdoff_until)
+            continue;
+        if (det->spki == 0 && det->learn_max != 0 && idx >= det->holdoff_until + det->learn) {
+            det->spki = det->learn_max / 2U;
+            det->npki = det->learn_max / 8U;
+            det->thr1 = det->npki + (det->spki - det->npki) / 4U;
+        }
+
+        if (slope[i] > det->slope)
+            det->slope = slope[i];
+
+        if (mwi[i] > det->peak) {
+            det->peak = mwi[i];
+            det->peak_index = idx;
+            det->peak_slope = det->slope;
+        } else if (det->peak != 0 && mwi[i] < det->peak / 2U) {
+            MAX30003_QRS_Classify(det, events, max_events, &n);
+            det->peak = 0;
+            det->slope = 0;
+        }
+
+        /* Searchback: nothing above THR1 for 166% of the average RR */
+        if (det->sb_peak != 0 && det->rr_avg != 0 && det->have_last &&
+            idx - det->last_qrs > det->rr_avg + (det->rr_avg * 2U) / 3U) {
+            MAX30003_QRS_Emit(det, det->sb_peak, det->sb_index, det->sb_r_index, det->sb_slope, 1, events,
+                              max_events, &n);
+            det->thr1 = det->npki + (det->spki - det->npki) / 4U;
+        }
+    }
+
+    det->index += count;
+    return n;
+}
+
+/**
+ * @brief Feed a block of decoded ECG codes (one drain or more).
+ * @details Blocks are split into MAX30003_QRS_BLOCK passes; each filter
+ *          stage runs over the whole pass before the next, so per-sample
+ *          call overhead is paid once per pass. Detection lags the R wave by
+ *          roughly the integration window plus the filter delays; the
+ *          reported sample_index is the R position itself.
+ * @param det Detector.
+ * @param ecg Sign-extended ECG codes, consecutive samples.
+ * @param count Number of samples.
+ * @param events Output, detected QRS complexes.
+ * @param max_events Capacity of events; further detections are still
+ *        tracked but not reported.
+ * @return Number of events written.
+ */
+uint32_t MAX30003_QRS_Process(MAX30003_QRS_TypeDef *det, const int32_t *ecg, uint32_t count,
+                              MAX30003_QRSEventTypeDef *events, uint32_t max_events) {
+    uint32_t n = 0;
+
+    while (count > 0) {
+        uint32_t chunk = count < MAX30003_QRS_BLOCK ? count : MAX30003_QRS_BLOCK;
+
+        n += MAX30003_QRS_Block(det, ecg, chunk, events + n, max_events - n);
+        ecg += chunk;
+        count -= chunk;
+    }
+    return n;
+}
+
+/**
+ * @brief Account for samples missing from the input, e.g. a ring gap record.
+ * @details The filters restart after the gap and hold off decisions until
+ *          they have settled; thresholds are kept, the next RR is not
+ *          reported across the gap.
+ * @param det Detector.
+ * @param dropped Samples lost.
+ */
+void MAX30003_QRS_Gap(MAX30003_QRS_TypeDef *det, uint32_t dropped) {
+    det->index += dropped;
+    det->have_last = 0;
+    MAX30003_QRS_ResetFilters(det);
+}
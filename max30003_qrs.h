@@ -0,0 +1,151 @@
+/**
+ ******************************************************************************
+ * @file    max30003_qrs.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 fixed-point Pan-Tompkins QRS detector - Header file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_QRS_H_
+#define INC_MAX30003_QRS_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Detector Configuration
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_QRS_MAX_HZ     512U    /**< Highest supported sample rate */
+#define MAX30003_QRS_BLOCK      32U     /**< Samples per internal pass, one full FIFO */
+
+/* Filter lengths scale from the original 200 Hz design; sizes at MAX30003_QRS_MAX_HZ */
+#define MAX30003_QRS_LP_MAX     ((6U * MAX30003_QRS_MAX_HZ + 100U) / 200U)      /**< Low-pass comb delay */
+#define MAX30003_QRS_HP_MAX     ((32U * MAX30003_QRS_MAX_HZ + 100U) / 200U)     /**< High-pass average length */
+#define MAX30003_QRS_DERIV_MAX  ((MAX30003_QRS_MAX_HZ + 100U) / 200U)           /**< Derivative tap spacing */
+#define MAX30003_QRS_MWI_MAX    ((150U * MAX30003_QRS_MAX_HZ + 500U) / 1000U)   /**< 150 ms integration window */
+
+#define MAX30003_QRS_X_HIST     (2U * MAX30003_QRS_LP_MAX)
+#define MAX30003_QRS_LP_HIST    MAX30003_QRS_HP_MAX
+#define MAX30003_QRS_HP_HIST    (4U * MAX30003_QRS_DERIV_MAX)
+#define MAX30003_QRS_SQ_HIST    MAX30003_QRS_MWI_MAX
+#define MAX30003_QRS_BP_HIST    256U    /**< |band-pass| kept to locate R, power of two */
+
+#if MAX30003_QRS_BP_HIST < 2U * (MAX30003_QRS_MWI_MAX + 2U * MAX30003_QRS_DERIV_MAX + MAX30003_QRS_BLOCK)
+#error "MAX30003_QRS_BP_HIST must cover two integration windows plus a block"
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Detector Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief One detected QRS complex
+ */
+typedef struct {
+    uint64_t sample_index;      /**< R position: band-pass maximum under the integrator peak, filter delay removed */
+    uint32_t rr;                /**< Samples since the previous QRS, 0 for the first */
+    uint32_t peak;              /**< Integrated energy at the detection peak */
+    uint8_t searchback;         /**< Non-zero if found by searchback below THR1 */
+} MAX30003_QRSEventTypeDef;
+
+/**
+ * @brief Pan-Tompkins detector state
+ *
+ * Each block goes through every stage in turn over a linear buffer whose
+ * head holds the stage's history, so the per-stage loops have no
+ * wrap-around. The low-pass is an integer comb/integrator pair running in
+ * modular uint32_t arithmetic, the high-pass subtracts a running mean from
+ * a centre tap, and the moving-window sum is kept unscaled. Thresholds
+ * follow the original signal/noise peak estimates with searchback and
+ * T-wave slope rejection. The integrator peak trails R by most of the QRS
+ * width, so R is placed at the largest band-pass magnitude in the window
+ * that built the peak, less the band-pass delay.
+ */
+typedef struct {
+    /* Rate-dependent parameters */
+    uint16_t lp_len;            /**< Low-pass comb delay m */
+    uint16_t hp_len;            /**< High-pass averaging length */
+    uint16_t deriv_step;        /**< Derivative tap spacing */
+    uint16_t mwi_len;           /**< Integration window */
+    uint8_t lp_shift;           /**< Low-pass gain normalisation */
+    uint8_t hp_shift;           /**< High-pass gain normalisation */
+    uint32_t delay;             /**< Group delay from input to integrator centre, fallback for R */
+    uint32_t bp_delay;          /**< Group delay from input to band-pass output */
+    uint32_t refractory;        /**< 200 ms */
+    uint32_t twave;             /**< 360 ms */
+    uint32_t learn;             /**< 2 s learning phase */
+
+    /* Filter state */
+    uint32_t lp_i1, lp_i2;      /**< Low-pass integrators, modular */
+    int32_t hp_sum;             /**< Running sum of the last hp_len low-pass outputs */
+    uint32_t mwi_sum;           /**< Running sum of the last mwi_len squared slopes */
+    int32_t x[MAX30003_QRS_X_HIST + MAX30003_QRS_BLOCK];
+    int32_t lp[MAX30003_QRS_LP_HIST + MAX30003_QRS_BLOCK];
+    int32_t hp[MAX30003_QRS_HP_HIST + MAX30003_QRS_BLOCK];
+    uint32_t sq[MAX30003_QRS_SQ_HIST + MAX30003_QRS_BLOCK];
+    uint32_t bp[MAX30003_QRS_BP_HIST];      /**< |band-pass| by sample index modulo MAX30003_QRS_BP_HIST */
+    uint64_t bp_end;            /**< Index after the newest bp entry */
+
+    /* Decision state */
+    uint64_t index;             /**< Index of the next input sample */
+    uint64_t holdoff_until;     /**< No decisions before this index (start-up, gaps) */
+    uint64_t last_qrs;          /**< Integrator-peak index of the last QRS */
+    uint32_t spki, npki;        /**< Signal and noise peak estimates */
+    uint32_t thr1;              /**< Primary threshold */
+    uint32_t rr_avg;            /**< Running RR average, samples */
+    uint32_t learn_max;         /**< Largest peak during learning */
+    uint32_t peak;              /**< Peak of the current rise */
+    uint64_t peak_index;
+    uint16_t peak_slope;        /**< Largest slope leading into the current peak */
+    uint16_t slope;             /**< Largest slope since the last peak was closed */
+    uint16_t qrs_slope;         /**< Slope of the last QRS */
+    uint32_t sb_peak;           /**< Best searchback candidate since the last QRS */
+    uint64_t sb_index;
+    uint64_t sb_r_index;        /**< R position of the searchback candidate */
+    uint16_t sb_slope;
+    uint8_t have_last;          /**< last_qrs is valid for an RR interval */
+    uint32_t beats;             /**< QRS complexes detected */
+} MAX30003_QRS_TypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef MAX30003_QRS_Init(MAX30003_QRS_TypeDef *det, uint32_t rate_mHz, uint64_t first_index);
+
+uint32_t MAX30003_QRS_Process(MAX30003_QRS_TypeDef *det, const int32_t *ecg, uint32_t count,
+                              MAX30003_QRSEventTypeDef *events, uint32_t max_events);
+
+void MAX30003_QRS_Gap(MAX30003_QRS_TypeDef *det, uint32_t dropped);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_QRS_H_ */
@@ -0,0 +1,290 @@
+/**
+ ******************************************************************************
+ * @file    max30003_resample.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 polyphase rational resampler - Source file
+ *
+ * @note    Design uses double precision once at init; processing is integer only,
+ *          with 32x16 MACs into a 64-bit accumulator (SMLAL on Cortex-M).
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <math.h>
+#include <string.h>
+#include "max30003_resample.h"
+
+#define MAX30003_RESAMPLE_PI            3.14159265358979323846
+#define MAX30003_RESAMPLE_KAISER_BETA   6.0     /**< About 63 dB stopband */
+#define MAX30003_RESAMPLE_ONE           (1L << MAX30003_RESAMPLE_COEFF_FRAC)
+#define MAX30003_RESAMPLE_HB_PASS       0.14    /**< Highest cutoff, cycles per input sample, the half-band keeps clear */
+
+/* ---------------------------------------------------------------------------
+ * Design
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Zeroth-order modified Bessel function, power series.
+ */
+static double MAX30003_Resample_I0(double x) {
+    double sum = 1.0, term = 1.0;
+
+    for (uint32_t k = 1; k < 32U && term > 1e-12 * sum; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+static uint32_t MAX30003_Resample_GCD(uint32_t a, uint32_t b) {
+    while (b != 0U) {
+        uint32_t t = a % b;
+
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief Set up the ratio and design the branches for a pair of rates.
+ * @details The prototype is a Kaiser-windowed sinc at the interpolated rate
+ *          L * in, cut off at MAX30003_RESAMPLE_CUTOFF_PCT of the lower
+ *          rate and MAX30003_RESAMPLE_ZEROS zero crossings long on each
+ *          side. After rounding, each branch's centre tap is adjusted so
+ *          the branch sums to exactly 1. Otherwise the branch gains differ
+ *          slightly and modulate the signal at the branch rate.
+ *          If that needs more than MAX30003_RESAMPLE_TAPS taps and M is
+ *          even, a half-band stage halves the input rate first and the
+ *          branches are designed for the remaining L / (M / 2). The
+ *          half-band is a Kaiser-windowed sinc with the same window, its
+ *          taps adjusted so the filter sums to exactly 1.
+ * @param rs Resampler.
+ * @param channels Channels to run, 1..MAX30003_RESAMPLE_CHANNELS.
+ * @param in_mHz Input rate, e.g. from MAX30003_GetSampleRate_mHz().
+ * @param out_mHz Output rate.
+ * @return HAL_OK, or HAL_ERROR if the reduced ratio needs more than
+ *         MAX30003_RESAMPLE_PHASES branches or MAX30003_RESAMPLE_TAPS taps.
+ */
+HAL_StatusTypeDef MAX30003_Resample_Init(MAX30003_ResampleTypeDef *rs, uint32_t channels, uint32_t in_mHz,
+                                         uint32_t out_mHz) {
+    uint32_t g, L, M, taps, N, decim = 1U;
+    double fc, norm;
+
+    if (rs == NULL || channels == 0U || channels > MAX30003_RESAMPLE_CHANNELS || in_mHz == 0U || out_mHz == 0U)
+        return HAL_ERROR;
+
+    g = MAX30003_Resample_GCD(in_mHz, out_mHz);
+    L = out_mHz / g;
+    M = in_mHz / g;
+    /* Cutoff in cycles per input sample; the sinc spans ZEROS / fc input samples */
+    fc = (L < M ? (double)L / M : 1.0) * MAX30003_RESAMPLE_CUTOFF_PCT / 100.0;
+    taps = (uint32_t)ceil(MAX30003_RESAMPLE_ZEROS / fc);
+    /* Too long for one stage: halve the rate first if the cutoff stays in the half-band's passband */
+    if (taps > MAX30003_RESAMPLE_TAPS && M % 2U == 0U && fc <= MAX30003_RESAMPLE_HB_PASS) {
+        decim = 2U;
+        fc *= 2.0;
+        taps = (uint32_t)ceil(MAX30003_RESAMPLE_ZEROS / fc);
+    }
+    if (L > MAX30003_RESAMPLE_PHASES || taps > MAX30003_RESAMPLE_TAPS)
+        return HAL_ERROR;
+
+    memset(rs, 0, sizeof(*rs));
+    rs->L = L;
+    rs->M = M;
+    rs->in_mHz = in_mHz;
+    rs->taps = taps;
+    rs->channels = channels;
+    rs->decim = decim;
+
+    norm = MAX30003_Resample_I0(MAX30003_RESAMPLE_KAISER_BETA);
+    if (decim == 2U) {
+        int32_t sum = 0;
+
+        for (uint32_t k = 0; k < MAX30003_RESAMPLE_HB_COEFFS; ++k) {
+            const double n = 2.0 * k + 1.0;                    /* Input samples from the centre */
+            const double r = n / (MAX30003_RESAMPLE_HB_TAPS / 2.0);
+            double h = sin(MAX30003_RESAMPLE_PI * n / 2.0) / (MAX30003_RESAMPLE_PI * n);
+
+            h *= MAX30003_Resample_I0(MAX30003_RESAMPLE_KAISER_BETA * sqrt(1.0 - r * r)) / norm;
+            rs->hb[k] = (int16_t)floor(h * MAX30003_RESAMPLE_ONE + 0.5);
+            sum += rs->hb[k];
+        }
+        /* Centre 1/2 plus both sides of every tap sums to 1 */
+        rs->hb[0] = (int16_t)(rs->hb[0] + (MAX30003_RESAMPLE_ONE / 4 - sum));
+    }
+
+    N = taps * L;
+    for (uint32_t p = 0; p < L; ++p) {
+        int32_t sum = 0;
+        uint32_t centre = 0;
+
+        for (uint32_t j = 0; j < taps; ++j) {
+            /* Branch p, tap k = taps - 1 - j, prototype index p + k * L */
+            const double i = p + (double)(taps - 1U - j) * L;
+            const double t = (i - (N - 1) / 2.0) / L;           /* Input samples from the centre */
+            const double r = (i - (N - 1) / 2.0) / (N / 2.0);
+            const double x = 2.0 * fc * t;
+            double h = 2.0 * fc * (x == 0.0 ? 1.0 : sin(MAX30003_RESAMPLE_PI * x) / (MAX30003_RESAMPLE_PI * x));
+
+            h *= MAX30003_Resample_I0(MAX30003_RESAMPLE_KAISER_BETA * sqrt(1.0 - r * r)) / norm;
+            rs->h[p][j] = (int16_t)floor(h * MAX30003_RESAMPLE_ONE + 0.5);
+            sum += rs->h[p][j];
+            if (rs->h[p][j] > rs->h[p][centre])
+                centre = j;
+        }
+        rs->h[p][centre] = (int16_t)(rs->h[p][centre] + (MAX30003_RESAMPLE_ONE - sum));
+    }
+    return HAL_OK;
+}
+
+/**
+ * @brief Time by which the output lags the input, from the prototype's
+ *        group delay of (taps * L - 1) / 2 interpolated samples, plus
+ *        (MAX30003_RESAMPLE_HB_TAPS - 1) / 2 input samples for the
+ *        half-band stage.
+ * @param rs Resampler.
+ * @return Delay in microseconds.
+ */
+uint32_t MAX30003_Resample_Delay_us(const MAX30003_ResampleTypeDef *rs) {
+    uint64_t half_steps = rs->decim * ((uint64_t)rs->taps * rs->L - 1U);    /* 2 * delay * L, input samples */
+
+    if (rs->decim == 2U)
+        half_steps += (uint64_t)(MAX30003_RESAMPLE_HB_TAPS - 1U) * rs->L;
+    return (uint32_t)((half_steps * 1000000000ULL / (2U * rs->L) + rs->in_mHz / 2U) / rs->in_mHz);
+}
+
+/* ---------------------------------------------------------------------------
+ * Processing
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief One output: branch taps against the window ending at x[taps - 1].
+ */
+static int32_t MAX30003_Resample_Dot(const int16_t *h, const int32_t *x, uint32_t taps) {
+    int64_t acc = 1L << (MAX30003_RESAMPLE_COEFF_FRAC - 1U);
+
+    for (uint32_t j = 0; j < taps; ++j)
+        acc += (int64_t)h[j] * x[j];
+    acc >>= MAX30003_RESAMPLE_COEFF_FRAC;
+    return acc > INT32_MAX ? INT32_MAX : acc < INT32_MIN ? INT32_MIN : (int32_t)acc;
+}
+
+/**
+ * @brief One half-band output centred on x[MAX30003_RESAMPLE_HB_TAPS / 2].
+ */
+static int32_t MAX30003_Resample_HalfBandDot(const int16_t *hb, const int32_t *x) {
+    const int32_t *centre = x + MAX30003_RESAMPLE_HB_TAPS / 2U;
+    int64_t acc = ((int64_t)centre[0] << (MAX30003_RESAMPLE_COEFF_FRAC - 1U))
+        + (1L << (MAX30003_RESAMPLE_COEFF_FRAC - 1U));
+
+    for (uint32_t k = 0; k < MAX30003_RESAMPLE_HB_COEFFS; ++k)
+        acc += (int64_t)hb[k] * ((int64_t)centre[-1 - 2 * (int32_t)k] + centre[1 + 2 * k]);
+    acc >>= MAX30003_RESAMPLE_COEFF_FRAC;
+    return acc > INT32_MAX ? INT32_MAX : acc < INT32_MIN ? INT32_MIN : (int32_t)acc;
+}
+
+/**
+ * @brief Halve the rate of one input block into the branch buffer.
+ * @details Keeps every other half-band output; the parity carries over
+ *          between blocks in hb_next.
+ * @return Samples appended to rs->x after its taps - 1 history.
+ */
+static uint32_t MAX30003_Resample_HalfBand(MAX30003_ResampleTypeDef *rs, const int32_t *const *in,
+                                           uint32_t offset, uint32_t len) {
+    const uint32_t hist = MAX30003_RESAMPLE_HB_TAPS - 1U, dst = rs->taps - 1U;
+    uint32_t n = 0;
+
+    for (uint32_t c = 0; c < rs->channels; ++c)
+        memcpy(&rs->xh[c][hist], in[c] + offset, len * sizeof(int32_t));
+
+    for (; rs->hb_next < len; rs->hb_next += 2U, ++n)
+        for (uint32_t c = 0; c < rs->channels; ++c)
+            rs->x[c][dst + n] = MAX30003_Resample_HalfBandDot(rs->hb, &rs->xh[c][rs->hb_next]);
+    rs->hb_next -= len;
+
+    for (uint32_t c = 0; c < rs->channels; ++c)
+        memmove(rs->xh[c], &rs->xh[c][len], hist * sizeof(int32_t));
+    return n;
+}
+
+/**
+ * @brief Run the branches over len new samples already in rs->x.
+ * @return Output count, continuing from produced.
+ */
+static uint32_t MAX30003_Resample_Branches(MAX30003_ResampleTypeDef *rs, int32_t *const *out, uint32_t len,
+                                           uint32_t produced) {
+    const uint32_t hist = rs->taps - 1U, M = rs->M / rs->decim, step = M / rs->L, frac = M % rs->L;
+
+    while (rs->next < len) {
+        for (uint32_t c = 0; c < rs->channels; ++c)
+            out[c][produced] = MAX30003_Resample_Dot(rs->h[rs->phase], &rs->x[c][rs->next], rs->taps);
+        produced++;
+
+        rs->next += step;
+        rs->phase += frac;
+        if (rs->phase >= rs->L) {
+            rs->phase -= rs->L;
+            rs->next++;
+        }
+    }
+    rs->next -= len;
+
+    for (uint32_t c = 0; c < rs->channels; ++c)
+        memmove(rs->x[c], &rs->x[c][len], hist * sizeof(int32_t));
+    return produced;
+}
+
+/**
+ * @brief Resample one block on every channel.
+ * @details Input may be ECG codes or filter bank output; the output keeps
+ *          the input's scale. Any block length is accepted and the phase
+ *          carries over between calls, so output m always lands at input
+ *          time m * M / L.
+ * @param rs Resampler.
+ * @param in Input samples, one pointer per channel.
+ * @param out Output, one pointer per channel, room for
+ *            MAX30003_RESAMPLE_MAX_OUT(count, L, M) samples.
+ * @param count Input samples per channel.
+ * @return Output samples written per channel.
+ */
+uint32_t MAX30003_Resample_Process(MAX30003_ResampleTypeDef *rs, const int32_t *const *in, int32_t *const *out,
+                                   uint32_t count) {
+    uint32_t produced = 0, offset = 0;
+
+    while (offset < count) {
+        const uint32_t len = count - offset < MAX30003_RESAMPLE_BLOCK ? count - offset : MAX30003_RESAMPLE_BLOCK;
+        uint32_t n = len;
+
+        if (rs->decim == 2U)
+            n = MAX30003_Resample_HalfBand(rs, in, offset, len);
+        else
+            for (uint32_t c = 0; c < rs->channels; ++c)
+                memcpy(&rs->x[c][rs->taps - 1U], in[c] + offset, len * sizeof(int32_t));
+
+        produced = MAX30003_Resample_Branches(rs, out, n, produced);
+        offset += len;
+    }
+    return produced;
+}
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * @file    max30003_resample.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 polyphase rational resampler - Header file
+ *
+ * @note    Converts decoded samples between rates in an L/M ratio, e.g. 512 -> 250 sps,
+ *          with a Kaiser-windowed sinc split into L polyphase branches.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_RESAMPLE_H_
+#define INC_MAX30003_RESAMPLE_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Resampler Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_RESAMPLE_CHANNELS
+#define MAX30003_RESAMPLE_CHANNELS  1U          /**< Channels per resampler, 484 B of state each */
+#endif
+
+#ifndef MAX30003_RESAMPLE_PHASES
+#define MAX30003_RESAMPLE_PHASES    125U        /**< Largest L, 125 for 512/256/128 -> 250/125 sps */
+#endif
+
+#ifndef MAX30003_RESAMPLE_TAPS
+#define MAX30003_RESAMPLE_TAPS      40U         /**< Largest taps per phase, after any half-band stage */
+#endif
+
+#define MAX30003_RESAMPLE_BLOCK     32U         /**< Input samples per internal pass, one full FIFO */
+#define MAX30003_RESAMPLE_ZEROS     8U          /**< Sinc zero crossings on each side of the centre */
+#define MAX30003_RESAMPLE_CUTOFF_PCT 45U        /**< Cutoff, percent of the lower of the two rates */
+#define MAX30003_RESAMPLE_COEFF_FRAC 15U        /**< Coefficients are Q15 */
+#define MAX30003_RESAMPLE_HB_TAPS   19U         /**< Half-band pre-decimator length, 4k - 1 */
+#define MAX30003_RESAMPLE_HB_COEFFS ((MAX30003_RESAMPLE_HB_TAPS + 1U) / 4U) /**< Distinct non-zero half-band taps */
+
+/** @brief Output samples produced per channel by count input samples, at most */
+#define MAX30003_RESAMPLE_MAX_OUT(count, L, M)  (((count) * (L) + (M) - 1U) / (M))
+
+/* ---------------------------------------------------------------------------
+ * Resampler Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Resampler state
+ *
+ * Output m is taken at input time m * M / L. Its taps come from branch
+ * (m * M) mod L of the prototype low-pass, so each output costs `taps`
+ * MACs whatever the ratio. Branches are stored reversed and run forward
+ * over a linear buffer holding the last taps - 1 inputs ahead of the
+ * current block. All channels advance together and share the
+ * coefficients.
+ *
+ * When one stage would need more than MAX30003_RESAMPLE_TAPS taps (512 ->
+ * 125 sps needs 73), a half-band filter first halves the rate and the
+ * branches run at M / 2. Every other half-band tap is zero and the centre
+ * tap is 1/2, so it costs MAX30003_RESAMPLE_HB_COEFFS MACs per kept sample.
+ *
+ * With the default limits the branch table is 10,000 B and the struct is
+ * 10,532 B for one channel; each further MAX30003_RESAMPLE_CHANNELS adds
+ * 484 B of history (13,920 B at 8 channels).
+ */
+typedef struct {
+    int16_t h[MAX30003_RESAMPLE_PHASES][MAX30003_RESAMPLE_TAPS];   /**< Branches, Q15, each summing to 1 */
+    uint32_t L;                 /**< Interpolation factor */
+    uint32_t M;                 /**< Decimation factor */
+    uint32_t in_mHz;            /**< Input rate */
+    uint32_t taps;              /**< Taps per branch */
+    uint32_t channels;          /**< Channels in use */
+    uint32_t phase;             /**< Branch of the next output, 0..L-1 */
+    uint32_t next;              /**< Block index of the newest input of the next output */
+    uint32_t decim;             /**< 2 with the half-band ahead of the branches, else 1 */
+    uint32_t hb_next;           /**< Block index of the newest input of the next half-band output */
+    int16_t hb[MAX30003_RESAMPLE_HB_COEFFS];                        /**< Half-band taps 1, 3, 5, ... from the centre, Q15 */
+    int32_t x[MAX30003_RESAMPLE_CHANNELS][MAX30003_RESAMPLE_TAPS - 1U + MAX30003_RESAMPLE_BLOCK];
+    int32_t xh[MAX30003_RESAMPLE_CHANNELS][MAX30003_RESAMPLE_HB_TAPS - 1U + MAX30003_RESAMPLE_BLOCK];
+} MAX30003_ResampleTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef MAX30003_Resample_Init(MAX30003_ResampleTypeDef *rs, uint32_t channels, uint32_t in_mHz,
+                                         uint32_t out_mHz);
+
+uint32_t MAX30003_Resample_Process(MAX30003_ResampleTypeDef *rs, const int32_t *const *in, int32_t *const *out,
+                                   uint32_t count);
+
+uint32_t MAX30003_Resample_Delay_us(const MAX30003_ResampleTypeDef *rs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_RESAMPLE_H_ */
@@ -0,0 +1,259 @@
+/**
+ ******************************************************************************
+ * @file    max30003_ring.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 lock-free sample ring - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_ring.h"
+#include "max30003_decode.h"
+#include "max30003_pack.h"
+
+/* Largest count one gap record can carry; longer gaps take several records */
+#ifdef MAX30003_RING_PACKED
+#define MAX30003_RING_GAP_LIMIT     MAX30003_RING_GAP_MAX
+#else
+#define MAX30003_RING_GAP_LIMIT     ((uint32_t)INT32_MAX)
+#endif
+
+#ifdef MAX30003_RING_PACKED
+/**
+ * @brief Store a sample in PACK24 layout.
+ * @details Gap records spread the lost-sample count over the data field and
+ *          the three spare bits below the ETAG.
+ */
+static inline void MAX30003_Ring_Store(MAX30003_RingTypeDef *ring, uint32_t slot, const MAX30003_SampleTypeDef *sample) {
+    uint32_t w;
+
+    if (sample->etag == MAX30003_FIFO_ETAG_OVERFLOW) {
+        uint32_t n = (uint32_t)sample->ecg;
+
+        if (n > MAX30003_RING_GAP_MAX)
+            n = MAX30003_RING_GAP_MAX;
+        w = ((n >> 3) << 6) | (n & 0x07U);
+    } else {
+        w = ((uint32_t)sample->ecg & 0x3FFFFU) << 6;
+    }
+    w |= (uint32_t)sample->etag << MAX30003_ETAG_SHIFT;
+    MAX30003_Pack24(&w, ring->buf[slot], 1);
+}
+
+/**
+ * @brief Load a PACK24 slot back into a sample.
+ */
+static inline void MAX30003_Ring_Load(const MAX30003_RingTypeDef *ring, uint32_t slot, MAX30003_SampleTypeDef *sample) {
+    uint32_t w;
+
+    MAX30003_Unpack24(ring->buf[slot], &w, 1);
+    sample->etag = (w >> MAX30003_ETAG_SHIFT) & MAX30003_ETAG_MASK;
+    if (sample->etag == MAX30003_FIFO_ETAG_OVERFLOW)
+        sample->ecg = (int32_t)(((w >> 6) << 3) | (w & 0x07U));
+    else
+        sample->ecg = MAX30003_DecodeSample(w);
+}
+#else
+static inline void MAX30003_Ring_Store(MAX30003_RingTypeDef *ring, uint32_t slot, const MAX30003_SampleTypeDef *sample) {
+    ring->buf[slot] = *sample;
+}
+
+static inline void MAX30003_Ring_Load(const MAX30003_RingTypeDef *ring, uint32_t slot, MAX30003_SampleTypeDef *sample) {
+    *sample = ring->buf[slot];
+}
+#endif
+
+/**
+ * @brief Reset a ring to empty with zeroed counters.
+ * @param ring Ring to initialize; neither side may be using it.
+ */
+void MAX30003_Ring_Init(MAX30003_RingTypeDef *ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->overruns, 0);
+    atomic_init(&ring->wraps, 0);
+    ring->pending = 0;
+}
+
+/**
+ * @brief Append samples (producer side).
+ * @details Losses not yet recorded go in first, as OVERFLOW gap records.
+ *          Samples that do not fit are dropped, counted as overruns and
+ *          recorded the same way at the next push with room; a dropped gap
+ *          record adds its own count. The oldest data is never
+ *          overwritten, so the consumer's view stays consistent.
+ * @param ring Ring.
+ * @param samples Samples to append.
+ * @param count Number of samples.
+ * @return Number of samples stored.
+ */
+uint32_t MAX30003_Ring_Push(MAX30003_RingTypeDef *ring, const MAX30003_SampleTypeDef *samples, uint32_t count) {
+    uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t space = MAX30003_RING_SIZE - (head - tail);
+    uint32_t n = 0, overruns = 0, wraps = 0;
+
+    while (ring->pending != 0U && space != 0U) {
+        MAX30003_SampleTypeDef gap;
+        uint32_t chunk = ring->pending < MAX30003_RING_GAP_LIMIT ? ring->pending : MAX30003_RING_GAP_LIMIT;
+
+        gap.ecg = (int32_t)chunk;
+        gap.etag = MAX30003_FIFO_ETAG_OVERFLOW;
+        MAX30003_Ring_Store(ring, head & MAX30003_RING_MASK, &gap);
+        wraps += (++head & MAX30003_RING_MASK) == 0U;
+        ring->pending -= chunk;
+        space--;
+    }
+
+    if (ring->pending == 0U) {
+        n = count < space ? count : space;
+        for (uint32_t i = 0; i < n; ++i) {
+            MAX30003_Ring_Store(ring, head & MAX30003_RING_MASK, &samples[i]);
+            wraps += (++head & MAX30003_RING_MASK) == 0U;
+        }
+    }
+
+    for (uint32_t i = n; i < count; ++i) {
+        if (samples[i].etag == MAX30003_FIFO_ETAG_OVERFLOW) {
+            ring->pending += (uint32_t)samples[i].ecg;
+        } else {
+            ring->pending++;
+            overruns++;
+        }
+    }
+
+    /* Publish the slots before the new head becomes visible */
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+
+    if (wraps)
+        atomic_store_explicit(&ring->wraps,
+            atomic_load_explicit(&ring->wraps, memory_order_relaxed) + wraps, memory_order_relaxed);
+    if (overruns)
+        atomic_store_explicit(&ring->overruns,
+            atomic_load_explicit(&ring->overruns, memory_order_relaxed) + overruns, memory_order_relaxed);
+
+    return n;
+}
+
+/**
+ * @brief Decode raw FIFO words and append them (producer side).
+ * @details Only words that pass MAX30003_ETAG_IS_SAMPLE() are stored, with
+ *          their ETAG, the same words that advance the handle's sample_index.
+ *          EMPTY, OVERFLOW and reserved words are skipped (an overflow is
+ *          reported by MAX30003_Ring_PushGap() instead).
+ * @param ring Ring.
+ * @param fifo_data Words as returned by MAX30003_ReadFIFO().
+ * @param count Number of words.
+ * @return Number of samples stored.
+ */
+uint32_t MAX30003_Ring_PushFIFO(MAX30003_RingTypeDef *ring, const uint32_t *fifo_data, uint32_t count) {
+    MAX30003_SampleTypeDef samples[MAX30003_FIFO_LENGTH];
+    int32_t ecg[MAX30003_FIFO_LENGTH];
+    uint8_t etag[MAX30003_FIFO_LENGTH];
+    uint32_t stored = 0;
+
+    while (count > 0) {
+        uint32_t chunk = count < MAX30003_FIFO_LENGTH ? count : MAX30003_FIFO_LENGTH;
+        uint32_t n = 0;
+
+        MAX30003_DecodeFIFO(fifo_data, ecg, etag, chunk);
+        for (uint32_t i = 0; i < chunk; ++i) {
+            if (!MAX30003_ETAG_IS_SAMPLE(etag[i]))
+                continue;
+            samples[n].ecg = ecg[i];
+            samples[n].etag = etag[i];
+            n++;
+        }
+
+        stored += MAX30003_Ring_Push(ring, samples, n);
+        fifo_data += chunk;
+        count -= chunk;
+    }
+
+    return stored;
+}
+
+/**
+ * @brief Append a gap record (producer side).
+ * @details Stored as a sample with ETAG MAX30003_FIFO_ETAG_OVERFLOW whose
+ *          ecg field holds the number of samples lost, so a consumer that
+ *          counts samples can advance its index by that amount. If the ring
+ *          is full the count is kept and merged into the record written
+ *          ahead of the next push with room.
+ * @param ring Ring.
+ * @param dropped Samples lost, e.g. from MAX30003_RecoverOverflow().
+ * @return 1 if recorded now, 0 if deferred to a later push.
+ */
+uint32_t MAX30003_Ring_PushGap(MAX30003_RingTypeDef *ring, uint32_t dropped) {
+    ring->pending += dropped;
+    MAX30003_Ring_Push(ring, NULL, 0);
+    return ring->pending == 0U;
+}
+
+/**
+ * @brief Remove samples in arrival order (consumer side).
+ * @param ring Ring.
+ * @param samples Output buffer.
+ * @param max Capacity of the output buffer.
+ * @return Number of samples copied.
+ */
+uint32_t MAX30003_Ring_Pop(MAX30003_RingTypeDef *ring, MAX30003_SampleTypeDef *samples, uint32_t max) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t avail = head - tail;
+    uint32_t n = max < avail ? max : avail;
+
+    for (uint32_t i = 0; i < n; ++i, ++tail)
+        MAX30003_Ring_Load(ring, tail & MAX30003_RING_MASK, &samples[i]);
+
+    /* Hand the slots back only after they have been copied out */
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+
+    return n;
+}
+
+/**
+ * @brief Number of samples waiting; exact on the consumer side, a lower
+ *        bound of free space on the producer side.
+ */
+uint32_t MAX30003_Ring_Count(MAX30003_RingTypeDef *ring) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t head = (uint32_t)atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+/**
+ * @brief Samples dropped because the ring was full.
+ */
+uint32_t MAX30003_Ring_Overruns(MAX30003_RingTypeDef *ring) {
+    return (uint32_t)atomic_load_explicit(&ring->overruns, memory_order_relaxed);
+}
+
+/**
+ * @brief Times the write index has wrapped back to slot 0.
+ */
+uint32_t MAX30003_Ring_Wraps(MAX30003_RingTypeDef *ring) {
+    return (uint32_t)atomic_load_explicit(&ring->wraps, memory_order_relaxed);
+}
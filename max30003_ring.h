@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * @file    max30003_ring.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 lock-free sample ring - Header file
+ *
+ * @note    Single producer (FIFO interrupt) / single consumer (main loop or task).
+ *          Capacity is fixed at compile time by MAX30003_RING_SIZE.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_RING_H_
+#define INC_MAX30003_RING_H_
+
+#include "max30003_atomic.h"
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Ring Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_RING_SIZE
+#define MAX30003_RING_SIZE  256U    /**< Samples held, must be a power of two */
+#endif
+
+#if (MAX30003_RING_SIZE < 2U) || ((MAX30003_RING_SIZE & (MAX30003_RING_SIZE - 1U)) != 0U)
+#error "MAX30003_RING_SIZE must be a power of two >= 2"
+#endif
+
+#define MAX30003_RING_MASK  (MAX30003_RING_SIZE - 1U)
+
+/*
+ * Define MAX30003_RING_PACKED to keep slots in the 3-byte PACK24 layout
+ * (see max30003_pack.h) instead of MAX30003_SampleTypeDef: 3 bytes per
+ * sample instead of 8. Gap records then saturate at MAX30003_RING_GAP_MAX.
+ */
+#define MAX30003_RING_GAP_MAX   0x1FFFFFU   /**< Largest gap a packed slot can record (21 bits) */
+
+/* ---------------------------------------------------------------------------
+ * Ring Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Decoded FIFO sample
+ */
+typedef struct {
+    int32_t ecg;                /**< Sign-extended 18-bit ECG code, or samples lost for an OVERFLOW gap record */
+    uint8_t etag;               /**< MAX30003_FIFO_ETAG_x */
+} MAX30003_SampleTypeDef;
+
+/**
+ * @brief SPSC sample ring
+ *
+ * head and the counters are written only by the producer, tail only by the
+ * consumer. Indices run freely and are masked on access, so head - tail is
+ * the fill level. Only plain atomic loads and stores are used (no
+ * read-modify-write), which keeps it lock-free on Cortex-M0/M0+ as well.
+ * Samples that find the ring full are added to pending and written as an
+ * OVERFLOW gap record ahead of the next push that has room, so a consumer
+ * counting samples stays aligned with the device.
+ */
+typedef struct {
+    atomic_uint_fast32_t head;                      /**< Next slot to write (producer) */
+    atomic_uint_fast32_t tail;                      /**< Next slot to read (consumer) */
+    atomic_uint_fast32_t overruns;                  /**< Samples dropped because the ring was full */
+    atomic_uint_fast32_t wraps;                     /**< Times the write index wrapped to slot 0 */
+    uint32_t pending;                               /**< Samples lost but not yet recorded (producer only) */
+#ifdef MAX30003_RING_PACKED
+    uint8_t buf[MAX30003_RING_SIZE][3];             /**< PACK24 slots */
+#else
+    MAX30003_SampleTypeDef buf[MAX30003_RING_SIZE];
+#endif
+} MAX30003_RingTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_Ring_Init(MAX30003_RingTypeDef *ring);
+
+uint32_t MAX30003_Ring_Push(MAX30003_RingTypeDef *ring, const MAX30003_SampleTypeDef *samples, uint32_t count);
+
+uint32_t MAX30003_Ring_PushFIFO(MAX30003_RingTypeDef *ring, const uint32_t *fifo_data, uint32_t count);
+
+uint32_t MAX30003_Ring_PushGap(MAX30003_RingTypeDef *ring, uint32_t dropped);
+
+uint32_t MAX30003_Ring_Pop(MAX30003_RingTypeDef *ring, MAX30003_SampleTypeDef *samples, uint32_t max);
+
+uint32_t MAX30003_Ring_Count(MAX30003_RingTypeDef *ring);
+
+uint32_t MAX30003_Ring_Overruns(MAX30003_RingTypeDef *ring);
+
+uint32_t MAX30003_Ring_Wraps(MAX30003_RingTypeDef *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_RING_H_ */
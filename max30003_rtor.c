@@ -0,0 +1,142 @@
+/**
+ ******************************************************************************
+ * @file    max30003_rtor.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 R-to-R interval event queue - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_rtor.h"
+
+/**
+ * @brief Reset a queue to empty and forget the beat clock.
+ * @param q Queue to initialize; neither side may be using it.
+ */
+void MAX30003_RR_Init(MAX30003_RRQueueTypeDef *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->overruns, 0);
+    q->beat_ticks = 0;
+    q->beats = 0;
+    q->resyncs = 0;
+}
+
+/**
+ * @brief Read RTOR after RRINT, place the beat and queue it (producer side).
+ * @details Call from the interrupt handler after the FIFO has been drained,
+ *          so hmax->sample_index is as close to the device as it gets. The
+ *          beat is chained one RR interval after the previous one; if that
+ *          lands more than half an interval before hmax->sample_index, or
+ *          beyond what the FIFO can hold, the chain is re-anchored to
+ *          MAX30003_EstimateSampleIndex() clamped into that window.
+ * @param q Queue.
+ * @param hmax Device handle.
+ * @param ts Timestamp engine used to fill t_us (may be NULL).
+ * @return HAL status; HAL_OK also when the beat was dropped on a full queue.
+ */
+HAL_StatusTypeDef MAX30003_RR_HandleInterrupt(MAX30003_RRQueueTypeDef *q,
+                                              MAX30003_HandleTypeDef *hmax,
+                                              const MAX30003_TS_TypeDef *ts) {
+    MAX30003_RREventTypeDef ev;
+    HAL_StatusTypeDef status;
+    uint32_t ticks, head, tail;
+    uint64_t rr_ticks, lo, hi, index;
+
+    if ((status = MAX30003_ReadRTOR(hmax, &ev.rtor, &ev.rr_ms)) != HAL_OK ||
+        (status = MAX30003_GetTimebase(hmax, NULL, &ticks)) != HAL_OK)
+        return status;
+
+    rr_ticks = (uint64_t)ev.rtor * MAX30003_RTOR_TICKS;
+    lo = hmax->sample_index * ticks;
+    lo = lo > rr_ticks / 2 ? lo - rr_ticks / 2 : 0;
+    hi = (hmax->sample_index + MAX30003_FIFO_LENGTH) * ticks;
+
+    q->beat_ticks += rr_ticks;
+    ev.resync = q->beats == 0 || q->beat_ticks < lo || q->beat_ticks > hi;
+    if (ev.resync) {
+        if (MAX30003_EstimateSampleIndex(hmax, &index) != HAL_OK)
+            index = hmax->sample_index;
+        if (index < hmax->sample_index)
+            index = hmax->sample_index;
+        if (index > hmax->sample_index + MAX30003_FIFO_LENGTH)
+            index = hmax->sample_index + MAX30003_FIFO_LENGTH;
+        q->beat_ticks = index * ticks;
+        if (q->beats != 0)
+            q->resyncs++;
+    }
+    q->beats++;
+
+    ev.sample_index = q->beat_ticks / ticks;
+    ev.t_us = ts != NULL ? MAX30003_TS_Timestamp(ts, ev.sample_index) : 0;
+
+    head = (uint32_t)atomic_load_explicit(&q->head, memory_order_relaxed);
+    tail = (uint32_t)atomic_load_explicit(&q->tail, memory_order_acquire);
+    if (head - tail == MAX30003_RR_QUEUE_SIZE) {
+        atomic_store_explicit(&q->overruns,
+            atomic_load_explicit(&q->overruns, memory_order_relaxed) + 1, memory_order_relaxed);
+        return HAL_OK;
+    }
+
+    q->buf[head & MAX30003_RR_QUEUE_MASK] = ev;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return HAL_OK;
+}
+
+/**
+ * @brief Remove beats in arrival order (consumer side).
+ * @param q Queue.
+ * @param events Output buffer.
+ * @param max Capacity of the output buffer.
+ * @return Number of beats copied.
+ */
+uint32_t MAX30003_RR_Pop(MAX30003_RRQueueTypeDef *q, MAX30003_RREventTypeDef *events, uint32_t max) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = (uint32_t)atomic_load_explicit(&q->head, memory_order_acquire);
+    uint32_t avail = head - tail;
+    uint32_t n = max < avail ? max : avail;
+
+    for (uint32_t i = 0; i < n; ++i, ++tail)
+        events[i] = q->buf[tail & MAX30003_RR_QUEUE_MASK];
+
+    atomic_store_explicit(&q->tail, tail, memory_order_release);
+    return n;
+}
+
+/**
+ * @brief Number of beats waiting.
+ */
+uint32_t MAX30003_RR_Count(MAX30003_RRQueueTypeDef *q) {
+    uint32_t tail = (uint32_t)atomic_load_explicit(&q->tail, memory_order_acquire);
+    uint32_t head = (uint32_t)atomic_load_explicit(&q->head, memory_order_acquire);
+
+    return head - tail;
+}
+
+/**
+ * @brief Beats dropped because the queue was full.
+ */
+uint32_t MAX30003_RR_Overruns(MAX30003_RRQueueTypeDef *q) {
+    return (uint32_t)atomic_load_explicit(&q->overruns, memory_order_relaxed);
+}
@@ -0,0 +1,111 @@
+/**
+ ******************************************************************************
+ * @file    max30003_rtor.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 R-to-R interval event queue - Header file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_RTOR_H_
+#define INC_MAX30003_RTOR_H_
+
+#include "max30003_atomic.h"
+#include "max30003.h"
+#include "max30003_timestamp.h"
+
+/* ---------------------------------------------------------------------------
+ * Queue Configuration
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_RR_QUEUE_SIZE
+#define MAX30003_RR_QUEUE_SIZE  16U     /**< Beats held, must be a power of two */
+#endif
+
+#if (MAX30003_RR_QUEUE_SIZE < 2U) || ((MAX30003_RR_QUEUE_SIZE & (MAX30003_RR_QUEUE_SIZE - 1U)) != 0U)
+#error "MAX30003_RR_QUEUE_SIZE must be a power of two >= 2"
+#endif
+
+#define MAX30003_RR_QUEUE_MASK  (MAX30003_RR_QUEUE_SIZE - 1U)
+
+/* ---------------------------------------------------------------------------
+ * RR Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief One R event reported by the RTOR detector
+ */
+typedef struct {
+    uint64_t sample_index;      /**< ECG sample index at which the R event was detected */
+    uint64_t t_us;              /**< MCU time of sample_index, 0 without a timestamp engine */
+    uint32_t rr_ms;             /**< Interval from the previous R event, ms */
+    uint16_t rtor;              /**< Raw RTOR count, MAX30003_RTOR_TICKS FMSTR cycles each */
+    uint8_t resync;             /**< Non-zero if sample_index was re-anchored at this beat */
+} MAX30003_RREventTypeDef;
+
+/**
+ * @brief SPSC R event queue with the producer-side beat clock
+ *
+ * Beat positions are chained in FMSTR cycles from one RTOR value to the
+ * next, so consecutive events are exactly rr apart in device time. The
+ * chain is anchored from MAX30003_EstimateSampleIndex() on the first beat
+ * and re-anchored whenever it leaves the window the device can actually
+ * be in (a missed RRINT, a FIFO overflow or a SYNCH).
+ */
+typedef struct {
+    atomic_uint_fast32_t head;                      /**< Next slot to write (producer) */
+    atomic_uint_fast32_t tail;                      /**< Next slot to read (consumer) */
+    atomic_uint_fast32_t overruns;                  /**< Beats dropped because the queue was full */
+    MAX30003_RREventTypeDef buf[MAX30003_RR_QUEUE_SIZE];
+
+    uint64_t beat_ticks;        /**< FMSTR cycles from sample index 0 to the last beat (producer) */
+    uint32_t beats;             /**< Beats handled (producer) */
+    uint32_t resyncs;           /**< Times the beat clock was re-anchored (producer) */
+} MAX30003_RRQueueTypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_RR_Init(MAX30003_RRQueueTypeDef *q);
+
+HAL_StatusTypeDef MAX30003_RR_HandleInterrupt(MAX30003_RRQueueTypeDef *q,
+                                              MAX30003_HandleTypeDef *hmax,
+                                              const MAX30003_TS_TypeDef *ts);
+
+uint32_t MAX30003_RR_Pop(MAX30003_RRQueueTypeDef *q, MAX30003_RREventTypeDef *events, uint32_t max);
+
+uint32_t MAX30003_RR_Count(MAX30003_RRQueueTypeDef *q);
+
+uint32_t MAX30003_RR_Overruns(MAX30003_RRQueueTypeDef *q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_RTOR_H_ */
@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * @file    max30003_timestamp.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 per-sample timestamp reconstruction - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_timestamp.h"
+
+/**
+ * @brief Time of a sample index from the reference point, as us + Q32 fraction.
+ */
+static void MAX30003_TS_Predict(const MAX30003_TS_TypeDef *ts, uint64_t index,
+                                uint64_t *us, uint32_t *frac) {
+    if (index >= ts->ref_index) {
+        uint64_t acc = (uint64_t)ts->ref_frac + (index - ts->ref_index) * ts->period_q32;
+        *us = ts->ref_us + (acc >> 32);
+        *frac = (uint32_t)acc;
+    } else {
+        /* Step back: borrow whole microseconds so the fraction stays positive */
+        uint64_t back = (ts->ref_index - index) * ts->period_q32;
+        uint64_t whole = (back >> 32) + (((uint32_t)back > ts->ref_frac) ? 1U : 0U);
+        *us = ts->ref_us - whole;
+        *frac = ts->ref_frac - (uint32_t)back;
+    }
+}
+
+/**
+ * @brief Restart the estimator at a given sample rate.
+ * @details Call after SYNCH or a rate change; the drift estimate is lost.
+ * @param ts Timestamp engine.
+ * @param rate_mHz Nominal sample rate in mHz (non-zero).
+ */
+void MAX30003_TS_Reset(MAX30003_TS_TypeDef *ts, uint32_t rate_mHz) {
+    ts->rate_mHz = rate_mHz;
+    ts->latency_us = 0;
+    ts->nominal_q32 = rate_mHz ? (1000000000ULL << 32) / rate_mHz : 0;
+    ts->period_q32 = ts->nominal_q32;
+    ts->ref_index = 0;
+    ts->ref_us = 0;
+    ts->ref_frac = 0;
+    ts->base_index = 0;
+    ts->base_us = 0;
+    ts->base_frac = 0;
+    ts->anchors = 0;
+    ts->started = 0;
+}
+
+/**
+ * @brief Initialize from the rate configured in the FMSTR/RATE shadows.
+ * @param ts Timestamp engine.
+ * @param hmax Device handle.
+ * @return HAL status of MAX30003_GetSampleRate_mHz().
+ */
+HAL_StatusTypeDef MAX30003_TS_Init(MAX30003_TS_TypeDef *ts, MAX30003_HandleTypeDef *hmax) {
+    uint32_t rate_mHz;
+    HAL_StatusTypeDef status = MAX30003_GetSampleRate_mHz(hmax, &rate_mHz);
+
+    if (status != HAL_OK)
+        return status;
+    MAX30003_TS_Reset(ts, rate_mHz);
+    return HAL_OK;
+}
+
+/**
+ * @brief Add an observation: sample index was produced at irq_us.
+ * @details For an EINT interrupt, index is the first sample of the drained
+ *          block plus EFIT - 1, i.e. the sample that crossed the threshold,
+ *          and irq_us is the MCU time captured at interrupt entry.
+ * @param ts Timestamp engine.
+ * @param index Sample index (as in MAX30003_HandleTypeDef::sample_index).
+ * @param irq_us Observation time, MCU microseconds.
+ */
+void MAX30003_TS_Anchor(MAX30003_TS_TypeDef *ts, uint64_t index, uint64_t irq_us) {
+    uint64_t pred_us, t_us = irq_us - ts->latency_us;
+    uint32_t pred_frac;
+    int64_t err_q32, step;
+
+    if (!ts->started) {
+        ts->ref_index = ts->base_index = index;
+        ts->ref_us = ts->base_us = t_us;
+        ts->ref_frac = ts->base_frac = 0;
+        ts->started = 1;
+        ts->anchors = 1;
+        return;
+    }
+    if (index <= ts->ref_index)
+        return;
+
+    MAX30003_TS_Predict(ts, index, &pred_us, &pred_frac);
+    err_q32 = (int64_t)((t_us - pred_us) << 32) - (int64_t)pred_frac;
+
+    /* Move the reference to this index, part way towards the observation */
+    step = err_q32 / (1 << MAX30003_TS_PHASE_SHIFT);
+    {
+        int64_t frac = (int64_t)pred_frac + step;
+        int64_t carry = frac >> 32;     /* floor division by 2^32 */
+
+        ts->ref_us = pred_us + (uint64_t)carry;
+        ts->ref_frac = (uint32_t)frac;
+    }
+    ts->ref_index = index;
+    ts->anchors++;
+
+    /* Period from the slope of the smoothed reference over one window */
+    if (index - ts->base_index >= MAX30003_TS_WINDOW) {
+        uint64_t span = index - ts->base_index;
+        uint64_t elapsed_q32 = ((ts->ref_us - ts->base_us) << 32) + ts->ref_frac - ts->base_frac;
+        uint64_t measured = elapsed_q32 / span;
+        int64_t delta = (int64_t)(measured - ts->period_q32);
+
+        ts->period_q32 += (uint64_t)(delta / (1 << MAX30003_TS_FREQ_SHIFT));
+        ts->base_index = index;
+        ts->base_us = ts->ref_us;
+        ts->base_frac = ts->ref_frac;
+    }
+}
+
+/**
+ * @brief Timestamp of one sample.
+ * @param ts Timestamp engine (at least one anchor applied).
+ * @param index Sample index.
+ * @return MCU time in microseconds, rounded to nearest.
+ */
+uint64_t MAX30003_TS_Timestamp(const MAX30003_TS_TypeDef *ts, uint64_t index) {
+    uint64_t us;
+    uint32_t frac;
+
+    MAX30003_TS_Predict(ts, index, &us, &frac);
+    return us + (frac >> 31);
+}
+
+/**
+ * @brief Timestamp a block of consecutive samples.
+ * @details One prediction, then a Q32 add per sample.
+ * @param ts Timestamp engine (at least one anchor applied).
+ * @param first_index Sample index of t_us[0].
+ * @param t_us Output, MCU microseconds per sample.
+ * @param count Number of samples.
+ */
+void MAX30003_TS_Stamp(const MAX30003_TS_TypeDef *ts, uint64_t first_index,
+                       uint64_t *t_us, uint32_t count) {
+    uint64_t us;
+    uint32_t frac;
+    uint64_t acc;
+
+    MAX30003_TS_Predict(ts, first_index, &us, &frac);
+    acc = frac;
+    for (uint32_t i = 0; i < count; ++i) {
+        t_us[i] = us + (acc >> 32) + ((uint32_t)acc >> 31);
+        acc += ts->period_q32;
+    }
+}
+
+/**
+ * @brief Estimated MAX30003 clock error against the MCU clock.
+ * @return Parts per billion; positive when the device runs fast.
+ */
+int32_t MAX30003_TS_Drift_ppb(const MAX30003_TS_TypeDef *ts) {
+    int64_t diff = (int64_t)(ts->nominal_q32 - ts->period_q32);
+    int64_t scale = (int64_t)(ts->period_q32 / 1000U);
+
+    return scale ? (int32_t)(diff * 1000000 / scale) : 0;
+}
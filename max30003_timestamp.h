@@ -0,0 +1,100 @@
+/**
+ ******************************************************************************
+ * @file    max30003_timestamp.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 per-sample timestamp reconstruction - Header file
+ *
+ * @note    Maps the device sample index onto the MCU microsecond time base and tracks
+ *          the drift of the MAX30003 32 kHz clock against the MCU clock.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_TIMESTAMP_H_
+#define INC_MAX30003_TIMESTAMP_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Estimator Configuration
+ * ------------------------------------------------------------------------- */
+
+#define MAX30003_TS_PHASE_SHIFT     3U      /**< Phase loop gain 1/2^n per anchor */
+#define MAX30003_TS_FREQ_SHIFT      2U      /**< Period update weight 1/2^n per window */
+#define MAX30003_TS_WINDOW          4096U   /**< Samples between period measurements */
+
+/* ---------------------------------------------------------------------------
+ * Timestamp Types
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @brief Timestamp engine state
+ *
+ * Times are MCU microseconds; fractional parts use 32 fraction bits (Q32).
+ * A proportional loop pulls the predicted time of each anchored sample
+ * towards the observed interrupt time, which averages out interrupt jitter.
+ * Every MAX30003_TS_WINDOW samples the slope of that smoothed reference
+ * gives a measured sample period, which is blended into the estimate.
+ */
+typedef struct {
+    uint32_t rate_mHz;          /**< Nominal sample rate */
+    uint32_t latency_us;        /**< Known interrupt latency subtracted from anchors */
+    uint64_t nominal_q32;       /**< Nominal sample period, us Q32 */
+    uint64_t period_q32;        /**< Estimated sample period in MCU time, us Q32 */
+    uint64_t ref_index;         /**< Sample index of the reference point */
+    uint64_t ref_us;            /**< Time of the reference point, integer us */
+    uint32_t ref_frac;          /**< Time of the reference point, fraction */
+    uint64_t base_index;        /**< Start of the current period window */
+    uint64_t base_us;
+    uint32_t base_frac;
+    uint32_t anchors;           /**< Anchors applied */
+    uint8_t started;            /**< Non-zero once the first anchor is in */
+} MAX30003_TS_TypeDef;
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HAL_StatusTypeDef MAX30003_TS_Init(MAX30003_TS_TypeDef *ts, MAX30003_HandleTypeDef *hmax);
+
+void MAX30003_TS_Reset(MAX30003_TS_TypeDef *ts, uint32_t rate_mHz);
+
+void MAX30003_TS_Anchor(MAX30003_TS_TypeDef *ts, uint64_t index, uint64_t irq_us);
+
+uint64_t MAX30003_TS_Timestamp(const MAX30003_TS_TypeDef *ts, uint64_t index);
+
+void MAX30003_TS_Stamp(const MAX30003_TS_TypeDef *ts, uint64_t first_index,
+                       uint64_t *t_us, uint32_t count);
+
+int32_t MAX30003_TS_Drift_ppb(const MAX30003_TS_TypeDef *ts);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_TIMESTAMP_H_ */
@@ -0,0 +1,122 @@
+/**
+ ******************************************************************************
+ * @file    max30003_transport_hal.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 driver STM32 HAL transport - Source file
+ *
+ * @note    Blocking transfers on HAL_SPI_TransmitReceive, asynchronous
+ *          transfers on HAL_SPI_TransmitReceive_DMA, CS on HAL_GPIO_WritePin.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003.h"
+
+#ifdef HAL_SPI_MODULE_ENABLED
+
+static HAL_StatusTypeDef MAX30003_HAL_Transfer(MAX30003_HandleTypeDef *hmax,
+                                               const uint8_t *tx, uint8_t *rx, uint16_t size) {
+    if (rx == NULL)
+        return HAL_SPI_Transmit(hmax->hspi, (uint8_t *)tx, size, MAX30003_SPI_TIMEOUT);
+    return HAL_SPI_TransmitReceive(hmax->hspi, (uint8_t *)tx, rx, size, MAX30003_SPI_TIMEOUT);
+}
+
+#if MAX30003_ENABLE_DMA
+static HAL_StatusTypeDef MAX30003_HAL_TransferAsync(MAX30003_HandleTypeDef *hmax,
+                                                    const uint8_t *tx, uint8_t *rx, uint16_t size) {
+    return HAL_SPI_TransmitReceive_DMA(hmax->hspi, (uint8_t *)tx, rx, size);
+}
+#else
+#define MAX30003_HAL_TransferAsync NULL
+#endif
+
+static void MAX30003_HAL_CSAssert(MAX30003_HandleTypeDef *hmax) {
+    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_RESET);
+}
+
+static void MAX30003_HAL_CSRelease(MAX30003_HandleTypeDef *hmax) {
+    HAL_GPIO_WritePin(hmax->cs_port, hmax->cs_pin, GPIO_PIN_SET);
+}
+
+/**
+ * @brief STM32 HAL transport operations
+ */
+const MAX30003_TransportTypeDef MAX30003_HAL_Transport = {
+    .transfer = MAX30003_HAL_Transfer,
+    .transfer_async = MAX30003_HAL_TransferAsync,
+    .cs_assert = MAX30003_HAL_CSAssert,
+    .cs_release = MAX30003_HAL_CSRelease,
+};
+
+/**
+ * @brief Initialize MAX30003 communication handle.
+ * @param hmax Pointer to device handle.
+ * @param hspi SPI handle.
+ * @param cs_port GPIO port for CS pin.
+ * @param cs_pin GPIO pin for CS.
+ * @return HAL_OK if successful, HAL_ERROR otherwise.
+ */
+HAL_StatusTypeDef MAX30003_Init(MAX30003_HandleTypeDef *hmax,
+                                SPI_HandleTypeDef *hspi,
+                                GPIO_TypeDef *cs_port,
+                                uint16_t cs_pin) {
+    if (hspi == NULL)
+        return HAL_ERROR;
+
+    hmax->hspi = hspi;
+    hmax->cs_port = cs_port;
+    hmax->cs_pin = cs_pin;
+
+    return MAX30003_InitTransport(hmax, &MAX30003_HAL_Transport, NULL);
+}
+
+#if MAX30003_ENABLE_DMA
+/**
+ * @brief Finish an asynchronous FIFO read.
+ * @details Call from HAL_SPI_TxRxCpltCallback. Ignored if hspi does not belong
+ *          to hmax.
+ * @param hmax Device handle.
+ * @param hspi SPI handle that completed the transfer.
+ */
+void MAX30003_SPI_TxRxCpltCallback(MAX30003_HandleTypeDef *hmax,
+                                   SPI_HandleTypeDef *hspi) {
+    if (hmax->transport == &MAX30003_HAL_Transport && hspi == hmax->hspi)
+        MAX30003_TransferCpltCallback(hmax, HAL_OK);
+}
+
+/**
+ * @brief Abort an asynchronous FIFO read after an SPI error.
+ * @details Call from HAL_SPI_ErrorCallback. The completion callback is invoked
+ *          with HAL_ERROR and no data.
+ * @param hmax Device handle.
+ * @param hspi SPI handle that reported the error.
+ */
+void MAX30003_SPI_ErrorCallback(MAX30003_HandleTypeDef *hmax,
+                                SPI_HandleTypeDef *hspi) {
+    if (hmax->transport == &MAX30003_HAL_Transport && hspi == hmax->hspi)
+        MAX30003_TransferCpltCallback(hmax, HAL_ERROR);
+}
+#endif /* MAX30003_ENABLE_DMA */
+
+#endif /* HAL_SPI_MODULE_ENABLED */
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * @file    max30003_transport_ll.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 driver STM32 direct-register transport - Source file
+ *
+ * @note    Polled SPI transfers through SPI SR/DR and CS through GPIO BSRR.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include <stddef.h>
+#include "max30003_transport_ll.h"
+
+#ifdef MAX30003_USE_LL_TRANSPORT
+
+/*
+ * 8-bit access to DR, so each write sends one frame and each read takes one.
+ * On SPIs with a FIFO, RXNE also needs FRXTH set (done in MAX30003_InitLL),
+ * otherwise it waits for 16 bits.
+ */
+#define MAX30003_LL_DR8(spi)    (*(__IO uint8_t *)&(spi)->DR)
+
+static HAL_StatusTypeDef MAX30003_LL_Transfer(MAX30003_HandleTypeDef *hmax,
+                                              const uint8_t *tx, uint8_t *rx, uint16_t size) {
+    MAX30003_LL_BusTypeDef *bus = (MAX30003_LL_BusTypeDef *)hmax->transport_ctx;
+    SPI_TypeDef *spi = bus->spi;
+    uint32_t loops;
+
+    /* Drop anything left in the receive path by a previous aborted transfer */
+    while (spi->SR & SPI_SR_RXNE)
+        (void)MAX30003_LL_DR8(spi);
+
+    for (uint16_t i = 0; i < size; ++i) {
+        uint8_t data;
+
+        loops = MAX30003_LL_TIMEOUT_LOOPS;
+        while (!(spi->SR & SPI_SR_TXE))
+            if (--loops == 0)
+                return HAL_TIMEOUT;
+        MAX30003_LL_DR8(spi) = tx[i];
+
+        loops = MAX30003_LL_TIMEOUT_LOOPS;
+        while (!(spi->SR & SPI_SR_RXNE))
+            if (--loops == 0)
+                return HAL_TIMEOUT;
+        data = MAX30003_LL_DR8(spi);
+
+        if (rx != NULL)
+            rx[i] = data;
+    }
+
+    /* CS may only rise once the last SCLK edge is out */
+    loops = MAX30003_LL_TIMEOUT_LOOPS;
+    while (spi->SR & SPI_SR_BSY)
+        if (--loops == 0)
+            return HAL_TIMEOUT;
+
+    return HAL_OK;
+}
+
+static void MAX30003_LL_CSAssert(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_LL_BusTypeDef *bus = (MAX30003_LL_BusTypeDef *)hmax->transport_ctx;
+    bus->cs_port->BSRR = bus->cs_pin << 16U;
+}
+
+static void MAX30003_LL_CSRelease(MAX30003_HandleTypeDef *hmax) {
+    MAX30003_LL_BusTypeDef *bus = (MAX30003_LL_BusTypeDef *)hmax->transport_ctx;
+    bus->cs_port->BSRR = bus->cs_pin;
+}
+
+/**
+ * @brief STM32 direct-register transport operations (no asynchronous transfer)
+ */
+const MAX30003_TransportTypeDef MAX30003_LL_Transport = {
+    .transfer = MAX30003_LL_Transfer,
+    .transfer_async = NULL,
+    .cs_assert = MAX30003_LL_CSAssert,
+    .cs_release = MAX30003_LL_CSRelease,
+};
+
+/**
+ * @brief Initialize MAX30003 handle on the STM32 direct-register transport.
+ * @param hmax Pointer to device handle.
+ * @param bus LL bus description, must outlive the handle.
+ * @return HAL_OK if successful, HAL_ERROR otherwise.
+ */
+HAL_StatusTypeDef MAX30003_InitLL(MAX30003_HandleTypeDef *hmax,
+                                  MAX30003_LL_BusTypeDef *bus) {
+    if (bus == NULL || bus->spi == NULL || bus->cs_port == NULL)
+        return HAL_ERROR;
+
+#ifdef SPI_CR2_FRXTH
+    /* RXNE at 8 bits; the reset value waits for a 16-bit half of the FIFO */
+    LL_SPI_SetRxFIFOThreshold(bus->spi, LL_SPI_RX_FIFO_TH_QUARTER);
+#endif
+    if (!LL_SPI_IsEnabled(bus->spi))
+        LL_SPI_Enable(bus->spi);
+
+    return MAX30003_InitTransport(hmax, &MAX30003_LL_Transport, bus);
+}
+
+#endif /* MAX30003_USE_LL_TRANSPORT */
@@ -0,0 +1,78 @@
+/**
+ ******************************************************************************
+ * @file    max30003_transport_ll.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 driver STM32 direct-register transport - Header file
+ *
+ * @note    Opt-in (define MAX30003_USE_LL_TRANSPORT); needs the CMSIS device
+ *          header and the LL SPI driver to be reachable through main.h.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_TRANSPORT_LL_H_
+#define INC_MAX30003_TRANSPORT_LL_H_
+
+#include "max30003.h"
+
+#ifdef MAX30003_USE_LL_TRANSPORT
+
+/* The family LL SPI header (stm32xxxx_ll_spi.h) must come in through main.h */
+#ifndef LL_SPI_MODE_MASTER
+#error "MAX30003_USE_LL_TRANSPORT needs stm32xxxx_ll_spi.h included from main.h (enable the LL SPI driver)"
+#endif
+
+#define MAX30003_LL_TIMEOUT_LOOPS   100000U /**< Flag polling iterations before HAL_TIMEOUT */
+
+/**
+ * @brief STM32 direct-register transport context
+ *
+ * CS is driven with single BSRR stores and bytes go straight through SPI DR,
+ * bypassing HAL_GPIO_WritePin() and the HAL SPI state machine. The SPI is
+ * enabled by MAX30003_InitLL() and must not be shared with HAL SPI calls.
+ * On SPIs with a FIFO, MAX30003_InitLL() also sets the RX threshold to
+ * 8 bits (FRXTH) so RXNE fires per byte.
+ */
+typedef struct {
+    SPI_TypeDef *spi;            /**< SPI peripheral, configured for 8-bit frames, mode 0 */
+    GPIO_TypeDef *cs_port;       /**< Chip Select GPIO port */
+    uint32_t cs_pin;             /**< Chip Select pin mask (LL_GPIO_PIN_x / GPIO_PIN_x) */
+} MAX30003_LL_BusTypeDef;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const MAX30003_TransportTypeDef MAX30003_LL_Transport;
+
+HAL_StatusTypeDef MAX30003_InitLL(MAX30003_HandleTypeDef *hmax,
+                                  MAX30003_LL_BusTypeDef *bus);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAX30003_USE_LL_TRANSPORT */
+
+#endif /* INC_MAX30003_TRANSPORT_LL_H_ */
@@ -0,0 +1,76 @@
+/**
+ ******************************************************************************
+ * @file    max30003_units.c
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 ECG code to microvolt conversion - Source file
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#include "max30003_units.h"
+
+/**
+ * @brief Convert a block of codes to Q8 uV.
+ * @details Dispatches once on the gain so each loop body has a constant
+ *          shift. code and uv_q8 may be the same buffer.
+ * @param code Sign-extended ECG codes, e.g. from MAX30003_DecodeFIFO().
+ * @param uv_q8 Output, Q8 microvolts.
+ * @param count Number of samples.
+ * @param gain_field CNFG_ECG GAIN field (0-3 = 20/40/80/160 V/V).
+ */
+void MAX30003_CodeToUV_Q8_Block(const int32_t *code, int32_t *uv_q8, uint32_t count, uint8_t gain_field) {
+    switch (gain_field & MAX30003_CNFG_ECG_GAIN_MASK) {
+        case 0:
+            for (uint32_t i = 0; i < count; ++i)
+                uv_q8[i] = MAX30003_CodeToUV_Q8_G20(code[i]);
+            break;
+        case 1:
+            for (uint32_t i = 0; i < count; ++i)
+                uv_q8[i] = MAX30003_CodeToUV_Q8_G40(code[i]);
+            break;
+        case 2:
+            for (uint32_t i = 0; i < count; ++i)
+                uv_q8[i] = MAX30003_CodeToUV_Q8_G80(code[i]);
+            break;
+        default:
+            for (uint32_t i = 0; i < count; ++i)
+                uv_q8[i] = MAX30003_CodeToUV_Q8_G160(code[i]);
+            break;
+    }
+}
+
+/**
+ * @brief CNFG_ECG GAIN field from the register shadow.
+ * @param hmax Device handle.
+ * @param gain_field Output, 0-3 = 20/40/80/160 V/V.
+ * @return HAL status of the shadow lookup.
+ */
+HAL_StatusTypeDef MAX30003_GetGainField(MAX30003_HandleTypeDef *hmax, uint8_t *gain_field) {
+    uint32_t cnfg_ecg;
+    HAL_StatusTypeDef status = MAX30003_GetShadow(hmax, MAX30003_REG_CNFG_ECG, &cnfg_ecg);
+
+    if (status == HAL_OK)
+        *gain_field = (cnfg_ecg >> MAX30003_CNFG_ECG_GAIN_SHIFT) & MAX30003_CNFG_ECG_GAIN_MASK;
+    return status;
+}
@@ -0,0 +1,138 @@
+/**
+ ******************************************************************************
+ * @file    max30003_units.h
+ * @author  Wiktor Chocianowicz
+ * @brief   MAX30003 ECG code to microvolt conversion - Header file
+ *
+ * @note    Q8 microvolts (1/256 uV per LSB) from sign-extended 18-bit codes, using only
+ *          a multiply, an add and a shift; all constants are resolved at compile time.
+ * 
+ * MIT License
+ * 
+ * Copyright (c) 2025 Wiktor Chocianowicz
+ * 
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * 
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * 
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ******************************************************************************
+ */
+
+#ifndef INC_MAX30003_UNITS_H_
+#define INC_MAX30003_UNITS_H_
+
+#include "max30003.h"
+
+/* ---------------------------------------------------------------------------
+ * Conversion Constants
+ * ---------------------------------------------------------------------------
+ * V = code * VREF / (2^17 * GAIN). With GAIN = 20 * 2^g (g = CNFG_ECG GAIN
+ * field) and VREF in mV:
+ *
+ *   uV_q8 = code * VREF_mV * 1000 * 256 / (2^17 * 20 * 2^g)
+ *         = code * (VREF_mV * 25) >> (8 + g)
+ *
+ * which is exact. Powers of two are moved out of the multiplier below so the
+ * product fits in 32 bits for the nominal 1000 mV reference.
+ * ------------------------------------------------------------------------- */
+
+#ifndef MAX30003_VREF_mV
+#define MAX30003_VREF_mV            1000    /**< ADC reference voltage, mV */
+#endif
+
+#define MAX30003_UV_Q8_FRAC         8U      /**< Fraction bits of the output */
+
+#define MAX30003_UV_NUM             ((MAX30003_VREF_mV) * 25)
+#if (MAX30003_UV_NUM % 8) == 0
+#define MAX30003_UV_MULT            (MAX30003_UV_NUM / 8)
+#define MAX30003_UV_BASE_SHIFT      5U
+#elif (MAX30003_UV_NUM % 4) == 0
+#define MAX30003_UV_MULT            (MAX30003_UV_NUM / 4)
+#define MAX30003_UV_BASE_SHIFT      6U
+#elif (MAX30003_UV_NUM % 2) == 0
+#define MAX30003_UV_MULT            (MAX30003_UV_NUM / 2)
+#define MAX30003_UV_BASE_SHIFT      7U
+#else
+#define MAX30003_UV_MULT            MAX30003_UV_NUM
+#define MAX30003_UV_BASE_SHIFT      8U
+#endif
+
+/* |code| <= 2^17: the product needs 64 bits once MULT reaches 2^14 */
+#if MAX30003_UV_MULT >= 16384
+#define MAX30003_UV_PRODUCT(code)   ((int64_t)(code) * MAX30003_UV_MULT)
+#else
+#define MAX30003_UV_PRODUCT(code)   ((int32_t)(code) * MAX30003_UV_MULT)
+#endif
+
+/** Right shift for a CNFG_ECG GAIN field value (0-3 = 20/40/80/160 V/V) */
+#define MAX30003_UV_SHIFT(gain_field)   (MAX30003_UV_BASE_SHIFT + (gain_field))
+
+/** Code to Q8 uV, rounded to nearest; gain_field should be a constant */
+#define MAX30003_CODE_TO_UV_Q8(code, gain_field) \
+    ((int32_t)((MAX30003_UV_PRODUCT(code) + (1 << (MAX30003_UV_SHIFT(gain_field) - 1U))) \
+               >> MAX30003_UV_SHIFT(gain_field)))
+
+/* ---------------------------------------------------------------------------
+ * Per-Gain Converters
+ * ------------------------------------------------------------------------- */
+
+/** @brief Code to Q8 uV at 20 V/V. */
+static inline int32_t MAX30003_CodeToUV_Q8_G20(int32_t code) {
+    return MAX30003_CODE_TO_UV_Q8(code, 0U);
+}
+
+/** @brief Code to Q8 uV at 40 V/V. */
+static inline int32_t MAX30003_CodeToUV_Q8_G40(int32_t code) {
+    return MAX30003_CODE_TO_UV_Q8(code, 1U);
+}
+
+/** @brief Code to Q8 uV at 80 V/V. */
+static inline int32_t MAX30003_CodeToUV_Q8_G80(int32_t code) {
+    return MAX30003_CODE_TO_UV_Q8(code, 2U);
+}
+
+/** @brief Code to Q8 uV at 160 V/V. */
+static inline int32_t MAX30003_CodeToUV_Q8_G160(int32_t code) {
+    return MAX30003_CODE_TO_UV_Q8(code, 3U);
+}
+
+/**
+ * @brief Code to Q8 uV for a gain known only at runtime.
+ * @param code Sign-extended ECG code.
+ * @param gain_field CNFG_ECG GAIN field (0-3).
+ */
+static inline int32_t MAX30003_CodeToUV_Q8(int32_t code, uint8_t gain_field) {
+    uint32_t shift = MAX30003_UV_SHIFT(gain_field & MAX30003_CNFG_ECG_GAIN_MASK);
+    return (int32_t)((MAX30003_UV_PRODUCT(code) + (1 << (shift - 1U))) >> shift);
+}
+
+/* ---------------------------------------------------------------------------
+ * Function Prototypes
+ * ------------------------------------------------------------------------- */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void MAX30003_CodeToUV_Q8_Block(const int32_t *code, int32_t *uv_q8, uint32_t count, uint8_t gain_field);
+
+HAL_StatusTypeDef MAX30003_GetGainField(MAX30003_HandleTypeDef *hmax, uint8_t *gain_field);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INC_MAX30003_UNITS_H_ */